@@ -3,6 +3,7 @@
 #include "ShooterGame.h"
 #include "Bots/BTTask_FindPointNearEnemy.h"
 #include "Bots/ShooterAIController.h"
+#include "Bots/ShooterTacticalPointCache.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyAllTypes.h"
@@ -29,7 +30,14 @@ EBTNodeResult::Type UBTTask_FindPointNearEnemy::ExecuteTask(UBehaviorTreeCompone
 		const float SearchRadius = 200.0f;
 		const FVector SearchOrigin = Enemy->GetActorLocation() + 600.0f * (MyBot->GetActorLocation() - Enemy->GetActorLocation()).GetSafeNormal();
 		FVector Loc(0);
-		UNavigationSystemV1::K2_GetRandomReachablePointInRadius(MyController, SearchOrigin, Loc, SearchRadius);
+
+		// prefer the precomputed tactical points, only query the navmesh if there is nothing cached around
+		AShooterGameMode* GameMode = MyController->GetWorld()->GetAuthGameMode<AShooterGameMode>();
+		TSharedPtr<FShooterTacticalPointCache> TacticalPoints = GameMode ? GameMode->GetTacticalPoints() : nullptr;
+		if (!TacticalPoints.IsValid() || !TacticalPoints->FindPointNearEnemy(SearchOrigin, SearchRadius, Enemy->GetActorLocation(), Loc))
+		{
+			UNavigationSystemV1::K2_GetRandomReachablePointInRadius(MyController, SearchOrigin, Loc, SearchRadius);
+		}
 		if (Loc != FVector::ZeroVector)
 		{
 			OwnerComp.GetBlackboardComponent()->SetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID(), Loc);
@@ -3,6 +3,8 @@
 #include "ShooterGame.h"
 #include "Bots/ShooterAIController.h"
 #include "Bots/ShooterBot.h"
+#include "Bots/ShooterAIScheduler.h"
+#include "Bots/ShooterBehaviorTreeComponent.h"
 #include "Online/ShooterPlayerState.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
@@ -15,9 +17,10 @@ AShooterAIController::AShooterAIController(const FObjectInitializer& ObjectIniti
 {
  	BlackboardComp = ObjectInitializer.CreateDefaultSubobject<UBlackboardComponent>(this, TEXT("BlackBoardComp"));
  	
-	BrainComponent = BehaviorComp = ObjectInitializer.CreateDefaultSubobject<UBehaviorTreeComponent>(this, TEXT("BehaviorComp"));	
+	BrainComponent = BehaviorComp = ObjectInitializer.CreateDefaultSubobject<UShooterBehaviorTreeComponent>(this, TEXT("BehaviorComp"));	
 
 	bWantsPlayerState = true;
+	PendingRotationDeltaTime = 0.0f;
 }
 
 void AShooterAIController::OnPossess(APawn* InPawn)
@@ -39,6 +42,13 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 
 		BehaviorComp->StartTree(*(Bot->BotBehavior));
 	}
+
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode && GameMode->GetBotScheduler().IsValid())
+	{
+		Scheduler = GameMode->GetBotScheduler();
+		Scheduler.Pin()->RegisterBot(this);
+	}
 }
 
 void AShooterAIController::OnUnPossess()
@@ -46,6 +56,12 @@ void AShooterAIController::OnUnPossess()
 	Super::OnUnPossess();
 
 	BehaviorComp->StopTree();
+
+	if (TSharedPtr<FShooterAIScheduler> PinnedScheduler = Scheduler.Pin())
+	{
+		PinnedScheduler->UnregisterBot(this);
+	}
+	Scheduler.Reset();
 }
 
 void AShooterAIController::BeginInactiveState()
@@ -243,6 +259,16 @@ class AShooterCharacter* AShooterAIController::GetEnemy() const
 
 void AShooterAIController::UpdateControlRotation(float DeltaTime, bool bUpdatePawn)
 {
+	// Bots far from human players turn less often, catching up with the time they skipped
+	PendingRotationDeltaTime += DeltaTime;
+	TSharedPtr<FShooterAIScheduler> PinnedScheduler = Scheduler.Pin();
+	if (PinnedScheduler.IsValid() && !PinnedScheduler->ShouldUpdateControlRotation(this, PendingRotationDeltaTime))
+	{
+		return;
+	}
+	DeltaTime = PendingRotationDeltaTime;
+	PendingRotationDeltaTime = 0.0f;
+
 	// Look toward focus
 	FVector FocalPoint = GetFocalPoint();
 	if( !FocalPoint.IsZero() && GetPawn())
@@ -0,0 +1,265 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterAIScheduler.h"
+#include "Bots/ShooterAIController.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterAI"), STATGROUP_ShooterAI, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Update Tiers"), STAT_ShooterAI_UpdateTiers, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Behavior Ticks"), STAT_ShooterAI_BehaviorTicks, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred By Tier"), STAT_ShooterAI_DeferredByTier, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred By Budget"), STAT_ShooterAI_DeferredByBudget, STATGROUP_ShooterAI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Budget Used (ms)"), STAT_ShooterAI_BudgetUsed, STATGROUP_ShooterAI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Budget (ms)"), STAT_ShooterAI_Budget, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots Full"), STAT_ShooterAI_BotsFull, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots Reduced"), STAT_ShooterAI_BotsReduced, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots Minimal"), STAT_ShooterAI_BotsMinimal, STATGROUP_ShooterAI);
+
+int32 CVar_ShooterAI_Scheduler_Enable = 1;
+static FAutoConsoleVariableRef CVarShooterAISchedulerEnable(TEXT("ShooterAI.Scheduler.Enable"), CVar_ShooterAI_Scheduler_Enable, TEXT("If 0, all bots update every frame at full fidelity"), ECVF_Default );
+
+// Time per frame that behavior tree ticks of non Full tier bots may use before being deferred to a later frame.
+float CVar_ShooterAI_Scheduler_BudgetMs = 2.0f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerBudgetMs(TEXT("ShooterAI.Scheduler.BudgetMs"), CVar_ShooterAI_Scheduler_BudgetMs, TEXT("Per frame budget for bot behavior tree ticks, in milliseconds, 0 for no budget"), ECVF_Default );
+
+// A bot deferred for budget reasons will still tick once it has waited this long, so nobody starves.
+float CVar_ShooterAI_Scheduler_MaxDeferral = 1.0f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerMaxDeferral(TEXT("ShooterAI.Scheduler.MaxDeferral"), CVar_ShooterAI_Scheduler_MaxDeferral, TEXT("Max time (seconds) a bot can be deferred because of the budget"), ECVF_Default );
+
+float CVar_ShooterAI_Scheduler_NearDistance = 2000.f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerNearDistance(TEXT("ShooterAI.Scheduler.NearDistance"), CVar_ShooterAI_Scheduler_NearDistance, TEXT("Bots closer than this to a human player are always Full tier"), ECVF_Default );
+
+float CVar_ShooterAI_Scheduler_ViewDistance = 8000.f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerViewDistance(TEXT("ShooterAI.Scheduler.ViewDistance"), CVar_ShooterAI_Scheduler_ViewDistance, TEXT("Bots in view of a human player and closer than this are Full tier"), ECVF_Default );
+
+float CVar_ShooterAI_Scheduler_ReducedDistance = 5000.f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerReducedDistance(TEXT("ShooterAI.Scheduler.ReducedDistance"), CVar_ShooterAI_Scheduler_ReducedDistance, TEXT("Bots out of view but closer than this are Reduced tier"), ECVF_Default );
+
+float CVar_ShooterAI_Scheduler_ViewHalfAngle = 60.f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerViewHalfAngle(TEXT("ShooterAI.Scheduler.ViewHalfAngle"), CVar_ShooterAI_Scheduler_ViewHalfAngle, TEXT("Half angle (degrees) of the view cone used to decide if a bot is visible"), ECVF_Default );
+
+float CVar_ShooterAI_Scheduler_ReducedInterval = 0.1f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerReducedInterval(TEXT("ShooterAI.Scheduler.ReducedInterval"), CVar_ShooterAI_Scheduler_ReducedInterval, TEXT("Min time (seconds) between updates of Reduced tier bots"), ECVF_Default );
+
+float CVar_ShooterAI_Scheduler_MinimalInterval = 0.5f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerMinimalInterval(TEXT("ShooterAI.Scheduler.MinimalInterval"), CVar_ShooterAI_Scheduler_MinimalInterval, TEXT("Min time (seconds) between updates of Minimal tier bots"), ECVF_Default );
+
+float CVar_ShooterAI_Scheduler_TierUpdateInterval = 0.25f;
+static FAutoConsoleVariableRef CVarShooterAISchedulerTierUpdateInterval(TEXT("ShooterAI.Scheduler.TierUpdateInterval"), CVar_ShooterAI_Scheduler_TierUpdateInterval, TEXT("How often (seconds) bot tiers are recomputed"), ECVF_Default );
+
+FShooterAIScheduler::FShooterAIScheduler(UWorld* InWorld)
+	: World(InWorld)
+	, BudgetUsedSeconds(0.0)
+	, TimeUntilTierUpdate(0.0f)
+{
+}
+
+void FShooterAIScheduler::RegisterBot(AShooterAIController* Bot)
+{
+	if (Bot && FindBot(Bot) == nullptr)
+	{
+		// a destroyed bot may have left its entry behind at the same address
+		RemoveBots([](const FScheduledBot& Scheduled) { return !Scheduled.Controller.IsValid(); });
+
+		BotIndices.Add(Bot, Bots.Num());
+
+		FScheduledBot& NewBot = Bots.AddDefaulted_GetRef();
+		NewBot.Controller = Bot;
+
+		// pick up a proper tier on the next tick
+		TimeUntilTierUpdate = 0.0f;
+	}
+}
+
+void FShooterAIScheduler::UnregisterBot(AShooterAIController* Bot)
+{
+	if (BotIndices.Contains(Bot))
+	{
+		RemoveBots([Bot](const FScheduledBot& Scheduled) { return Scheduled.Controller == Bot; });
+	}
+}
+
+template<typename PredicateType>
+void FShooterAIScheduler::RemoveBots(const PredicateType& Predicate)
+{
+	if (Bots.RemoveAllSwap(Predicate) > 0)
+	{
+		// removing swaps bots around, rare enough to simply index them again
+		BotIndices.Reset();
+		for (int32 Index = 0; Index < Bots.Num(); Index++)
+		{
+			BotIndices.Add(Bots[Index].Controller.Get(), Index);
+		}
+	}
+}
+
+const FShooterAIScheduler::FScheduledBot* FShooterAIScheduler::FindBot(const AShooterAIController* Bot) const
+{
+	const int32* Index = BotIndices.Find(Bot);
+	return Index && Bots[*Index].Controller.Get() == Bot ? &Bots[*Index] : nullptr;
+}
+
+EShooterAIUpdateTier::Type FShooterAIScheduler::GetUpdateTier(const AShooterAIController* Bot) const
+{
+	const FScheduledBot* Scheduled = FindBot(Bot);
+	return Scheduled ? Scheduled->Tier : EShooterAIUpdateTier::Full;
+}
+
+float FShooterAIScheduler::GetTierInterval(EShooterAIUpdateTier::Type Tier)
+{
+	switch (Tier)
+	{
+		case EShooterAIUpdateTier::Reduced:	return CVar_ShooterAI_Scheduler_ReducedInterval;
+		case EShooterAIUpdateTier::Minimal:	return CVar_ShooterAI_Scheduler_MinimalInterval;
+		default:							return 0.0f;
+	}
+}
+
+bool FShooterAIScheduler::RequestBehaviorTick(const AShooterAIController* Bot, float TimeSinceLastTick)
+{
+	const FScheduledBot* Scheduled = CVar_ShooterAI_Scheduler_Enable ? FindBot(Bot) : nullptr;
+	if (Scheduled)
+	{
+		if (TimeSinceLastTick < GetTierInterval(Scheduled->Tier))
+		{
+			INC_DWORD_STAT(STAT_ShooterAI_DeferredByTier);
+			return false;
+		}
+
+		// bots that players can see are never deferred, everybody else waits for the next frame once the budget is spent
+		const double BudgetSeconds = CVar_ShooterAI_Scheduler_BudgetMs / 1000.0;
+		if (Scheduled->Tier != EShooterAIUpdateTier::Full && BudgetSeconds > 0.0 && BudgetUsedSeconds >= BudgetSeconds && TimeSinceLastTick < CVar_ShooterAI_Scheduler_MaxDeferral)
+		{
+			INC_DWORD_STAT(STAT_ShooterAI_DeferredByBudget);
+			return false;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ShooterAI_BehaviorTicks);
+	return true;
+}
+
+void FShooterAIScheduler::NotifyBehaviorTickCost(double Seconds)
+{
+	BudgetUsedSeconds += Seconds;
+	INC_FLOAT_STAT_BY(STAT_ShooterAI_BudgetUsed, (float)(Seconds * 1000.0));
+}
+
+bool FShooterAIScheduler::ShouldUpdateControlRotation(const AShooterAIController* Bot, float TimeSinceLastUpdate) const
+{
+	if (CVar_ShooterAI_Scheduler_Enable == 0)
+	{
+		return true;
+	}
+
+	return TimeSinceLastUpdate >= GetTierInterval(GetUpdateTier(Bot));
+}
+
+void FShooterAIScheduler::Tick(float DeltaTime)
+{
+	// tickable objects run after all actors, so this starts the budget for the next frame
+	BudgetUsedSeconds = 0.0;
+	SET_FLOAT_STAT(STAT_ShooterAI_Budget, CVar_ShooterAI_Scheduler_BudgetMs);
+
+	TimeUntilTierUpdate -= DeltaTime;
+	if (TimeUntilTierUpdate <= 0.0f)
+	{
+		TimeUntilTierUpdate = CVar_ShooterAI_Scheduler_TierUpdateInterval;
+		UpdateTiers();
+	}
+}
+
+void FShooterAIScheduler::UpdateTiers()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterAI_UpdateTiers);
+
+	RemoveBots([](const FScheduledBot& Scheduled) { return !Scheduled.Controller.IsValid(); });
+
+	UWorld* MyWorld = World.Get();
+	if (MyWorld == nullptr)
+	{
+		return;
+	}
+
+	// gather view points of human players once, bots are compared against all of them
+	TArray<FVector> ViewLocations;
+	TArray<FVector> ViewDirections;
+	for (FConstPlayerControllerIterator It = MyWorld->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC && PC->PlayerState && !PC->PlayerState->IsABot())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			ViewLocations.Add(ViewLocation);
+			ViewDirections.Add(ViewRotation.Vector());
+		}
+	}
+
+	int32 NumPerTier[EShooterAIUpdateTier::MAX] = { 0 };
+	for (FScheduledBot& Scheduled : Bots)
+	{
+		Scheduled.Tier = ComputeTier(Scheduled.Controller.Get(), ViewLocations, ViewDirections);
+		NumPerTier[Scheduled.Tier]++;
+	}
+
+	SET_DWORD_STAT(STAT_ShooterAI_BotsFull, NumPerTier[EShooterAIUpdateTier::Full]);
+	SET_DWORD_STAT(STAT_ShooterAI_BotsReduced, NumPerTier[EShooterAIUpdateTier::Reduced]);
+	SET_DWORD_STAT(STAT_ShooterAI_BotsMinimal, NumPerTier[EShooterAIUpdateTier::Minimal]);
+}
+
+EShooterAIUpdateTier::Type FShooterAIScheduler::ComputeTier(const AShooterAIController* Bot, const TArray<FVector>& ViewLocations, const TArray<FVector>& ViewDirections) const
+{
+	const APawn* BotPawn = Bot->GetPawn();
+	if (BotPawn == nullptr)
+	{
+		return EShooterAIUpdateTier::Minimal;
+	}
+
+	// bots fighting a human always get full attention, so their aim stays accurate
+	const AShooterCharacter* Enemy = Bot->GetEnemy();
+	if (Enemy && Enemy->IsPlayerControlled())
+	{
+		return EShooterAIUpdateTier::Full;
+	}
+
+	const float CosViewHalfAngle = FMath::Cos(FMath::DegreesToRadians(CVar_ShooterAI_Scheduler_ViewHalfAngle));
+	const FVector BotLocation = BotPawn->GetActorLocation();
+
+	EShooterAIUpdateTier::Type BestTier = EShooterAIUpdateTier::Minimal;
+	for (int32 i = 0; i < ViewLocations.Num(); ++i)
+	{
+		const FVector ToBot = BotLocation - ViewLocations[i];
+		const float DistSq = ToBot.SizeSquared();
+		if (DistSq < FMath::Square(CVar_ShooterAI_Scheduler_NearDistance))
+		{
+			return EShooterAIUpdateTier::Full;
+		}
+
+		const bool bInView = (ToBot | ViewDirections[i]) > CosViewHalfAngle * FMath::Sqrt(DistSq);
+		if (bInView && DistSq < FMath::Square(CVar_ShooterAI_Scheduler_ViewDistance))
+		{
+			return EShooterAIUpdateTier::Full;
+		}
+
+		if (bInView || DistSq < FMath::Square(CVar_ShooterAI_Scheduler_ReducedDistance))
+		{
+			BestTier = EShooterAIUpdateTier::Reduced;
+		}
+	}
+
+	return BestTier;
+}
+
+TStatId FShooterAIScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FShooterAIScheduler, STATGROUP_Tickables);
+}
+
+UWorld* FShooterAIScheduler::GetTickableGameObjectWorld() const
+{
+	return World.Get();
+}
@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterBehaviorTreeComponent.h"
+#include "Bots/ShooterAIController.h"
+#include "Bots/ShooterAIScheduler.h"
+#include "Online/ShooterServerTelemetry.h"
+
+UShooterBehaviorTreeComponent::UShooterBehaviorTreeComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PendingDeltaTime = 0.0f;
+}
+
+void UShooterBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	PendingDeltaTime += DeltaTime;
+
+	AShooterAIController* MyController = Cast<AShooterAIController>(GetOwner());
+	TSharedPtr<FShooterAIScheduler> Scheduler = MyController ? MyController->GetScheduler() : nullptr;
+	if (Scheduler.IsValid() && !Scheduler->RequestBehaviorTick(MyController, PendingDeltaTime))
+	{
+		return;
+	}
+
+	// run with the whole time that passed since the last granted tick, so timers in tasks and services stay correct
+	const float TickDeltaTime = PendingDeltaTime;
+	PendingDeltaTime = 0.0f;
+
+	const double StartTime = FPlatformTime::Seconds();
+	Super::TickComponent(TickDeltaTime, TickType, ThisTickFunction);
+
+	const double TickSeconds = FPlatformTime::Seconds() - StartTime;
+	FShooterServerTelemetry::AddTime(EShooterServerTiming::AI, TickSeconds);
+
+	if (Scheduler.IsValid())
+	{
+		Scheduler->NotifyBehaviorTickCost(TickSeconds);
+	}
+}
@@ -0,0 +1,323 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterTacticalPointCache.h"
+#include "NavigationSystem.h"
+#include "GameFramework/PlayerStart.h"
+#include "EngineUtils.h"
+
+int32 CVar_ShooterAI_TacticalPoints_MaxPoints = 1024;
+static FAutoConsoleVariableRef CVarShooterAITacticalPointsMaxPoints(TEXT("ShooterAI.TacticalPoints.MaxPoints"), CVar_ShooterAI_TacticalPoints_MaxPoints, TEXT("Max number of tactical points sampled per map"), ECVF_Default );
+
+float CVar_ShooterAI_TacticalPoints_MinSpacing = 250.f;
+static FAutoConsoleVariableRef CVarShooterAITacticalPointsMinSpacing(TEXT("ShooterAI.TacticalPoints.MinSpacing"), CVar_ShooterAI_TacticalPoints_MinSpacing, TEXT("Min distance between two tactical points"), ECVF_Default );
+
+float CVar_ShooterAI_TacticalPoints_CoverDistance = 200.f;
+static FAutoConsoleVariableRef CVarShooterAITacticalPointsCoverDistance(TEXT("ShooterAI.TacticalPoints.CoverDistance"), CVar_ShooterAI_TacticalPoints_CoverDistance, TEXT("Geometry closer than this at waist height counts as cover"), ECVF_Default );
+
+float CVar_ShooterAI_TacticalPoints_SightDistance = 2000.f;
+static FAutoConsoleVariableRef CVarShooterAITacticalPointsSightDistance(TEXT("ShooterAI.TacticalPoints.SightDistance"), CVar_ShooterAI_TacticalPoints_SightDistance, TEXT("Directions open for at least this far at eye height count as clear view"), ECVF_Default );
+
+// The original navmesh query used a 200 unit radius. Points are spaced further apart than that, so never search a smaller area than this.
+float CVar_ShooterAI_TacticalPoints_MinQueryRadius = 500.f;
+static FAutoConsoleVariableRef CVarShooterAITacticalPointsMinQueryRadius(TEXT("ShooterAI.TacticalPoints.MinQueryRadius"), CVar_ShooterAI_TacticalPoints_MinQueryRadius, TEXT("Min radius used when querying tactical points"), ECVF_Default );
+
+// Building runs over the first frames of the match instead of holding up the server getting ready.
+float CVar_ShooterAI_TacticalPoints_BuildBudgetMs = 2.0f;
+static FAutoConsoleVariableRef CVarShooterAITacticalPointsBuildBudgetMs(TEXT("ShooterAI.TacticalPoints.BuildBudgetMs"), CVar_ShooterAI_TacticalPoints_BuildBudgetMs, TEXT("Time per frame spent building tactical points, in milliseconds, 0 to build them in one frame"), ECVF_Default );
+
+// A path test can take a good part of the build budget on its own, and the clock is only checked between samples.
+int32 CVar_ShooterAI_TacticalPoints_MaxPathTestsPerFrame = 8;
+static FAutoConsoleVariableRef CVarShooterAITacticalPointsMaxPathTestsPerFrame(TEXT("ShooterAI.TacticalPoints.MaxPathTestsPerFrame"), CVar_ShooterAI_TacticalPoints_MaxPathTestsPerFrame, TEXT("Max reachability path tests per frame while building over several frames, 0 for no limit"), ECVF_Default );
+
+namespace
+{
+	const float CoverTraceHeight = 60.f;
+	const float SightTraceHeight = 160.f;
+}
+
+FShooterTacticalPointCache::FShooterTacticalPointCache()
+	: CellSize(1000.f)
+	, bBuilding(false)
+	, NumSampleAttempts(0)
+	, NumAnnotated(0)
+	, NumUnreachable(0)
+	, NumBuildFrames(0)
+	, BuildStartTime(0.0)
+	, NumPathTestsThisFrame(0)
+{
+}
+
+FIntPoint FShooterTacticalPointCache::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+int32 FShooterTacticalPointCache::GetDirectionIndex(const FVector& Direction)
+{
+	const float Angle = FMath::Atan2(Direction.Y, Direction.X);
+	const float Sector = 2.0f * PI / NumDirections;
+	return (FMath::RoundToInt(Angle / Sector) + NumDirections) % NumDirections;
+}
+
+bool FShooterTacticalPointCache::HasPointWithin(const FVector& Location, float MinDistance) const
+{
+	const FIntPoint Cell = GetCell(Location);
+	for (int32 X = -1; X <= 1; ++X)
+	{
+		for (int32 Y = -1; Y <= 1; ++Y)
+		{
+			if (const TArray<int32>* CellPoints = SpatialHash.Find(Cell + FIntPoint(X, Y)))
+			{
+				for (int32 PointIndex : *CellPoints)
+				{
+					if (FVector::DistSquared(Points[PointIndex].Location, Location) < FMath::Square(MinDistance))
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+void FShooterTacticalPointCache::StartBuild(UWorld* InWorld)
+{
+	World = InWorld;
+	Points.Reset();
+	SpatialHash.Reset();
+	StartLocations.Reset();
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(InWorld);
+	if (NavSys == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Tactical points: no navigation system, bots will fall back to navmesh queries."));
+		bBuilding = false;
+		return;
+	}
+
+	// cells must be at least as big as the min spacing, so HasPointWithin only needs to look at neighbouring cells
+	CellSize = FMath::Max(1000.f, CVar_ShooterAI_TacticalPoints_MinSpacing * 2.0f);
+
+	for (TActorIterator<APlayerStart> It(InWorld); It; ++It)
+	{
+		FNavLocation StartLocation;
+		if (NavSys->ProjectPointToNavigation(It->GetActorLocation(), StartLocation))
+		{
+			StartLocations.Add(StartLocation.Location);
+		}
+	}
+
+	bBuilding = true;
+	NumSampleAttempts = 0;
+	NumAnnotated = 0;
+	NumUnreachable = 0;
+	NumBuildFrames = 0;
+	BuildStartTime = FPlatformTime::Seconds();
+}
+
+void FShooterTacticalPointCache::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(FShooterTacticalPointCache_Build);
+
+	UWorld* MyWorld = World.Get();
+	UNavigationSystemV1* NavSys = MyWorld ? FNavigationSystem::GetCurrent<UNavigationSystemV1>(MyWorld) : nullptr;
+	if (NavSys == nullptr)
+	{
+		bBuilding = false;
+		return;
+	}
+
+	NumBuildFrames++;
+	NumPathTestsThisFrame = 0;
+	const bool bBudgeted = CVar_ShooterAI_TacticalPoints_BuildBudgetMs > 0.0f;
+	const double EndTime = FPlatformTime::Seconds() + CVar_ShooterAI_TacticalPoints_BuildBudgetMs / 1000.0;
+	const int32 MaxPathTests = bBudgeted ? CVar_ShooterAI_TacticalPoints_MaxPathTestsPerFrame : 0;
+
+	// random navmesh points naturally cover every floor of the map, rejecting the ones too close to what we already have
+	const int32 MaxAttempts = CVar_ShooterAI_TacticalPoints_MaxPoints * 4;
+	while (NumSampleAttempts < MaxAttempts && Points.Num() < CVar_ShooterAI_TacticalPoints_MaxPoints)
+	{
+		// a sample may test a path from every start, leave it to the next frame once the tests of this one are used up
+		if (MaxPathTests > 0 && NumPathTestsThisFrame >= MaxPathTests)
+		{
+			return;
+		}
+
+		if (!SamplePoint(NavSys))
+		{
+			NumSampleAttempts = MaxAttempts;
+		}
+
+		if (bBudgeted && FPlatformTime::Seconds() >= EndTime)
+		{
+			return;
+		}
+	}
+
+	// points only turn up in queries once the build finished, annotating can't race them
+	while (NumAnnotated < Points.Num())
+	{
+		AnnotatePoint(MyWorld, Points[NumAnnotated++]);
+
+		if (bBudgeted && FPlatformTime::Seconds() >= EndTime)
+		{
+			return;
+		}
+	}
+
+	FinishBuild();
+}
+
+bool FShooterTacticalPointCache::SamplePoint(UNavigationSystemV1* NavSys)
+{
+	NumSampleAttempts++;
+
+	FNavLocation NavLocation;
+	if (!NavSys->GetRandomPoint(NavLocation))
+	{
+		return false;
+	}
+
+	if (HasPointWithin(NavLocation.Location, CVar_ShooterAI_TacticalPoints_MinSpacing))
+	{
+		return true;
+	}
+
+	// random points can land on navmesh islands nobody can walk to, the radius query this replaces never returned those
+	if (!IsReachable(NavSys, NavLocation.Location))
+	{
+		NumUnreachable++;
+		return true;
+	}
+
+	const int32 PointIndex = Points.AddDefaulted();
+	Points[PointIndex].Location = NavLocation.Location;
+	SpatialHash.FindOrAdd(GetCell(NavLocation.Location)).Add(PointIndex);
+	return true;
+}
+
+bool FShooterTacticalPointCache::IsReachable(UNavigationSystemV1* NavSys, const FVector& Location)
+{
+	const ANavigationData* NavData = NavSys->GetDefaultNavDataInstance();
+	if (NavData == nullptr || StartLocations.Num() == 0)
+	{
+		return true;
+	}
+
+	// the starts of a map are connected to each other, the first one usually answers
+	for (const FVector& StartLocation : StartLocations)
+	{
+		FPathFindingQuery Query(nullptr, *NavData, StartLocation, Location);
+		NumPathTestsThisFrame++;
+		if (NavSys->TestPathSync(Query))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FShooterTacticalPointCache::FinishBuild()
+{
+	bBuilding = false;
+
+	UE_LOG(LogShooter, Log, TEXT("Tactical points: cached %d points in %d cells, %d unreachable skipped (%.2f s over %d frames)"),
+		Points.Num(), SpatialHash.Num(), NumUnreachable, FPlatformTime::Seconds() - BuildStartTime, NumBuildFrames);
+}
+
+void FShooterTacticalPointCache::AnnotatePoint(UWorld* World, FShooterTacticalPoint& Point) const
+{
+	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(TacticalPointTrace), false);
+
+	for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+	{
+		const float Angle = Direction * 2.0f * PI / NumDirections;
+		const FVector TraceDir(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f);
+
+		const FVector CoverStart = Point.Location + FVector(0.f, 0.f, CoverTraceHeight);
+		if (World->LineTraceTestByChannel(CoverStart, CoverStart + TraceDir * CVar_ShooterAI_TacticalPoints_CoverDistance, COLLISION_WEAPON, TraceParams))
+		{
+			Point.CoverMask |= (1 << Direction);
+		}
+
+		const FVector SightStart = Point.Location + FVector(0.f, 0.f, SightTraceHeight);
+		if (!World->LineTraceTestByChannel(SightStart, SightStart + TraceDir * CVar_ShooterAI_TacticalPoints_SightDistance, COLLISION_WEAPON, TraceParams))
+		{
+			Point.SightMask |= (1 << Direction);
+		}
+	}
+}
+
+bool FShooterTacticalPointCache::FindPointNearEnemy(const FVector& SearchOrigin, float SearchRadius, const FVector& EnemyLocation, FVector& OutLocation) const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(FShooterTacticalPointCache_FindPointNearEnemy);
+
+	if (!IsBuilt())
+	{
+		return false;
+	}
+
+	const float Radius = FMath::Max(SearchRadius, CVar_ShooterAI_TacticalPoints_MinQueryRadius);
+	const float RadiusSq = FMath::Square(Radius);
+	const FIntPoint MinCell = GetCell(SearchOrigin - FVector(Radius, Radius, 0.f));
+	const FIntPoint MaxCell = GetCell(SearchOrigin + FVector(Radius, Radius, 0.f));
+
+	// random pick among the best scoring points keeps bots from all running to the same spot
+	TArray<int32, TInlineAllocator<32>> BestPoints;
+	int32 BestScore = -1;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const TArray<int32>* CellPoints = SpatialHash.Find(FIntPoint(X, Y));
+			if (CellPoints == nullptr)
+			{
+				continue;
+			}
+
+			for (int32 PointIndex : *CellPoints)
+			{
+				const FShooterTacticalPoint& Point = Points[PointIndex];
+				if (FVector::DistSquared(Point.Location, SearchOrigin) > RadiusSq)
+				{
+					continue;
+				}
+
+				const uint8 EnemyDirectionBit = 1 << GetDirectionIndex(EnemyLocation - Point.Location);
+				const int32 Score = ((Point.CoverMask & EnemyDirectionBit) ? 2 : 0) + ((Point.SightMask & EnemyDirectionBit) ? 1 : 0);
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					BestPoints.Reset();
+				}
+				if (Score == BestScore)
+				{
+					BestPoints.Add(PointIndex);
+				}
+			}
+		}
+	}
+
+	if (BestPoints.Num() > 0)
+	{
+		OutLocation = Points[BestPoints[FMath::RandHelper(BestPoints.Num())]].Location;
+		return true;
+	}
+
+	return false;
+}
+
+TStatId FShooterTacticalPointCache::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FShooterTacticalPointCache, STATGROUP_Tickables);
+}
+
+UWorld* FShooterTacticalPointCache::GetTickableGameObjectWorld() const
+{
+	return World.Get();
+}
@@ -0,0 +1,263 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Effects/ShooterImpactEffectManager.h"
+#include "Effects/ShooterImpactEffect.h"
+#include "Components/DecalComponent.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterImpacts"), STATGROUP_ShooterImpacts, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Impact"), STAT_ShooterImpacts_SpawnImpact, STATGROUP_ShooterImpacts);
+DECLARE_CYCLE_STAT(TEXT("Expire Decals"), STAT_ShooterImpacts_ExpireDecals, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impacts"), STAT_ShooterImpacts_Impacts, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Emitters Played"), STAT_ShooterImpacts_EmittersPlayed, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Emitters Evicted"), STAT_ShooterImpacts_EmittersEvicted, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Emitters Culled"), STAT_ShooterImpacts_EmittersCulled, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Decals Placed"), STAT_ShooterImpacts_DecalsPlaced, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Decals Evicted"), STAT_ShooterImpacts_DecalsEvicted, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Decals Culled"), STAT_ShooterImpacts_DecalsCulled, STATGROUP_ShooterImpacts);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Components"), STAT_ShooterImpacts_PooledComponents, STATGROUP_ShooterImpacts);
+
+int32 CVar_ShooterImpact_Pooling = 1;
+static FAutoConsoleVariableRef CVarShooterImpactPooling(TEXT("ShooterImpact.Pooling"), CVar_ShooterImpact_Pooling, TEXT("If 0, every impact spawns its own effect actor"), ECVF_Default );
+
+int32 CVar_ShooterImpact_MaxEmittersPerSurface = 16;
+static FAutoConsoleVariableRef CVarShooterImpactMaxEmittersPerSurface(TEXT("ShooterImpact.MaxEmittersPerSurface"), CVar_ShooterImpact_MaxEmittersPerSurface, TEXT("Max impact particle systems per surface type, oldest is reused past that"), ECVF_Default );
+
+int32 CVar_ShooterImpact_MaxDecalsPerSurface = 32;
+static FAutoConsoleVariableRef CVarShooterImpactMaxDecalsPerSurface(TEXT("ShooterImpact.MaxDecalsPerSurface"), CVar_ShooterImpact_MaxDecalsPerSurface, TEXT("Max impact decals per surface type, oldest is reused past that"), ECVF_Default );
+
+float CVar_ShooterImpact_EmitterCullDistance = 6000.f;
+static FAutoConsoleVariableRef CVarShooterImpactEmitterCullDistance(TEXT("ShooterImpact.EmitterCullDistance"), CVar_ShooterImpact_EmitterCullDistance, TEXT("Impact particles further than this from every local player are skipped"), ECVF_Default );
+
+float CVar_ShooterImpact_DecalCullDistance = 10000.f;
+static FAutoConsoleVariableRef CVarShooterImpactDecalCullDistance(TEXT("ShooterImpact.DecalCullDistance"), CVar_ShooterImpact_DecalCullDistance, TEXT("Impact decals further than this from every local player are skipped"), ECVF_Default );
+
+// Added to half the camera FOV, so effects right at the screen edge and the corners still play.
+float CVar_ShooterImpact_ViewAngleMargin = 15.f;
+static FAutoConsoleVariableRef CVarShooterImpactViewAngleMargin(TEXT("ShooterImpact.ViewAngleMargin"), CVar_ShooterImpact_ViewAngleMargin, TEXT("Extra angle (degrees) around the view used when culling impact particles"), ECVF_Default );
+
+AShooterImpactEffectManager::AShooterImpactEffectManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	RootComponent = ObjectInitializer.CreateDefaultSubobject<USceneComponent>(this, TEXT("Root"));
+
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickInterval = 0.25f;
+	SetReplicates(false);
+}
+
+bool AShooterImpactEffectManager::IsPoolingEnabled()
+{
+	return CVar_ShooterImpact_Pooling != 0;
+}
+
+void AShooterImpactEffectManager::SpawnImpact(TSubclassOf<AShooterImpactEffect> ImpactTemplate, const FHitResult& SurfaceHit, const FTransform& SpawnTransform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterImpacts_SpawnImpact);
+	INC_DWORD_STAT(STAT_ShooterImpacts_Impacts);
+
+	const AShooterImpactEffect* ImpactCDO = ImpactTemplate ? ImpactTemplate->GetDefaultObject<AShooterImpactEffect>() : nullptr;
+	if (ImpactCDO == nullptr)
+	{
+		return;
+	}
+
+	const EPhysicalSurface HitSurfaceType = UPhysicalMaterial::DetermineSurfaceType(SurfaceHit.PhysMaterial.Get());
+	if (!SurfacePools.IsValidIndex(HitSurfaceType))
+	{
+		SurfacePools.SetNum(SurfaceType_Max);
+	}
+	FShooterImpactSurfacePool& Pool = SurfacePools[HitSurfaceType];
+
+	// sound is left to attenuation and concurrency settings
+	USoundCue* ImpactSound = ImpactCDO->GetImpactSound(HitSurfaceType);
+	if (ImpactSound)
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, SpawnTransform.GetLocation());
+	}
+
+	// particles are short lived, nobody will notice the ones we skip behind the camera
+	UParticleSystem* ImpactFX = ImpactCDO->GetImpactFX(HitSurfaceType);
+	if (ImpactFX)
+	{
+		if (IsRelevantToLocalPlayers(SpawnTransform.GetLocation(), CVar_ShooterImpact_EmitterCullDistance, true))
+		{
+			UParticleSystemComponent* Emitter = AcquireEmitter(Pool);
+			if (Emitter)
+			{
+				if (Emitter->IsActive())
+				{
+					INC_DWORD_STAT(STAT_ShooterImpacts_EmittersEvicted);
+				}
+
+				Emitter->SetWorldLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation());
+				if (Emitter->Template != ImpactFX)
+				{
+					Emitter->SetTemplate(ImpactFX);
+				}
+				Emitter->ActivateSystem(true);
+				INC_DWORD_STAT(STAT_ShooterImpacts_EmittersPlayed);
+			}
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_ShooterImpacts_EmittersCulled);
+		}
+	}
+
+	// decals stay around, so they are only culled by distance: the player may turn around to look at them
+	const FDecalData& DecalData = ImpactCDO->DefaultDecal;
+	if (DecalData.DecalMaterial)
+	{
+		if (IsRelevantToLocalPlayers(SurfaceHit.ImpactPoint, CVar_ShooterImpact_DecalCullDistance, false))
+		{
+			const int32 DecalIndex = AcquireDecal(Pool);
+			if (DecalIndex != INDEX_NONE)
+			{
+				UDecalComponent* Decal = Pool.Decals[DecalIndex];
+				if (Decal->IsVisible())
+				{
+					INC_DWORD_STAT(STAT_ShooterImpacts_DecalsEvicted);
+					ReleaseDecal(Pool, DecalIndex);
+				}
+
+				FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
+				RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
+
+				// follow moving objects like SpawnDecalAttached did, anything that doesn't move has no need for it
+				USceneComponent* AttachTo = SurfaceHit.Component.Get();
+				const AActor* AttachToOwner = AttachTo ? AttachTo->GetOwner() : nullptr;
+				if (AttachTo && AttachTo->Mobility == EComponentMobility::Movable && !AttachTo->IsPendingKill() && (AttachToOwner == nullptr || !AttachToOwner->IsPendingKillPending()))
+				{
+					Decal->AttachToComponent(AttachTo, FAttachmentTransformRules::KeepWorldTransform, SurfaceHit.BoneName);
+				}
+
+				Decal->SetDecalMaterial(DecalData.DecalMaterial);
+				Decal->DecalSize = FVector(1.0f, DecalData.DecalSize, DecalData.DecalSize);
+				Decal->SetWorldLocationAndRotation(SurfaceHit.ImpactPoint, RandomDecalRotation);
+				Decal->SetVisibility(true);
+				Decal->MarkRenderStateDirty();
+
+				Pool.DecalExpireTimes[DecalIndex] = DecalData.LifeSpan > 0.0f ? GetWorld()->GetTimeSeconds() + DecalData.LifeSpan : 0.0f;
+				INC_DWORD_STAT(STAT_ShooterImpacts_DecalsPlaced);
+			}
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_ShooterImpacts_DecalsCulled);
+		}
+	}
+}
+
+void AShooterImpactEffectManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_ShooterImpacts_ExpireDecals);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (FShooterImpactSurfacePool& Pool : SurfacePools)
+	{
+		for (int32 DecalIndex = 0; DecalIndex < Pool.Decals.Num(); ++DecalIndex)
+		{
+			const float ExpireTime = Pool.DecalExpireTimes[DecalIndex];
+			if (ExpireTime > 0.0f && ExpireTime <= Now)
+			{
+				ReleaseDecal(Pool, DecalIndex);
+				continue;
+			}
+
+			// the actor the decal sticks to is going away, don't leave the decal floating where it was
+			const USceneComponent* AttachParent = Pool.Decals[DecalIndex]->GetAttachParent();
+			if (AttachParent && (AttachParent->IsPendingKill() || (AttachParent->GetOwner() && AttachParent->GetOwner()->IsPendingKillPending())))
+			{
+				ReleaseDecal(Pool, DecalIndex);
+			}
+		}
+	}
+}
+
+bool AShooterImpactEffectManager::IsRelevantToLocalPlayers(const FVector& Location, float CullDistance, bool bRequireInView) const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC == nullptr || !PC->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		const FVector ToLocation = Location - ViewLocation;
+		const float DistSq = ToLocation.SizeSquared();
+		if (DistSq > FMath::Square(CullDistance))
+		{
+			continue;
+		}
+
+		if (!bRequireInView || DistSq < KINDA_SMALL_NUMBER)
+		{
+			return true;
+		}
+
+		const float FOVAngle = PC->PlayerCameraManager ? PC->PlayerCameraManager->GetFOVAngle() : 90.0f;
+		const float HalfAngle = FMath::Min(FOVAngle * 0.5f + CVar_ShooterImpact_ViewAngleMargin, 180.0f);
+		if (FVector::DotProduct(ViewRotation.Vector(), ToLocation.GetUnsafeNormal()) >= FMath::Cos(FMath::DegreesToRadians(HalfAngle)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+UParticleSystemComponent* AShooterImpactEffectManager::AcquireEmitter(FShooterImpactSurfacePool& Pool)
+{
+	const int32 MaxEmitters = FMath::Max(CVar_ShooterImpact_MaxEmittersPerSurface, 1);
+	if (Pool.Emitters.Num() < MaxEmitters)
+	{
+		UParticleSystemComponent* Emitter = NewObject<UParticleSystemComponent>(this);
+		Emitter->bAutoActivate = false;
+		Emitter->bAutoDestroy = false;
+		Emitter->SetUsingAbsoluteLocation(true);
+		Emitter->SetUsingAbsoluteRotation(true);
+		Emitter->RegisterComponent();
+
+		INC_DWORD_STAT(STAT_ShooterImpacts_PooledComponents);
+		return Pool.Emitters.Add_GetRef(Emitter);
+	}
+
+	// emitters are handed out in order, so the next one is the oldest
+	Pool.NextEmitter = Pool.NextEmitter % Pool.Emitters.Num();
+	return Pool.Emitters[Pool.NextEmitter++];
+}
+
+void AShooterImpactEffectManager::ReleaseDecal(FShooterImpactSurfacePool& Pool, int32 DecalIndex)
+{
+	// detach as well, so we don't keep following a component that may go away
+	UDecalComponent* Decal = Pool.Decals[DecalIndex];
+	Decal->SetVisibility(false);
+	Decal->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	Pool.DecalExpireTimes[DecalIndex] = 0.0f;
+}
+
+int32 AShooterImpactEffectManager::AcquireDecal(FShooterImpactSurfacePool& Pool)
+{
+	const int32 MaxDecals = FMath::Max(CVar_ShooterImpact_MaxDecalsPerSurface, 1);
+	if (Pool.Decals.Num() < MaxDecals)
+	{
+		UDecalComponent* Decal = NewObject<UDecalComponent>(this);
+		Decal->SetVisibility(false);
+		Decal->RegisterComponent();
+
+		INC_DWORD_STAT(STAT_ShooterImpacts_PooledComponents);
+		Pool.DecalExpireTimes.Add(0.0f);
+		return Pool.Decals.Add(Decal);
+	}
+
+	Pool.NextDecal = Pool.NextDecal % Pool.Decals.Num();
+	return Pool.NextDecal++;
+}
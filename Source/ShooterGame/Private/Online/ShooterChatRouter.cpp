@@ -0,0 +1,206 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterChatRouter.h"
+#include "Online/ShooterPlayerState.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterChat"), STATGROUP_ShooterChat, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Flush"), STAT_ShooterChat_Flush, STATGROUP_ShooterChat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages"), STAT_ShooterChat_Messages, STATGROUP_ShooterChat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Rejected"), STAT_ShooterChat_Rejected, STATGROUP_ShooterChat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batches Sent"), STAT_ShooterChat_Batches, STATGROUP_ShooterChat);
+
+float CVar_ShooterChat_MessagesPerSecond = 1.0f;
+static FAutoConsoleVariableRef CVarShooterChatMessagesPerSecond(TEXT("ShooterChat.MessagesPerSecond"), CVar_ShooterChat_MessagesPerSecond, TEXT("Chat messages a player may send per second in the long run"), ECVF_Default );
+
+int32 CVar_ShooterChat_Burst = 5;
+static FAutoConsoleVariableRef CVarShooterChatBurst(TEXT("ShooterChat.Burst"), CVar_ShooterChat_Burst, TEXT("Chat messages a player may send in a row before the rate limit kicks in"), ECVF_Default );
+
+int32 CVar_ShooterChat_MaxMessageLength = 128;
+static FAutoConsoleVariableRef CVarShooterChatMaxMessageLength(TEXT("ShooterChat.MaxMessageLength"), CVar_ShooterChat_MaxMessageLength, TEXT("Chat messages are cut to this many characters on the server"), ECVF_Default );
+
+// Keeps a single batch small, whatever is left is sent next frame.
+int32 CVar_ShooterChat_MaxMessagesPerBatch = 16;
+static FAutoConsoleVariableRef CVarShooterChatMaxMessagesPerBatch(TEXT("ShooterChat.MaxMessagesPerBatch"), CVar_ShooterChat_MaxMessagesPerBatch, TEXT("Max chat messages sent to a player in one frame"), ECVF_Default );
+
+int32 CVar_ShooterChat_MaxQueued = 64;
+static FAutoConsoleVariableRef CVarShooterChatMaxQueued(TEXT("ShooterChat.MaxQueued"), CVar_ShooterChat_MaxQueued, TEXT("Chat messages waiting to be sent, oldest are dropped past that"), ECVF_Default );
+
+FShooterChatRouter::FShooterChatRouter(UWorld* InWorld)
+	: World(InWorld)
+	, bHasRejections(false)
+{
+}
+
+bool FShooterChatRouter::SubmitMessage(APlayerController* Sender, const FString& Text, bool bTeamOnly)
+{
+	if (Sender == nullptr)
+	{
+		return false;
+	}
+
+	FString TrimmedText = Text.Left(CVar_ShooterChat_MaxMessageLength).TrimStartAndEnd();
+	if (TrimmedText.IsEmpty())
+	{
+		return false;
+	}
+
+	if (!ConsumeToken(Sender))
+	{
+		INC_DWORD_STAT(STAT_ShooterChat_Rejected);
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_ShooterChat_Messages);
+
+	// team chat only makes sense if there are teams
+	const AShooterGameState* GameState = World.IsValid() ? World->GetGameState<AShooterGameState>() : nullptr;
+	const AShooterPlayerState* SenderPlayerState = Cast<AShooterPlayerState>(Sender->PlayerState);
+	const bool bUseTeam = bTeamOnly && GameState && GameState->NumTeams > 1 && SenderPlayerState;
+
+	if (CVar_ShooterChat_MaxQueued > 0 && QueuedMessages.Num() >= CVar_ShooterChat_MaxQueued)
+	{
+		DropQueuedMessages(QueuedMessages.Num() - CVar_ShooterChat_MaxQueued + 1);
+	}
+
+	FQueuedMessage& Queued = QueuedMessages.AddDefaulted_GetRef();
+	Queued.Message.Text = MoveTemp(TrimmedText);
+	Queued.Message.bTeamOnly = bUseTeam;
+	Queued.Sender = Sender;
+	Queued.TeamNum = bUseTeam ? SenderPlayerState->GetTeamNum() : INDEX_NONE;
+
+	return true;
+}
+
+void FShooterChatRouter::RemovePlayer(APlayerController* Player)
+{
+	Senders.Remove(Player);
+}
+
+void FShooterChatRouter::DropQueuedMessages(int32 NumToDrop)
+{
+	for (int32 i = 0; i < NumToDrop; i++)
+	{
+		FSenderState* State = Senders.Find(QueuedMessages[i].Sender);
+		if (State)
+		{
+			State->NumRejected++;
+			bHasRejections = true;
+		}
+		INC_DWORD_STAT(STAT_ShooterChat_Rejected);
+	}
+
+	QueuedMessages.RemoveAt(0, NumToDrop, false);
+}
+
+bool FShooterChatRouter::ConsumeToken(APlayerController* Sender)
+{
+	const double Now = FPlatformTime::Seconds();
+	const float Burst = FMath::Max(CVar_ShooterChat_Burst, 1);
+
+	FSenderState* State = Senders.Find(Sender);
+	if (State == nullptr)
+	{
+		State = &Senders.Add(Sender);
+		State->Tokens = Burst;
+		State->LastRefillTime = Now;
+		State->NumRejected = 0;
+	}
+
+	State->Tokens = FMath::Min(Burst, State->Tokens + float(Now - State->LastRefillTime) * CVar_ShooterChat_MessagesPerSecond);
+	State->LastRefillTime = Now;
+
+	if (State->Tokens < 1.0f)
+	{
+		State->NumRejected++;
+		bHasRejections = true;
+		return false;
+	}
+
+	State->Tokens -= 1.0f;
+	return true;
+}
+
+bool FShooterChatRouter::IsRecipient(const FQueuedMessage& Queued, const APlayerController* Recipient) const
+{
+	// senders add their own lines locally
+	if (Queued.Sender.Get() == Recipient)
+	{
+		return false;
+	}
+
+	if (Queued.TeamNum != INDEX_NONE)
+	{
+		const AShooterPlayerState* RecipientPlayerState = Cast<AShooterPlayerState>(Recipient->PlayerState);
+		return RecipientPlayerState && RecipientPlayerState->GetTeamNum() == Queued.TeamNum;
+	}
+
+	return true;
+}
+
+void FShooterChatRouter::Tick(float DeltaTime)
+{
+	if (QueuedMessages.Num() == 0 && !bHasRejections)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ShooterChat_Flush);
+
+	UWorld* MyWorld = World.Get();
+	if (MyWorld == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumToSend = CVar_ShooterChat_MaxMessagesPerBatch > 0 ? FMath::Min(QueuedMessages.Num(), CVar_ShooterChat_MaxMessagesPerBatch) : QueuedMessages.Num();
+
+	TArray<FShooterChatMessage> Batch;
+	Batch.Reserve(NumToSend);
+
+	for (FConstPlayerControllerIterator It = MyWorld->GetPlayerControllerIterator(); It; ++It)
+	{
+		AShooterPlayerController* PC = Cast<AShooterPlayerController>(It->Get());
+		if (PC == nullptr)
+		{
+			continue;
+		}
+
+		Batch.Reset();
+		for (int32 i = 0; i < NumToSend; i++)
+		{
+			if (IsRecipient(QueuedMessages[i], PC))
+			{
+				Batch.Add(QueuedMessages[i].Message);
+			}
+		}
+
+		FSenderState* State = Senders.Find(PC);
+		const int32 NumRejected = State ? State->NumRejected : 0;
+
+		if (Batch.Num() > 0 || NumRejected > 0)
+		{
+			PC->ClientReceiveChat(Batch, NumRejected);
+			INC_DWORD_STAT(STAT_ShooterChat_Batches);
+		}
+
+		if (State)
+		{
+			State->NumRejected = 0;
+		}
+	}
+
+	QueuedMessages.RemoveAt(0, NumToSend, false);
+	bHasRejections = false;
+}
+
+TStatId FShooterChatRouter::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FShooterChatRouter, STATGROUP_Tickables);
+}
+
+UWorld* FShooterChatRouter::GetTickableGameObjectWorld() const
+{
+	return World.Get();
+}
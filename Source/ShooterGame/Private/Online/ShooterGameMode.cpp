@@ -9,8 +9,28 @@
 #include "Online/ShooterPlayerState.h"
 #include "Online/ShooterGameSession.h"
 #include "Bots/ShooterAIController.h"
+#include "Bots/ShooterAIScheduler.h"
+#include "Bots/ShooterTacticalPointCache.h"
+#include "Online/ShooterSpawnManager.h"
+#include "Online/ShooterServerReplayRecorder.h"
+#include "Online/ShooterServerTelemetry.h"
+#include "Online/ShooterChatRouter.h"
+#include "Online/ShooterGarbageCollectionPolicy.h"
 #include "Math/UnrealMathUtility.h"
 #include "ShooterTeamStart.h"
+#include "Weapons/ShooterWeapon.h"
+
+DECLARE_CYCLE_STAT(TEXT("Restart Player"), STAT_ShooterRestartPlayer, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapons Spawned"), STAT_ShooterWeaponsSpawned, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapons Reused"), STAT_ShooterWeaponsReused, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapons Pooled"), STAT_ShooterWeaponsPooled, STATGROUP_Game);
+
+int32 CVar_ShooterPool_MaxWeapons = 64;
+static FAutoConsoleVariableRef CVarShooterPoolMaxWeapons(TEXT("ShooterPool.MaxWeapons"), CVar_ShooterPool_MaxWeapons, TEXT("Weapons of dead pawns kept for respawning ones, 0 to always spawn new weapons"), ECVF_Default );
+
+// Spawns scoring within this of the best one are picked at random, so players don't always appear at the same spot.
+float CVar_ShooterSpawn_ScoreTolerance = 0.1f;
+static FAutoConsoleVariableRef CVarShooterSpawnScoreTolerance(TEXT("ShooterSpawn.ScoreTolerance"), CVar_ShooterSpawn_ScoreTolerance, TEXT("Spawns scoring within this of the best one are picked at random"), ECVF_Default );
 
 
 AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -126,6 +146,12 @@ void AShooterGameMode::PreInitializeComponents()
 {
 	Super::PreInitializeComponents();
 
+	BotScheduler = MakeShared<FShooterAIScheduler>(GetWorld());
+	TacticalPoints = MakeShared<FShooterTacticalPointCache>();
+	SpawnManager = MakeShared<FShooterSpawnManager>();
+	ChatRouter = MakeShared<FShooterChatRouter>(GetWorld());
+	GarbageCollectionPolicy = MakeShared<FShooterGarbageCollectionPolicy>(GetWorld());
+
 	GetWorldTimerManager().SetTimer(TimerHandle_DefaultTimer, this, &AShooterGameMode::DefaultTimer, GetWorldSettings()->GetEffectiveTimeDilation(), true);
 }
 
@@ -204,6 +230,18 @@ void AShooterGameMode::HandleMatchIsWaitingToStart()
 {
 	Super::HandleMatchIsWaitingToStart();
 
+	// cache the map's spawn points before the first wave of spawns
+	if (!SpawnManager->IsInitialized())
+	{
+		SpawnManager->Initialize(GetWorld());
+	}
+
+	// the navmesh is loaded with the map by now, sample it over the next frames, bots query the navmesh until it's done
+	if (TacticalPoints.IsValid() && !TacticalPoints->IsBuilt() && !TacticalPoints->IsBuilding())
+	{
+		TacticalPoints->StartBuild(GetWorld());
+	}
+
 	if (bNeedsBotCreation)
 	{
 		CreateBotControllers();
@@ -228,6 +266,12 @@ void AShooterGameMode::HandleMatchIsWaitingToStart()
 		}
 	}
 
+	UShooterGameInstance* const GameInstance = Cast<UShooterGameInstance>(GetGameInstance());
+	if (GameInstance && GameInstance->GetServerTelemetry())
+	{
+		GameInstance->GetServerTelemetry()->NotifyReady();
+	}
+
 	if (IsRunningOnZeuz() && PayloadLocalAPI != NULL)
 	{
 		TrySetPayloadToReady();
@@ -242,6 +286,7 @@ void AShooterGameMode::TrySetPayloadToReady()
 	UE_LOG(LogGameMode, Display, TEXT("Attempting to set payload to Ready state..."));
 	PayloadLocalAPI->ReadyV0(Request, OnSetPayloadToReadyDelegate);
 
+	FShooterServerTimingScope TimingScope(EShooterServerTiming::PayloadHttp);
 	FHttpModule::Get().GetHttpManager().Flush(false);
 }
 
@@ -252,6 +297,7 @@ void AShooterGameMode::UpdatePayloadStatus()
 
 	PayloadLocalAPI->GetPayloadV0(Request, OnUpdatePayloadStatusDelegate);
 
+	FShooterServerTimingScope TimingScope(EShooterServerTiming::PayloadHttp);
 	FHttpModule::Get().GetHttpManager().Flush(false);
 }
 
@@ -263,6 +309,7 @@ void AShooterGameMode::RetrieveSessionConfig()
 	UE_LOG(LogGameMode, Display, TEXT("Attempting to retrieve session config..."));
 	SessionManagerLocalAPI->GetSessionConfigV0(Request, OnRetrieveSessionConfigDelegate);
 
+	FShooterServerTimingScope TimingScope(EShooterServerTiming::PayloadHttp);
 	FHttpModule::Get().GetHttpManager().Flush(false);
 }
 
@@ -276,6 +323,7 @@ void AShooterGameMode::SetSessionStatus()
 	UE_LOG(LogGameMode, Display, TEXT("Attempting to set session status..."));
 	SessionManagerLocalAPI->ApiV0SessionManagerStatusPost(Request, OnSetSessionStatusDelegate);
 
+	FShooterServerTimingScope TimingScope(EShooterServerTiming::PayloadHttp);
 	FHttpModule::Get().GetHttpManager().Flush(false);
 }
 
@@ -397,6 +445,12 @@ TMap<FString, FString> AShooterGameMode::CreateSessionStatusBody()
 	Body.Add("CurrentNumPlayers", FString::FromInt(GetNumPlayers()));
 	Body.Add("MaxNumPlayers", FString::FromInt(MaxNumPlayers));
 
+	UShooterGameInstance* const GameInstance = Cast<UShooterGameInstance>(GetGameInstance());
+	if (GameInstance && GameInstance->GetServerTelemetry())
+	{
+		GameInstance->GetServerTelemetry()->AddSessionStatus(Body);
+	}
+
 	return Body;
 }
 
@@ -421,6 +475,12 @@ void AShooterGameMode::HandleMatchHasStarted()
 	MyGameState->RemainingTime = RoundTime;	
 	StartBots();	
 
+	UShooterGameInstance* const GameInstance = Cast<UShooterGameInstance>(GetGameInstance());
+	if (GameInstance && GameInstance->GetServerReplayRecorder())
+	{
+		GameInstance->GetServerReplayRecorder()->OnMatchStarted();
+	}
+
 	// notify players
 	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
 	{
@@ -445,6 +505,12 @@ void AShooterGameMode::FinishMatch()
 		EndMatch();
 		DetermineMatchWinner();		
 
+		UShooterGameInstance* const GameInstance = Cast<UShooterGameInstance>(GetGameInstance());
+		if (GameInstance && GameInstance->GetServerReplayRecorder())
+		{
+			GameInstance->GetServerReplayRecorder()->OnMatchEnded();
+		}
+
 		// notify players
 		for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
 		{
@@ -573,6 +639,11 @@ void AShooterGameMode::Logout(AController* Exiting)
 {
 	Super::Logout(Exiting);
 
+	if (ChatRouter.IsValid())
+	{
+		ChatRouter->RemovePlayer(Cast<APlayerController>(Exiting));
+	}
+
 	// Update Session Status so that player count reflects that a player has left the game
 	SetSessionStatus();
 }
@@ -593,13 +664,18 @@ void AShooterGameMode::Killed(AController* Killer, AController* KilledPlayer, AP
 	if (KillerPlayerState && KillerPlayerState != VictimPlayerState)
 	{
 		KillerPlayerState->ScoreKill(VictimPlayerState, KillScore);
-		KillerPlayerState->InformAboutKill(KillerPlayerState, DamageType, VictimPlayerState);
 	}
 
 	if (VictimPlayerState)
 	{
 		VictimPlayerState->ScoreDeath(KillerPlayerState, DeathScore);
-		VictimPlayerState->BroadcastDeath(KillerPlayerState, DamageType, VictimPlayerState);
+
+		// clients hear about it through the replicated kill feed
+		AShooterGameState* const MyGameState = GetGameState<AShooterGameState>();
+		if (MyGameState)
+		{
+			MyGameState->AddKill(KillerPlayerState, VictimPlayerState, DamageType);
+		}
 	}
 }
 
@@ -607,6 +683,11 @@ float AShooterGameMode::ModifyDamage(float Damage, AActor* DamagedActor, struct
 {
 	float ActualDamage = Damage;
 
+	if (GarbageCollectionPolicy.IsValid())
+	{
+		GarbageCollectionPolicy->NotifyCombat();
+	}
+
 	AShooterCharacter* DamagedPawn = Cast<AShooterCharacter>(DamagedActor);
 	if (DamagedPawn && EventInstigator)
 	{
@@ -656,6 +737,8 @@ UClass* AShooterGameMode::GetDefaultPawnClassForController_Implementation(AContr
 
 void AShooterGameMode::RestartPlayer(AController* NewPlayer)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterRestartPlayer);
+
 	Super::RestartPlayer(NewPlayer);
 
 	AShooterPlayerController* PC = Cast<AShooterPlayerController>(NewPlayer);
@@ -672,51 +755,170 @@ void AShooterGameMode::RestartPlayer(AController* NewPlayer)
 	}
 }
 
+AShooterWeapon* AShooterGameMode::AcquireWeapon(TSubclassOf<AShooterWeapon> WeaponClass)
+{
+	if (WeaponClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	const int32 PooledIndex = PooledWeapons.IndexOfByPredicate([&WeaponClass](const AShooterWeapon* Weapon)
+	{
+		return Weapon && !Weapon->IsPendingKill() && Weapon->GetClass() == WeaponClass;
+	});
+
+	if (PooledIndex != INDEX_NONE)
+	{
+		AShooterWeapon* Weapon = PooledWeapons[PooledIndex];
+		PooledWeapons.RemoveAtSwap(PooledIndex);
+		DEC_DWORD_STAT(STAT_ShooterWeaponsPooled);
+		INC_DWORD_STAT(STAT_ShooterWeaponsReused);
+
+		Weapon->SetActorTickEnabled(true);
+		return Weapon;
+	}
+
+	INC_DWORD_STAT(STAT_ShooterWeaponsSpawned);
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, SpawnInfo);
+}
+
+void AShooterGameMode::ReleaseWeapon(AShooterWeapon* Weapon)
+{
+	if (Weapon == nullptr || Weapon->IsPendingKill())
+	{
+		return;
+	}
+
+	// the weapon has no owner anymore, so the replication graph stops gathering it and clients drop their copy
+	if (PooledWeapons.Num() >= CVar_ShooterPool_MaxWeapons || GetWorld()->bIsTearingDown)
+	{
+		Weapon->Destroy();
+		return;
+	}
+
+	Weapon->ResetForReuse();
+	Weapon->SetActorTickEnabled(false);
+	PooledWeapons.Add(Weapon);
+	INC_DWORD_STAT(STAT_ShooterWeaponsPooled);
+}
+
 AActor* AShooterGameMode::ChoosePlayerStart_Implementation(AController* Player)
 {
-	TArray<APlayerStart*> PreferredSpawns;
-	TArray<APlayerStart*> FallbackSpawns;
+	APlayerStart* BestStart = ChooseSpawnFromIndex(Player);
+	return BestStart ? BestStart : Super::ChoosePlayerStart_Implementation(Player);
+}
 
-	APlayerStart* BestStart = NULL;
-	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+APlayerStart* AShooterGameMode::ChooseSpawnFromIndex(AController* Player)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(AShooterGameMode_ChooseSpawnFromIndex);
+
+	if (!SpawnManager->IsInitialized())
 	{
-		APlayerStart* TestSpawn = *It;
-		if (TestSpawn->IsA<APlayerStartPIE>())
+		SpawnManager->Initialize(GetWorld());
+	}
+
+	// Always prefer the first "Play from Here" PlayerStart, if we find one while in PIE mode
+	if (APlayerStart* PIEStart = SpawnManager->GetPIEStart())
+	{
+		return PIEStart;
+	}
+
+	SpawnManager->UpdatePawnIndex(GetWorld());
+
+	struct FScoredSpawn
+	{
+		APlayerStart* Spawn;
+		float Score;
+	};
+	TArray<FScoredSpawn, TInlineAllocator<32>> PreferredSpawns;
+	TArray<APlayerStart*, TInlineAllocator<32>> FallbackSpawns;
+
+	const int32 TeamNum = GetSpawnTeamNum(Player);
+	float BestScore = 0.0f;
+	auto AddCandidate = [&](APlayerStart* TestSpawn)
+	{
+		if (IsSpawnpointPreferred(TestSpawn, Player))
 		{
-			// Always prefer the first "Play from Here" PlayerStart, if we find one while in PIE mode
-			BestStart = TestSpawn;
-			break;
+			const float Score = SpawnManager->ScoreSpawn(GetWorld(), TestSpawn->GetActorLocation(), Player, TeamNum);
+			PreferredSpawns.Add({ TestSpawn, Score });
+			BestScore = FMath::Max(BestScore, Score);
 		}
 		else
 		{
-			if (IsSpawnpointAllowed(TestSpawn, Player))
-			{
-				if (IsSpawnpointPreferred(TestSpawn, Player))
-				{
-					PreferredSpawns.Add(TestSpawn);
-				}
-				else
-				{
-					FallbackSpawns.Add(TestSpawn);
-				}
-			}
+			FallbackSpawns.Add(TestSpawn);
+		}
+	};
+
+	for (const TWeakObjectPtr<AShooterTeamStart>& Candidate : GetSpawnCandidates(Player))
+	{
+		AShooterTeamStart* TestSpawn = Candidate.Get();
+		if (TestSpawn && IsSpawnpointAllowed(TestSpawn, Player))
+		{
+			AddCandidate(TestSpawn);
 		}
 	}
 
-	
-	if (BestStart == NULL)
+	// maps without team starts spawn everybody on their plain player starts
+	if (!SpawnManager->HasTeamStarts())
 	{
-		if (PreferredSpawns.Num() > 0)
+		for (const TWeakObjectPtr<APlayerStart>& Candidate : SpawnManager->GetPlainStarts())
 		{
-			BestStart = PreferredSpawns[FMath::RandHelper(PreferredSpawns.Num())];
+			if (APlayerStart* TestSpawn = Candidate.Get())
+			{
+				AddCandidate(TestSpawn);
+			}
 		}
-		else if (FallbackSpawns.Num() > 0)
+	}
+
+	APlayerStart* BestStart = NULL;
+	if (PreferredSpawns.Num() > 0)
+	{
+		TArray<APlayerStart*, TInlineAllocator<32>> BestSpawns;
+		for (const FScoredSpawn& Scored : PreferredSpawns)
 		{
-			BestStart = FallbackSpawns[FMath::RandHelper(FallbackSpawns.Num())];
+			if (Scored.Score >= BestScore - CVar_ShooterSpawn_ScoreTolerance)
+			{
+				BestSpawns.Add(Scored.Spawn);
+			}
 		}
+		BestStart = BestSpawns[FMath::RandHelper(BestSpawns.Num())];
+	}
+	else if (FallbackSpawns.Num() > 0)
+	{
+		BestStart = FallbackSpawns[FMath::RandHelper(FallbackSpawns.Num())];
 	}
 
-	return BestStart ? BestStart : Super::ChoosePlayerStart_Implementation(Player);
+	// the pawn only exists once the spawn happened, so block the start for everybody else spawning this frame
+	ACharacter* MyPawn = GetSpawnPawnDefaults(Player);
+	if (BestStart && MyPawn)
+	{
+		SpawnManager->ReserveSpawn(BestStart->GetActorLocation(), MyPawn->GetCapsuleComponent()->GetScaledCapsuleRadius(), MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+	}
+
+	return BestStart;
+}
+
+const TArray<TWeakObjectPtr<AShooterTeamStart>>& AShooterGameMode::GetSpawnCandidates(AController* Player) const
+{
+	return SpawnManager->GetStarts(Player && Player->IsA<AShooterAIController>());
+}
+
+int32 AShooterGameMode::GetSpawnTeamNum(AController* Player) const
+{
+	return INDEX_NONE;
+}
+
+ACharacter* AShooterGameMode::GetSpawnPawnDefaults(AController* Player) const
+{
+	if (Cast<AShooterAIController>(Player) != nullptr)
+	{
+		return BotPawnClass ? BotPawnClass->GetDefaultObject<ACharacter>() : nullptr;
+	}
+
+	return DefaultPawnClass ? Cast<ACharacter>(DefaultPawnClass->GetDefaultObject()) : nullptr;
 }
 
 bool AShooterGameMode::IsSpawnpointAllowed(APlayerStart* SpawnPoint, AController* Player) const
@@ -742,38 +944,112 @@ bool AShooterGameMode::IsSpawnpointAllowed(APlayerStart* SpawnPoint, AController
 
 bool AShooterGameMode::IsSpawnpointPreferred(APlayerStart* SpawnPoint, AController* Player) const
 {
-	ACharacter* MyPawn = Cast<ACharacter>((*DefaultPawnClass)->GetDefaultObject<ACharacter>());	
-	AShooterAIController* AIController = Cast<AShooterAIController>(Player);
-	if( AIController != nullptr )
+	ACharacter* MyPawn = GetSpawnPawnDefaults(Player);
+	if (MyPawn == nullptr)
 	{
-		MyPawn = Cast<ACharacter>(BotPawnClass->GetDefaultObject<ACharacter>());
+		return false;
 	}
-	
-	if (MyPawn)
+
+	// check if player start overlaps any pawn, only looking at pawns indexed around the spawn
+	SpawnManager->UpdatePawnIndex(GetWorld());
+	return !SpawnManager->IsOccupied(SpawnPoint->GetActorLocation(), MyPawn->GetCapsuleComponent()->GetScaledCapsuleRadius(), MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+}
+
+/** The spawn selection used before the spawn manager: scans every start and tests it against every character. Kept as a reference for BenchmarkSpawnSelection. */
+static APlayerStart* ChoosePlayerStartByActorScan(UWorld* World, ACharacter* MyPawn, TFunctionRef<bool(APlayerStart*)> IsAllowed)
+{
+	TArray<APlayerStart*> PreferredSpawns;
+	TArray<APlayerStart*> FallbackSpawns;
+
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
 	{
-		const FVector SpawnLocation = SpawnPoint->GetActorLocation();
-		for (ACharacter* OtherPawn : TActorRange<ACharacter>(GetWorld()))
+		APlayerStart* TestSpawn = *It;
+		if (!IsAllowed(TestSpawn))
+		{
+			continue;
+		}
+
+		bool bPreferred = (MyPawn != nullptr);
+		const FVector SpawnLocation = TestSpawn->GetActorLocation();
+		for (ACharacter* OtherPawn : TActorRange<ACharacter>(World))
 		{
-			if (OtherPawn != MyPawn)
+			if (MyPawn == nullptr)
 			{
-				const float CombinedHeight = (MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) * 2.0f;
-				const float CombinedRadius = MyPawn->GetCapsuleComponent()->GetScaledCapsuleRadius() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleRadius();
-				const FVector OtherLocation = OtherPawn->GetActorLocation();
+				break;
+			}
 
-				// check if player start overlaps this pawn
-				if (FMath::Abs(SpawnLocation.Z - OtherLocation.Z) < CombinedHeight && (SpawnLocation - OtherLocation).Size2D() < CombinedRadius)
-				{
-					return false;
-				}
+			const float CombinedHeight = (MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) * 2.0f;
+			const float CombinedRadius = MyPawn->GetCapsuleComponent()->GetScaledCapsuleRadius() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleRadius();
+			const FVector OtherLocation = OtherPawn->GetActorLocation();
+			if (FMath::Abs(SpawnLocation.Z - OtherLocation.Z) < CombinedHeight && (SpawnLocation - OtherLocation).Size2D() < CombinedRadius)
+			{
+				bPreferred = false;
+				break;
 			}
 		}
+
+		(bPreferred ? PreferredSpawns : FallbackSpawns).Add(TestSpawn);
 	}
-	else
+
+	if (PreferredSpawns.Num() > 0)
 	{
-		return false;
+		return PreferredSpawns[FMath::RandHelper(PreferredSpawns.Num())];
 	}
-	
-	return true;
+
+	return FallbackSpawns.Num() > 0 ? FallbackSpawns[FMath::RandHelper(FallbackSpawns.Num())] : nullptr;
+}
+
+void AShooterGameMode::BenchmarkSpawnSelection(int32 NumSpawns)
+{
+	TArray<AController*> Controllers;
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		if (It->IsValid() && (*It)->PlayerState)
+		{
+			Controllers.Add(It->Get());
+		}
+	}
+
+	if (Controllers.Num() == 0 || NumSpawns <= 0)
+	{
+		UE_LOG(LogGameMode, Warning, TEXT("BenchmarkSpawnSelection: nothing to spawn."));
+		return;
+	}
+
+	int32 NumCharacters = 0;
+	for (ACharacter* Character : TActorRange<ACharacter>(GetWorld()))
+	{
+		++NumCharacters;
+	}
+
+	// simulate a round start: every spawn happens in the same frame
+	const double ActorScanStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumSpawns; ++i)
+	{
+		AController* Player = Controllers[i % Controllers.Num()];
+		ChoosePlayerStartByActorScan(GetWorld(), GetSpawnPawnDefaults(Player), [this, Player](APlayerStart* Spawn) { return IsSpawnpointAllowed(Spawn, Player); });
+	}
+	const double ActorScanTime = FPlatformTime::Seconds() - ActorScanStart;
+
+	// the spawn manager collects the starts once per map, rebuild it so that cost is part of the comparison
+	const double BuildStart = FPlatformTime::Seconds();
+	SpawnManager->Initialize(GetWorld());
+	const double BuildTime = FPlatformTime::Seconds() - BuildStart;
+
+	const double IndexStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumSpawns; ++i)
+	{
+		ChooseSpawnFromIndex(Controllers[i % Controllers.Num()]);
+	}
+	const double IndexTime = FPlatformTime::Seconds() - IndexStart;
+
+	// drop the reservations made by the benchmark
+	SpawnManager->InvalidatePawnIndex();
+
+	UE_LOG(LogGameMode, Display, TEXT("BenchmarkSpawnSelection: %d spawns, %d player starts, %d characters. Actor scan: %.3f ms (%.1f us/spawn). Spawn manager: %.3f ms build once per map, %.3f ms selection (%.1f us/spawn), %.3f ms in total."),
+		NumSpawns, SpawnManager->GetStarts(false).Num(), NumCharacters,
+		ActorScanTime * 1000.0, ActorScanTime * 1000000.0 / NumSpawns,
+		BuildTime * 1000.0, IndexTime * 1000.0, IndexTime * 1000000.0 / NumSpawns, (BuildTime + IndexTime) * 1000.0);
 }
 
 void AShooterGameMode::CreateBotControllers()
@@ -5,12 +5,35 @@
 #include "ShooterGameInstance.h"
 #include "OnlineSubsystemUtils.h"
 #include "OnlineGameMatchesInterface.h"
+#include "Algo/BinarySearch.h"
+#include "Effects/ShooterImpactEffectManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Kill Feed Entries"), STAT_ShooterKillFeed_Entries, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Kill Feed Entries Missed"), STAT_ShooterKillFeed_Missed, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Team Material Instances"), STAT_ShooterTeamMaterials, STATGROUP_Game);
+
+namespace
+{
+	/** kills kept in the feed, enough for a few frames worth of explosions */
+	const int32 KillFeedSize = 16;
+
+	/** kills older than this when they reach a client aren't shown, e.g. when joining a match in progress */
+	const float KillFeedMaxAge = 10.0f;
+
+	/** how long to wait for the player states of an entry to replicate before giving up on it */
+	const float KillFeedResolveTime = 2.0f;
+}
 
 AShooterGameState::AShooterGameState(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	NumTeams = 0;
 	RemainingTime = 0;
 	bTimerPaused = false;
+	ImpactEffectManager = nullptr;
+	NextKillId = 1;
+	LastProcessedKillId = 0;
+
+	KillFeed.SetNum(KillFeedSize);
 
 	UShooterGameInstance* GameInstance = GetWorld() != nullptr ? Cast<UShooterGameInstance>(GetWorld()->GetGameInstance()) : nullptr;
 
@@ -25,38 +48,248 @@ void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	DOREPLIFETIME( AShooterGameState, RemainingTime );
 	DOREPLIFETIME( AShooterGameState, bTimerPaused );
 	DOREPLIFETIME( AShooterGameState, TeamScores );
+	DOREPLIFETIME( AShooterGameState, KillFeed );
+}
+
+void AShooterGameState::AddKill(AShooterPlayerState* KillerPlayerState, AShooterPlayerState* VictimPlayerState, const UDamageType* DamageType)
+{
+	if (VictimPlayerState == nullptr)
+	{
+		return;
+	}
+
+	FShooterKillFeedEntry& Entry = KillFeed[NextKillId % KillFeed.Num()];
+	Entry.Id = NextKillId++;
+	Entry.Killer = KillerPlayerState;
+	Entry.Victim = VictimPlayerState;
+	Entry.bHasKiller = KillerPlayerState != nullptr;
+	Entry.DamageType = DamageType ? DamageType->GetClass() : nullptr;
+	Entry.Time = GetServerWorldTimeSeconds();
+
+	INC_DWORD_STAT(STAT_ShooterKillFeed_Entries);
+
+	// OnRep doesn't run where the feed is written
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		ProcessKillFeed();
+	}
+}
+
+void AShooterGameState::OnRep_KillFeed()
+{
+	ProcessKillFeed();
+}
+
+void AShooterGameState::ProcessKillFeed()
+{
+	TArray<const FShooterKillFeedEntry*, TInlineAllocator<KillFeedSize>> NewEntries;
+	for (const FShooterKillFeedEntry& Entry : KillFeed)
+	{
+		if (Entry.Id > LastProcessedKillId)
+		{
+			NewEntries.Add(&Entry);
+		}
+	}
+
+	if (NewEntries.Num() == 0)
+	{
+		return;
+	}
+
+	NewEntries.Sort([](const FShooterKillFeedEntry& A, const FShooterKillFeedEntry& B) { return A.Id < B.Id; });
+
+	const float Now = GetServerWorldTimeSeconds();
+
+	// more kills than the feed holds happened since the last update we got
+	if (LastProcessedKillId > 0 && NewEntries[0]->Id > LastProcessedKillId + 1)
+	{
+		INC_DWORD_STAT_BY(STAT_ShooterKillFeed_Missed, NewEntries[0]->Id - LastProcessedKillId - 1);
+	}
+
+	for (const FShooterKillFeedEntry* Entry : NewEntries)
+	{
+		// player states referenced by the entry may replicate after it, OnRep runs again once they do, the timer shows
+		// the entry without a missing killer, or skips it without a victim, if they never do
+		const bool bResolved = Entry->Victim != nullptr && (!Entry->bHasKiller || Entry->Killer != nullptr);
+		if (!bResolved && Now - Entry->Time < KillFeedResolveTime)
+		{
+			GetWorldTimerManager().SetTimer(TimerHandle_ProcessKillFeed, this, &AShooterGameState::ProcessKillFeed, FMath::Max(KillFeedResolveTime - (Now - Entry->Time), 0.1f), false);
+			break;
+		}
+
+		LastProcessedKillId = Entry->Id;
+
+		if (Entry->Victim == nullptr || Now - Entry->Time > KillFeedMaxAge)
+		{
+			continue;
+		}
+
+		const UDamageType* DamageType = Entry->DamageType ? Entry->DamageType->GetDefaultObject<UDamageType>() : nullptr;
+
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			// all local players get death messages so they can update their huds.
+			AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
+			if (TestPC && TestPC->IsLocalController())
+			{
+				TestPC->OnDeathMessage(Entry->Killer, Entry->Victim, DamageType);
+
+				if (Entry->Killer && Entry->Killer != Entry->Victim && TestPC->PlayerState == Entry->Killer)
+				{
+					TestPC->OnKill();
+				}
+			}
+		}
+	}
 }
 
 void AShooterGameState::GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const
 {
 	OutRankedMap.Empty();
 
-	//first, we need to go over all the PlayerStates, grab their score, and rank them
-	TMultiMap<int32, AShooterPlayerState*> SortedMap;
-	for(int32 i = 0; i < PlayerArray.Num(); ++i)
+	const TArray<FShooterRankedPlayer>& TeamPlayers = GetRankedPlayers(TeamIndex);
+	for (int32 Rank = 0; Rank < TeamPlayers.Num(); ++Rank)
+	{
+		OutRankedMap.Add(Rank, TeamPlayers[Rank].PlayerState);
+	}
+}
+
+const TArray<FShooterRankedPlayer>& AShooterGameState::GetRankedPlayers(int32 TeamIndex) const
+{
+	static const TArray<FShooterRankedPlayer> NoPlayers;
+	return RankedTeams.IsValidIndex(TeamIndex) ? RankedTeams[TeamIndex] : NoPlayers;
+}
+
+int32 AShooterGameState::GetPlayerRank(const AShooterPlayerState* PlayerState) const
+{
+	const FShooterRankedPlayer* Entry = RankedPlayers.Find(PlayerState);
+	if (Entry == nullptr || !RankedTeams.IsValidIndex(Entry->TeamNum))
+	{
+		return INDEX_NONE;
+	}
+
+	const TArray<FShooterRankedPlayer>& TeamPlayers = RankedTeams[Entry->TeamNum];
+	const int32 Rank = Algo::LowerBound(TeamPlayers, *Entry);
+	return TeamPlayers.IsValidIndex(Rank) && TeamPlayers[Rank].PlayerState == Entry->PlayerState ? Rank : INDEX_NONE;
+}
+
+void AShooterGameState::UpdatePlayerRanking(AShooterPlayerState* PlayerState)
+{
+	// only players that are part of the game, replicated properties may arrive before the player is added or after it left
+	if (RemoveFromRanking(PlayerState))
+	{
+		AddToRanking(PlayerState);
+	}
+}
+
+void AShooterGameState::AddPlayerState(APlayerState* PlayerState)
+{
+	Super::AddPlayerState(PlayerState);
+
+	AShooterPlayerState* ShooterPlayerState = Cast<AShooterPlayerState>(PlayerState);
+	if (ShooterPlayerState && !PlayerState->IsInactive())
 	{
-		int32 Score = 0;
-		AShooterPlayerState* CurPlayerState = Cast<AShooterPlayerState>(PlayerArray[i]);
-		if (CurPlayerState && (CurPlayerState->GetTeamNum() == TeamIndex))
+		RemoveFromRanking(ShooterPlayerState);
+		AddToRanking(ShooterPlayerState);
+
+		// [client] the pawn may have arrived before us, and couldn't get its team colors then
+		AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(ShooterPlayerState->GetPawn());
+		if (ShooterCharacter)
 		{
-			SortedMap.Add(FMath::TruncToInt(CurPlayerState->GetScore()), CurPlayerState);
+			ShooterCharacter->UpdateTeamColors();
 		}
 	}
+}
 
-	//sort by the keys
-	SortedMap.KeySort(TGreater<int32>());
+void AShooterGameState::RemovePlayerState(APlayerState* PlayerState)
+{
+	RemoveFromRanking(Cast<AShooterPlayerState>(PlayerState));
 
-	//now, add them back to the ranked map
-	OutRankedMap.Empty();
+	Super::RemovePlayerState(PlayerState);
+}
+
+bool AShooterGameState::RemoveFromRanking(const AShooterPlayerState* PlayerState)
+{
+	FShooterRankedPlayer Entry;
+	if (PlayerState == nullptr || !RankedPlayers.RemoveAndCopyValue(PlayerState, Entry))
+	{
+		return false;
+	}
 
-	int32 Rank = 0;
-	for(TMultiMap<int32, AShooterPlayerState*>::TIterator It(SortedMap); It; ++It)
+	if (RankedTeams.IsValidIndex(Entry.TeamNum))
 	{
-		OutRankedMap.Add(Rank++, It.Value());
+		TArray<FShooterRankedPlayer>& TeamPlayers = RankedTeams[Entry.TeamNum];
+		const int32 Index = Algo::LowerBound(TeamPlayers, Entry);
+		if (TeamPlayers.IsValidIndex(Index) && TeamPlayers[Index].PlayerState == Entry.PlayerState)
+		{
+			TeamPlayers.RemoveAt(Index, 1, false);
+		}
+
+		OnRankingChanged.Broadcast(Entry.TeamNum);
 	}
-	
+
+	return true;
 }
 
+void AShooterGameState::AddToRanking(AShooterPlayerState* PlayerState)
+{
+	FShooterRankedPlayer Entry;
+	Entry.PlayerState = PlayerState;
+	Entry.TeamNum = PlayerState->GetTeamNum();
+	Entry.Score = FMath::TruncToInt(PlayerState->GetScore());
+	Entry.PlayerId = PlayerState->GetPlayerId();
+	RankedPlayers.Add(PlayerState, Entry);
+
+	// players without a valid team are remembered, but never show up in a team ranking
+	if (Entry.TeamNum >= 0)
+	{
+		if (Entry.TeamNum >= RankedTeams.Num())
+		{
+			RankedTeams.SetNum(Entry.TeamNum + 1);
+		}
+
+		TArray<FShooterRankedPlayer>& TeamPlayers = RankedTeams[Entry.TeamNum];
+		TeamPlayers.Insert(Entry, Algo::LowerBound(TeamPlayers, Entry));
+
+		OnRankingChanged.Broadcast(Entry.TeamNum);
+	}
+}
+
+
+AShooterImpactEffectManager* AShooterGameState::GetImpactEffectManager()
+{
+	if (ImpactEffectManager == nullptr && GetNetMode() != NM_DedicatedServer)
+	{
+		FActorSpawnParameters SpawnInfo;
+		SpawnInfo.ObjectFlags |= RF_Transient;
+		ImpactEffectManager = GetWorld()->SpawnActor<AShooterImpactEffectManager>(SpawnInfo);
+	}
+
+	return ImpactEffectManager;
+}
+
+UMaterialInterface* AShooterGameState::GetTeamMaterial(UMaterialInterface* BaseMaterial, int32 TeamNum)
+{
+	if (BaseMaterial == nullptr || TeamNum < 0)
+	{
+		return BaseMaterial;
+	}
+
+	TArray<UMaterialInstanceDynamic*>& TeamMIDs = TeamMaterials.FindOrAdd(BaseMaterial).TeamMIDs;
+	if (TeamMIDs.Num() <= TeamNum)
+	{
+		TeamMIDs.SetNumZeroed(TeamNum + 1);
+	}
+
+	if (TeamMIDs[TeamNum] == nullptr)
+	{
+		TeamMIDs[TeamNum] = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+		TeamMIDs[TeamNum]->SetScalarParameterValue(TEXT("Team Color Index"), (float)TeamNum);
+		INC_DWORD_STAT(STAT_ShooterTeamMaterials);
+	}
+
+	return TeamMIDs[TeamNum];
+}
 
 void AShooterGameState::RequestFinishAndExitToMainMenu()
 {
@@ -5,6 +5,7 @@
 #include "Online/ShooterGame_TeamDeathMatch.h"
 #include "Online/ShooterPlayerState.h"
 #include "Bots/ShooterAIController.h"
+#include "Online/ShooterSpawnManager.h"
 
 AShooterGame_TeamDeathMatch::AShooterGame_TeamDeathMatch(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -124,6 +125,23 @@ bool AShooterGame_TeamDeathMatch::IsSpawnpointAllowed(APlayerStart* SpawnPoint,
 	return Super::IsSpawnpointAllowed(SpawnPoint, Player);
 }
 
+const TArray<TWeakObjectPtr<AShooterTeamStart>>& AShooterGame_TeamDeathMatch::GetSpawnCandidates(AController* Player) const
+{
+	AShooterPlayerState* PlayerState = Player ? Cast<AShooterPlayerState>(Player->PlayerState) : nullptr;
+	if (PlayerState)
+	{
+		return SpawnManager->GetTeamStarts(Player->IsA<AShooterAIController>(), PlayerState->GetTeamNum());
+	}
+
+	return Super::GetSpawnCandidates(Player);
+}
+
+int32 AShooterGame_TeamDeathMatch::GetSpawnTeamNum(AController* Player) const
+{
+	AShooterPlayerState* PlayerState = Player ? Cast<AShooterPlayerState>(Player->PlayerState) : nullptr;
+	return PlayerState ? PlayerState->GetTeamNum() : INDEX_NONE;
+}
+
 void AShooterGame_TeamDeathMatch::InitBot(AShooterAIController* AIC, int32 BotNum)
 {	
 	AShooterPlayerState* BotPlayerState = CastChecked<AShooterPlayerState>(AIC->PlayerState);
@@ -0,0 +1,212 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterGarbageCollectionPolicy.h"
+#include "Online/ShooterServerTelemetry.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterGC"), STATGROUP_ShooterGC, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Objects Created"), STAT_ShooterGC_ObjectsCreated, STATGROUP_ShooterGC);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frames Deferred"), STAT_ShooterGC_FramesDeferred, STATGROUP_ShooterGC);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Collections Requested"), STAT_ShooterGC_Requested, STATGROUP_ShooterGC);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Collections Over Budget"), STAT_ShooterGC_OverBudget, STATGROUP_ShooterGC);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Collection (ms)"), STAT_ShooterGC_LastCollection, STATGROUP_ShooterGC);
+
+int32 CVar_ShooterGC_Enabled = 1;
+static FAutoConsoleVariableRef CVarShooterGCEnabled(TEXT("ShooterGC.Enabled"), CVar_ShooterGC_Enabled, TEXT("If 0, garbage collection runs whenever the engine decides, even during fights"), ECVF_Default );
+
+float CVar_ShooterGC_QuietSeconds = 3.0f;
+static FAutoConsoleVariableRef CVarShooterGCQuietSeconds(TEXT("ShooterGC.QuietSeconds"), CVar_ShooterGC_QuietSeconds, TEXT("Seconds without damage dealt before a match counts as quiet enough to collect garbage"), ECVF_Default );
+
+// Keeps quiet windows from collecting back to back, a collection is a full reachability pass over every object.
+float CVar_ShooterGC_MinInterval = 20.0f;
+static FAutoConsoleVariableRef CVarShooterGCMinInterval(TEXT("ShooterGC.MinInterval"), CVar_ShooterGC_MinInterval, TEXT("Seconds since the last collection before a quiet window requests another one"), ECVF_Default );
+
+// Memory grows while collections are held back, past this the engine collects even in the middle of a fight.
+float CVar_ShooterGC_MaxDeferSeconds = 120.0f;
+static FAutoConsoleVariableRef CVarShooterGCMaxDeferSeconds(TEXT("ShooterGC.MaxDeferSeconds"), CVar_ShooterGC_MaxDeferSeconds, TEXT("Seconds since the last collection after which fights no longer hold collections back"), ECVF_Default );
+
+float CVar_ShooterGC_BudgetMs = 10.0f;
+static FAutoConsoleVariableRef CVarShooterGCBudgetMs(TEXT("ShooterGC.BudgetMs"), CVar_ShooterGC_BudgetMs, TEXT("Collections taking longer than this are logged as warnings, in milliseconds, 0 to never warn"), ECVF_Default );
+
+int32 CVar_ShooterGC_TrackAllocations = 1;
+static FAutoConsoleVariableRef CVarShooterGCTrackAllocations(TEXT("ShooterGC.TrackAllocations"), CVar_ShooterGC_TrackAllocations, TEXT("If 1, objects created are counted per class and the worst classes logged, takes effect on next match"), ECVF_Default );
+
+float CVar_ShooterGC_ReportInterval = 60.0f;
+static FAutoConsoleVariableRef CVarShooterGCReportInterval(TEXT("ShooterGC.ReportInterval"), CVar_ShooterGC_ReportInterval, TEXT("Seconds between logs of the classes creating the most objects"), ECVF_Default );
+
+int32 CVar_ShooterGC_ReportNumClasses = 5;
+static FAutoConsoleVariableRef CVarShooterGCReportNumClasses(TEXT("ShooterGC.ReportNumClasses"), CVar_ShooterGC_ReportNumClasses, TEXT("Classes listed in each allocation report"), ECVF_Default );
+
+FShooterGarbageCollectionPolicy::FShooterGarbageCollectionPolicy(UWorld* InWorld)
+	: World(InWorld)
+	, LastCombatTime(0.0)
+	, LastCollectTime(FPlatformTime::Seconds())
+	, CollectStartTime(0.0)
+	, bCollectRequested(false)
+	, NumCreated(0)
+	, LastReportTime(FPlatformTime::Seconds())
+	, bListeningForCreates(false)
+{
+	PreGarbageCollectDelegateHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FShooterGarbageCollectionPolicy::OnPreGarbageCollect);
+	PostGarbageCollectDelegateHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FShooterGarbageCollectionPolicy::OnPostGarbageCollect);
+
+	if (CVar_ShooterGC_TrackAllocations)
+	{
+		GUObjectArray.AddUObjectCreateListener(this);
+		bListeningForCreates = true;
+	}
+}
+
+FShooterGarbageCollectionPolicy::~FShooterGarbageCollectionPolicy()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectDelegateHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectDelegateHandle);
+
+	if (bListeningForCreates)
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+	}
+}
+
+void FShooterGarbageCollectionPolicy::NotifyCombat()
+{
+	LastCombatTime = FPlatformTime::Seconds();
+}
+
+bool FShooterGarbageCollectionPolicy::IsQuiet(double Now) const
+{
+	// warmup and post match never have fights worth protecting
+	AGameModeBase* GameMode = World.IsValid() ? World->GetAuthGameMode() : nullptr;
+	AGameMode* MatchGameMode = Cast<AGameMode>(GameMode);
+	if (MatchGameMode && !MatchGameMode->IsMatchInProgress())
+	{
+		return true;
+	}
+
+	return Now - LastCombatTime >= CVar_ShooterGC_QuietSeconds;
+}
+
+void FShooterGarbageCollectionPolicy::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	if (CVar_ShooterGC_ReportInterval > 0.0f && Now - LastReportTime >= CVar_ShooterGC_ReportInterval)
+	{
+		ReportAllocations(Now);
+	}
+
+	if (CVar_ShooterGC_Enabled == 0 || GEngine == nullptr)
+	{
+		return;
+	}
+
+	const double TimeSinceCollect = Now - LastCollectTime;
+
+	if (IsQuiet(Now))
+	{
+		if (!bCollectRequested && TimeSinceCollect >= CVar_ShooterGC_MinInterval)
+		{
+			// runs at the end of this frame, objects are then purged incrementally over the next ones
+			GEngine->ForceGarbageCollection(false);
+			bCollectRequested = true;
+			INC_DWORD_STAT(STAT_ShooterGC_Requested);
+		}
+	}
+	else if (!bCollectRequested && TimeSinceCollect < CVar_ShooterGC_MaxDeferSeconds)
+	{
+		// tickable objects run before the engine decides whether to collect, this only skips the current frame
+		GEngine->DelayGarbageCollection();
+		INC_DWORD_STAT(STAT_ShooterGC_FramesDeferred);
+	}
+	else if (!bCollectRequested)
+	{
+		// delaying resets the engine's purge timer, left alone it would wait another gc.TimeBetweenPurgingPendingKillObjects
+		GEngine->ForceGarbageCollection(false);
+		bCollectRequested = true;
+		INC_DWORD_STAT(STAT_ShooterGC_Requested);
+	}
+}
+
+void FShooterGarbageCollectionPolicy::OnPreGarbageCollect()
+{
+	CollectStartTime = FPlatformTime::Seconds();
+}
+
+void FShooterGarbageCollectionPolicy::OnPostGarbageCollect()
+{
+	const double Now = FPlatformTime::Seconds();
+	const float CollectMS = CollectStartTime > 0.0 ? (Now - CollectStartTime) * 1000.0 : 0.0f;
+	SET_FLOAT_STAT(STAT_ShooterGC_LastCollection, CollectMS);
+	FShooterServerTelemetry::AddTime(EShooterServerTiming::GarbageCollection, CollectMS / 1000.0);
+
+	if (CVar_ShooterGC_BudgetMs > 0.0f && CollectMS > CVar_ShooterGC_BudgetMs)
+	{
+		INC_DWORD_STAT(STAT_ShooterGC_OverBudget);
+		UE_LOG(LogShooter, Warning, TEXT("GC: collection took %.1f ms, over the %.1f ms budget, %s, %.0f s since the previous one."),
+			CollectMS, CVar_ShooterGC_BudgetMs, IsQuiet(Now) ? TEXT("quiet") : TEXT("during a fight"), CollectStartTime - LastCollectTime);
+	}
+
+	LastCollectTime = Now;
+	CollectStartTime = 0.0;
+	bCollectRequested = false;
+}
+
+void FShooterGarbageCollectionPolicy::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	// async loading creates objects on other threads, match play churn all happens on the game thread
+	if (!IsInGameThread())
+	{
+		return;
+	}
+
+	const UClass* Class = Object->GetClass();
+	if (Class)
+	{
+		CreatedByClass.FindOrAdd(Class->GetFName())++;
+		NumCreated++;
+		INC_DWORD_STAT(STAT_ShooterGC_ObjectsCreated);
+	}
+}
+
+void FShooterGarbageCollectionPolicy::OnUObjectArrayShutdown()
+{
+	GUObjectArray.RemoveUObjectCreateListener(this);
+	bListeningForCreates = false;
+}
+
+void FShooterGarbageCollectionPolicy::ReportAllocations(double Now)
+{
+	const float Seconds = Now - LastReportTime;
+	LastReportTime = Now;
+
+	if (NumCreated > 0 && Seconds > 0.0f)
+	{
+		CreatedByClass.ValueSort([](int32 A, int32 B) { return A > B; });
+
+		UE_LOG(LogShooter, Log, TEXT("GC: %d objects created in %.0f s, %.1f per second."), NumCreated, Seconds, NumCreated / Seconds);
+
+		int32 NumListed = 0;
+		for (const TPair<FName, int32>& Pair : CreatedByClass)
+		{
+			if (NumListed++ >= CVar_ShooterGC_ReportNumClasses)
+			{
+				break;
+			}
+			UE_LOG(LogShooter, Log, TEXT("GC:   %s: %d, %.1f per second."), *Pair.Key.ToString(), Pair.Value, Pair.Value / Seconds);
+		}
+	}
+
+	CreatedByClass.Reset();
+	NumCreated = 0;
+}
+
+TStatId FShooterGarbageCollectionPolicy::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FShooterGarbageCollectionPolicy, STATGROUP_Tickables);
+}
+
+UWorld* FShooterGarbageCollectionPolicy::GetTickableGameObjectWorld() const
+{
+	return World.Get();
+}
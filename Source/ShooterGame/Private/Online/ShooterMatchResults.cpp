@@ -0,0 +1,444 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterMatchResults.h"
+#include "Player/ShooterPersistentUser.h"
+#include "Online.h"
+#include "OnlineAchievementsInterface.h"
+#include "OnlineEventsInterface.h"
+#include "OnlineStatsInterface.h"
+#include "OnlineSubsystemUtils.h"
+#include "ShooterLeaderboards.h"
+
+int32 CVar_ShooterResults_MaxRetries = 3;
+static FAutoConsoleVariableRef CVarShooterResultsMaxRetries(TEXT("ShooterResults.MaxRetries"), CVar_ShooterResults_MaxRetries, TEXT("How many times a failed match results request is retried before giving up"), ECVF_Default );
+
+float CVar_ShooterResults_RetryDelay = 2.0f;
+static FAutoConsoleVariableRef CVarShooterResultsRetryDelay(TEXT("ShooterResults.RetryDelay"), CVar_ShooterResults_RetryDelay, TEXT("Delay before the first retry of a failed match results request, doubled on each further retry"), ECVF_Default );
+
+float CVar_ShooterResults_RequestTimeout = 30.0f;
+static FAutoConsoleVariableRef CVarShooterResultsRequestTimeout(TEXT("ShooterResults.RequestTimeout"), CVar_ShooterResults_RequestTimeout, TEXT("Match results requests not completed after this many seconds count as failed"), ECVF_Default );
+
+#define  ACH_SOME_KILLS		TEXT("ACH_SOME_KILLS")
+#define  ACH_LOTS_KILLS		TEXT("ACH_LOTS_KILLS")
+#define  ACH_FINISH_MATCH	TEXT("ACH_FINISH_MATCH")
+#define  ACH_LOTS_MATCHES	TEXT("ACH_LOTS_MATCHES")
+#define  ACH_FIRST_WIN		TEXT("ACH_FIRST_WIN")
+#define  ACH_LOTS_WIN		TEXT("ACH_LOTS_WIN")
+#define  ACH_MANY_WIN		TEXT("ACH_MANY_WIN")
+#define  ACH_SHOOT_BULLETS	TEXT("ACH_SHOOT_BULLETS")
+#define  ACH_SHOOT_ROCKETS	TEXT("ACH_SHOOT_ROCKETS")
+#define  ACH_GOOD_SCORE		TEXT("ACH_GOOD_SCORE")
+#define  ACH_GREAT_SCORE	TEXT("ACH_GREAT_SCORE")
+#define  ACH_PLAY_SANCTUARY	TEXT("ACH_PLAY_SANCTUARY")
+#define  ACH_PLAY_HIGHRISE	TEXT("ACH_PLAY_HIGHRISE")
+
+static const int32 SomeKillsCount = 10;
+static const int32 LotsKillsCount = 20;
+static const int32 LotsMatchesCount = 5;
+static const int32 LotsWinsCount = 3;
+static const int32 ManyWinsCount = 5;
+static const int32 LotsBulletsCount = 100;
+static const int32 LotsRocketsCount = 10;
+static const int32 GoodScoreCount = 10;
+static const int32 GreatScoreCount = 15;
+
+namespace
+{
+	/** fills the write object with the progress of every game end achievement, returns the overall game completion percentage */
+	float MakeAchievementsWrite(const FShooterMatchResult& Result, FOnlineAchievementsWrite& WriteObject)
+	{
+		const int32 Matches = Result.TotalWins + Result.TotalLosses;
+
+		float TotalGameAchievement = 0;
+		float CurrentGameAchievement = 0;
+
+		auto AddProgress = [&](const TCHAR* Id, float Percent, bool bCountsTowardsGame)
+		{
+			WriteObject.SetFloatStat(Id, Percent);
+			if (bCountsTowardsGame)
+			{
+				CurrentGameAchievement += FMath::Min(Percent, 100.0f);
+				TotalGameAchievement += 100;
+			}
+		};
+
+		///////////////////////////////////////
+		// Kill achievements
+		if (Result.TotalKills >= 1)
+		{
+			CurrentGameAchievement += 100.0f;
+		}
+		TotalGameAchievement += 100;
+
+		AddProgress(ACH_SOME_KILLS, FMath::RoundToFloat(((float)Result.TotalKills / (float)SomeKillsCount) * 100.0f), true);
+		AddProgress(ACH_LOTS_KILLS, FMath::RoundToFloat(((float)Result.TotalKills / (float)LotsKillsCount) * 100.0f), true);
+
+		///////////////////////////////////////
+		// Match Achievements
+		AddProgress(ACH_FINISH_MATCH, 100.0f, true);
+		AddProgress(ACH_LOTS_MATCHES, FMath::RoundToFloat(((float)Matches / (float)LotsMatchesCount) * 100.0f), true);
+
+		///////////////////////////////////////
+		// Win Achievements
+		if (Result.TotalWins >= 1)
+		{
+			WriteObject.SetFloatStat(ACH_FIRST_WIN, 100.0f);
+			CurrentGameAchievement += 100.0f;
+		}
+		TotalGameAchievement += 100;
+
+		AddProgress(ACH_LOTS_WIN, FMath::RoundToInt(((float)Result.TotalWins / (float)LotsWinsCount) * 100.0f), true);
+		AddProgress(ACH_MANY_WIN, FMath::RoundToInt(((float)Result.TotalWins / (float)ManyWinsCount) * 100.0f), true);
+
+		///////////////////////////////////////
+		// Ammo Achievements
+		AddProgress(ACH_SHOOT_BULLETS, FMath::RoundToFloat(((float)Result.TotalBulletsFired / (float)LotsBulletsCount) * 100.0f), true);
+		AddProgress(ACH_SHOOT_ROCKETS, FMath::RoundToFloat(((float)Result.TotalRocketsFired / (float)LotsRocketsCount) * 100.0f), true);
+
+		///////////////////////////////////////
+		// Score Achievements
+		AddProgress(ACH_GOOD_SCORE, FMath::RoundToFloat(((float)Result.Score / (float)GoodScoreCount) * 100.0f), false);
+		AddProgress(ACH_GREAT_SCORE, FMath::RoundToFloat(((float)Result.Score / (float)GreatScoreCount) * 100.0f), false);
+
+		///////////////////////////////////////
+		// Map Play Achievements
+		if (Result.MapName.Find(TEXT("Highrise")) != -1)
+		{
+			WriteObject.SetFloatStat(ACH_PLAY_HIGHRISE, 100.0f);
+		}
+		else if (Result.MapName.Find(TEXT("Sanctuary")) != -1)
+		{
+			WriteObject.SetFloatStat(ACH_PLAY_SANCTUARY, 100.0f);
+		}
+
+		return FMath::RoundToFloat((CurrentGameAchievement / TotalGameAchievement) * 100.0f);
+	}
+}
+
+FShooterMatchResultsPipeline::FShooterMatchResultsPipeline(UGameInstance* InGameInstance)
+	: GameInstance(InGameInstance)
+	, bRequestInFlight(false)
+	, RequestId(0)
+	, RequestTimeout(0.0)
+	, NextStageTime(0.0)
+{
+}
+
+FShooterMatchResultsPipeline::~FShooterMatchResultsPipeline()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
+
+	ClearLeaderboardFlushDelegate();
+
+	if (PendingResults.Num() > 0)
+	{
+		UE_LOG(LogOnline, Warning, TEXT("Match results: %d results were not fully posted before shutdown."), PendingResults.Num());
+	}
+}
+
+void FShooterMatchResultsPipeline::Initialize()
+{
+	TickDelegateHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FShooterMatchResultsPipeline::Tick));
+}
+
+UWorld* FShooterMatchResultsPipeline::GetWorld() const
+{
+	return GameInstance.IsValid() ? GameInstance->GetWorld() : nullptr;
+}
+
+void FShooterMatchResultsPipeline::Submit(const TSharedRef<const FShooterMatchResult>& Result, UShooterPersistentUser* PersistentUser)
+{
+	PendingResults.Emplace(Result, PersistentUser);
+}
+
+bool FShooterMatchResultsPipeline::IsPosting(int32 ControllerId) const
+{
+	for (const FPendingResult& Pending : PendingResults)
+	{
+		if (Pending.Result->ControllerId == ControllerId)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FShooterMatchResultsPipeline::Tick(float DeltaSeconds)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(FShooterMatchResultsPipeline_Tick);
+
+	const double Now = FPlatformTime::Seconds();
+	if (bRequestInFlight)
+	{
+		if (Now > RequestTimeout)
+		{
+			UE_LOG(LogOnline, Warning, TEXT("Match results: request timed out."));
+
+			// the request may still complete, its callback must not touch the retry
+			RequestId++;
+			ClearLeaderboardFlushDelegate();
+			for (FPendingResult& Pending : PendingResults)
+			{
+				Pending.bInLeaderboardBatch = false;
+			}
+
+			OnRequestComplete(false);
+		}
+		return true;
+	}
+
+	if (PendingResults.Num() == 0 || Now < NextStageTime)
+	{
+		return true;
+	}
+
+	// one step per frame
+	FPendingResult& Pending = PendingResults[0];
+	if (Pending.Stage == EShooterMatchResultStage::Done)
+	{
+		const int32 ControllerId = Pending.Result->ControllerId;
+		const bool bWasSuccessful = !Pending.bFailed;
+		PendingResults.RemoveAt(0);
+
+		OnResultsPosted.Broadcast(ControllerId, bWasSuccessful);
+		return true;
+	}
+
+	// flagged before issuing the request, some online subsystems complete it right away
+	bRequestInFlight = true;
+	RequestId++;
+	RequestTimeout = Now + CVar_ShooterResults_RequestTimeout;
+	if (!RunStage(Pending))
+	{
+		bRequestInFlight = false;
+		AdvanceStage(Pending);
+	}
+
+	return true;
+}
+
+bool FShooterMatchResultsPipeline::RunStage(FPendingResult& Pending)
+{
+	const FShooterMatchResult& Result = *Pending.Result;
+	switch (Pending.Stage)
+	{
+		case EShooterMatchResultStage::Save:
+			if (Pending.PersistentUser.IsValid())
+			{
+				Pending.PersistentUser->SaveIfDirty();
+			}
+			return false;
+
+		case EShooterMatchResultStage::Achievements:
+			return WriteAchievements(Result);
+
+		case EShooterMatchResultStage::Leaderboards:
+			return WriteLeaderboards();
+
+		case EShooterMatchResultStage::Stats:
+			return WriteStats(Result);
+
+		case EShooterMatchResultStage::Events:
+			SendProgressEvent(Result);
+			return false;
+
+		default:
+			return false;
+	}
+}
+
+bool FShooterMatchResultsPipeline::WriteAchievements(const FShooterMatchResult& Result)
+{
+	IOnlineAchievementsPtr Achievements = Online::GetAchievementsInterface(GetWorld());
+	if (!Achievements.IsValid() || !Result.UserId.IsValid())
+	{
+		return false;
+	}
+
+	// all achievements in a single write, instead of one request per achievement
+	FOnlineAchievementsWriteRef WriteObject = MakeShareable(new FOnlineAchievementsWrite());
+	MakeAchievementsWrite(Result, *WriteObject);
+
+	Achievements->WriteAchievements(*Result.UserId, WriteObject, FOnAchievementsWrittenDelegate::CreateSP(this, &FShooterMatchResultsPipeline::OnAchievementsWritten, RequestId));
+	return true;
+}
+
+bool FShooterMatchResultsPipeline::WriteLeaderboards()
+{
+	// update leaderboards - note this does not respect existing scores and overwrites them. We would first need to read the leaderboards if we wanted to do that.
+	IOnlineLeaderboardsPtr Leaderboards = Online::GetLeaderboardsInterface(GetWorld());
+	if (!Leaderboards.IsValid())
+	{
+		return false;
+	}
+
+	// write every queued result not posted yet, so split screen players share one flush
+	int32 NumWritten = 0;
+	for (FPendingResult& Pending : PendingResults)
+	{
+		const FShooterMatchResult& Result = *Pending.Result;
+		if (Pending.bLeaderboardsWritten || !Result.UserId.IsValid())
+		{
+			continue;
+		}
+
+		FShooterAllTimeMatchResultsWrite ResultsWriteObject;
+		ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_SCORE, Result.LeaderboardKills);
+		ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_KILLS, Result.LeaderboardKills);
+		ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_DEATHS, Result.LeaderboardDeaths);
+		ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_MATCHESPLAYED, Result.LeaderboardMatchesPlayed);
+
+		// the call will copy the user id and write object to its own memory
+		if (Leaderboards->WriteLeaderboards(Result.SessionName, *Result.UserId, ResultsWriteObject))
+		{
+			Pending.bInLeaderboardBatch = true;
+			NumWritten++;
+		}
+	}
+
+	if (NumWritten == 0)
+	{
+		return false;
+	}
+
+	// a retry binds again, only the flush of this attempt may complete it
+	ClearLeaderboardFlushDelegate();
+	LeaderboardFlushDelegateHandle = Leaderboards->AddOnLeaderboardFlushCompleteDelegate_Handle(FOnLeaderboardFlushCompleteDelegate::CreateSP(this, &FShooterMatchResultsPipeline::OnLeaderboardFlushComplete, RequestId));
+	if (!Leaderboards->FlushLeaderboards(TEXT("SHOOTERGAME")))
+	{
+		OnLeaderboardFlushComplete(TEXT("SHOOTERGAME"), false, RequestId);
+	}
+	return true;
+}
+
+bool FShooterMatchResultsPipeline::WriteStats(const FShooterMatchResult& Result)
+{
+	IOnlineStatsPtr Stats = Online::GetStatsInterface(GetWorld());
+	if (!Stats.IsValid() || !Result.UserId.IsValid())
+	{
+		return false;
+	}
+
+	TArray<FOnlineStatsUserUpdatedStats> UpdatedUserStats;
+
+	FOnlineStatsUserUpdatedStats& UpdatedStats = UpdatedUserStats.Emplace_GetRef( Result.UserId.ToSharedRef() );
+	UpdatedStats.Stats.Add( TEXT("Kills"), FOnlineStatUpdate( Result.Kills, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+	UpdatedStats.Stats.Add( TEXT("Deaths"), FOnlineStatUpdate( Result.Deaths, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+	UpdatedStats.Stats.Add( TEXT("RoundsPlayed"), FOnlineStatUpdate( 1, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+	if (Result.bIsWinner)
+	{
+		UpdatedStats.Stats.Add( TEXT("RoundsWon"), FOnlineStatUpdate( 1, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+	}
+
+	Stats->UpdateStats( Result.UserId.ToSharedRef(), UpdatedUserStats, FOnlineStatsUpdateStatsComplete::CreateSP(this, &FShooterMatchResultsPipeline::OnStatsUpdated, RequestId) );
+	return true;
+}
+
+void FShooterMatchResultsPipeline::SendProgressEvent(const FShooterMatchResult& Result) const
+{
+	const IOnlineEventsPtr Events = Online::GetEventsInterface(GetWorld());
+	if (Events.IsValid() && Result.UserId.IsValid())
+	{
+		FOnlineAchievementsWrite WriteObject;
+		const float GamePct = MakeAchievementsWrite(Result, WriteObject);
+
+		FOnlineEventParms Params;
+		Params.Add( TEXT( "CompletionPercent" ), FVariantData( GamePct ) );
+		Events->TriggerEvent(*Result.UserId, TEXT("GameProgress"), Params);
+	}
+}
+
+void FShooterMatchResultsPipeline::OnAchievementsWritten(const FUniqueNetId& PlayerId, bool bWasSuccessful, int32 InRequestId)
+{
+	if (InRequestId == RequestId && PendingResults.Num() > 0 && PendingResults[0].Stage == EShooterMatchResultStage::Achievements)
+	{
+		OnRequestComplete(bWasSuccessful);
+	}
+}
+
+void FShooterMatchResultsPipeline::OnLeaderboardFlushComplete(FName SessionName, bool bWasSuccessful, int32 InRequestId)
+{
+	if (InRequestId != RequestId)
+	{
+		return;
+	}
+
+	ClearLeaderboardFlushDelegate();
+
+	for (FPendingResult& Pending : PendingResults)
+	{
+		if (Pending.bInLeaderboardBatch)
+		{
+			Pending.bInLeaderboardBatch = false;
+			Pending.bLeaderboardsWritten = bWasSuccessful;
+		}
+	}
+
+	if (PendingResults.Num() > 0 && PendingResults[0].Stage == EShooterMatchResultStage::Leaderboards)
+	{
+		OnRequestComplete(bWasSuccessful);
+	}
+}
+
+void FShooterMatchResultsPipeline::OnStatsUpdated(const FOnlineError& ResultState, int32 InRequestId)
+{
+	if (InRequestId == RequestId && PendingResults.Num() > 0 && PendingResults[0].Stage == EShooterMatchResultStage::Stats)
+	{
+		OnRequestComplete(ResultState.WasSuccessful());
+	}
+}
+
+void FShooterMatchResultsPipeline::ClearLeaderboardFlushDelegate()
+{
+	if (LeaderboardFlushDelegateHandle.IsValid())
+	{
+		IOnlineLeaderboardsPtr Leaderboards = Online::GetLeaderboardsInterface(GetWorld());
+		if (Leaderboards.IsValid())
+		{
+			Leaderboards->ClearOnLeaderboardFlushCompleteDelegate_Handle(LeaderboardFlushDelegateHandle);
+		}
+		LeaderboardFlushDelegateHandle.Reset();
+	}
+}
+
+void FShooterMatchResultsPipeline::OnRequestComplete(bool bWasSuccessful)
+{
+	if (!bRequestInFlight || PendingResults.Num() == 0)
+	{
+		return;
+	}
+
+	bRequestInFlight = false;
+
+	FPendingResult& Pending = PendingResults[0];
+	if (bWasSuccessful)
+	{
+		AdvanceStage(Pending);
+	}
+	else if (++Pending.Attempts <= CVar_ShooterResults_MaxRetries)
+	{
+		const float RetryDelay = CVar_ShooterResults_RetryDelay * (1 << FMath::Min(Pending.Attempts - 1, 8));
+		NextStageTime = FPlatformTime::Seconds() + RetryDelay;
+		UE_LOG(LogOnline, Log, TEXT("Match results: step %d failed, retrying in %.1f s (attempt %d/%d)."), (int32)Pending.Stage, RetryDelay, Pending.Attempts, CVar_ShooterResults_MaxRetries);
+	}
+	else
+	{
+		UE_LOG(LogOnline, Warning, TEXT("Match results: step %d failed, giving up."), (int32)Pending.Stage);
+		Pending.bFailed = true;
+		AdvanceStage(Pending);
+	}
+}
+
+void FShooterMatchResultsPipeline::AdvanceStage(FPendingResult& Pending)
+{
+	Pending.Stage = (EShooterMatchResultStage::Type)(Pending.Stage + 1);
+	Pending.Attempts = 0;
+
+	// already posted with an earlier result's batch
+	if (Pending.Stage == EShooterMatchResultStage::Leaderboards && Pending.bLeaderboardsWritten)
+	{
+		Pending.Stage = EShooterMatchResultStage::Stats;
+	}
+}
@@ -0,0 +1,228 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterReplayIndex.h"
+#include "NetworkReplayStreaming.h"
+#include "Async/Async.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	/** bump when the layout of FShooterReplayInfo changes, older index files are then rebuilt from the streamer */
+	const int32 ReplayIndexFileVersion = 1;
+}
+
+FArchive& operator<<(FArchive& Ar, FShooterReplayInfo& Info)
+{
+	Ar << Info.Name;
+	Ar << Info.FriendlyName;
+	Ar << Info.Timestamp;
+	Ar << Info.SizeInBytes;
+	Ar << Info.LengthInMS;
+	Ar << Info.MapName;
+	Ar << Info.NetworkVersion;
+	Ar << Info.NumViewers;
+	Ar << Info.bIsLive;
+	return Ar;
+}
+
+FShooterReplayIndex::FShooterReplayIndex()
+	: Revision(0)
+{
+}
+
+FShooterReplayIndex::~FShooterReplayIndex()
+{
+	if (PendingSave.IsValid())
+	{
+		PendingSave.Wait();
+	}
+}
+
+FString FShooterReplayIndex::GetIndexFilename()
+{
+	// next to the replays of the local file streamer
+	return FPaths::ProjectSavedDir() / TEXT("Demos") / TEXT("ShooterReplayIndex.dat");
+}
+
+void FShooterReplayIndex::Load()
+{
+	if (PendingLoad.IsValid())
+	{
+		return;
+	}
+
+	PendingLoad = Async(EAsyncExecution::ThreadPool, []()
+	{
+		TArray<FShooterReplayInfo> LoadedReplays;
+
+		TArray<uint8> Data;
+		if (FFileHelper::LoadFileToArray(Data, *GetIndexFilename(), FILEREAD_Silent))
+		{
+			FMemoryReader Ar(Data);
+
+			int32 FileVersion = 0;
+			Ar << FileVersion;
+			if (FileVersion == ReplayIndexFileVersion)
+			{
+				Ar << LoadedReplays;
+			}
+
+			if (Ar.IsError() || FileVersion != ReplayIndexFileVersion)
+			{
+				LoadedReplays.Reset();
+			}
+		}
+
+		return LoadedReplays;
+	});
+}
+
+void FShooterReplayIndex::WaitForLoad()
+{
+	if (PendingLoad.IsValid())
+	{
+		Replays = PendingLoad.Get();
+		PendingLoad = TFuture<TArray<FShooterReplayInfo>>();
+		Revision++;
+	}
+}
+
+const TArray<FShooterReplayInfo>& FShooterReplayIndex::GetReplays()
+{
+	WaitForLoad();
+	return Replays;
+}
+
+void FShooterReplayIndex::AddReplay(const FShooterReplayInfo& Info)
+{
+	WaitForLoad();
+
+	FShooterReplayInfo* Existing = Replays.FindByPredicate([&Info](const FShooterReplayInfo& Replay) { return Replay.Name == Info.Name; });
+	if (Existing)
+	{
+		*Existing = Info;
+	}
+	else
+	{
+		Replays.Add(Info);
+	}
+
+	OnReplaysChanged();
+}
+
+void FShooterReplayIndex::RemoveReplay(const FString& Name)
+{
+	WaitForLoad();
+
+	if (Replays.RemoveAll([&Name](const FShooterReplayInfo& Replay) { return Replay.Name == Name; }) > 0)
+	{
+		OnReplaysChanged();
+	}
+}
+
+bool FShooterReplayIndex::Reconcile(const FNetworkReplayVersion& EnumerateVersion, const TArray<FNetworkReplayStreamInfo>& FoundStreams)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(FShooterReplayIndex_Reconcile);
+
+	WaitForLoad();
+
+	// enumerating without a version filter lists every replay, otherwise only the ones of that version
+	const bool bAllVersions = EnumerateVersion.NetworkVersion == 0;
+
+	TMap<FString, int32> IndexByName;
+	IndexByName.Reserve(Replays.Num());
+	for (int32 i = 0; i < Replays.Num(); i++)
+	{
+		IndexByName.Add(Replays[i].Name, i);
+	}
+
+	bool bChanged = false;
+	TBitArray<> Found(false, Replays.Num());
+
+	for (const FNetworkReplayStreamInfo& StreamInfo : FoundStreams)
+	{
+		const int32* ExistingIndex = IndexByName.Find(StreamInfo.Name);
+		if (ExistingIndex)
+		{
+			Found[*ExistingIndex] = true;
+		}
+
+		FShooterReplayInfo& Info = ExistingIndex ? Replays[*ExistingIndex] : Replays.AddDefaulted_GetRef();
+		const uint32 NetworkVersion = bAllVersions ? Info.NetworkVersion : EnumerateVersion.NetworkVersion;
+
+		if (ExistingIndex == nullptr || Info.FriendlyName != StreamInfo.FriendlyName || Info.Timestamp != StreamInfo.Timestamp || Info.SizeInBytes != StreamInfo.SizeInBytes ||
+			Info.LengthInMS != StreamInfo.LengthInMS || Info.NumViewers != StreamInfo.NumViewers || Info.bIsLive != StreamInfo.bIsLive || Info.NetworkVersion != NetworkVersion)
+		{
+			Info.Name = StreamInfo.Name;
+			Info.FriendlyName = StreamInfo.FriendlyName;
+			Info.Timestamp = StreamInfo.Timestamp;
+			Info.SizeInBytes = StreamInfo.SizeInBytes;
+			Info.LengthInMS = StreamInfo.LengthInMS;
+			Info.NumViewers = StreamInfo.NumViewers;
+			Info.bIsLive = StreamInfo.bIsLive;
+			Info.NetworkVersion = NetworkVersion;
+			bChanged = true;
+		}
+	}
+
+	// replays we know about but the streamer didn't list, new ones were appended past Found
+	for (int32 i = Found.Num() - 1; i >= 0; i--)
+	{
+		if (Found[i])
+		{
+			continue;
+		}
+
+		if (bAllVersions)
+		{
+			// deleted behind our back
+			Replays.RemoveAt(i);
+			bChanged = true;
+		}
+		else if (Replays[i].NetworkVersion == EnumerateVersion.NetworkVersion)
+		{
+			// another version or deleted, the next unfiltered enumeration tells
+			Replays[i].NetworkVersion = 0;
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		OnReplaysChanged();
+	}
+
+	return bChanged;
+}
+
+void FShooterReplayIndex::OnReplaysChanged()
+{
+	Replays.Sort([](const FShooterReplayInfo& A, const FShooterReplayInfo& B)
+	{
+		return A.Timestamp > B.Timestamp;
+	});
+
+	Revision++;
+
+	TArray<uint8> Data;
+	FMemoryWriter Ar(Data);
+	int32 FileVersion = ReplayIndexFileVersion;
+	Ar << FileVersion;
+	Ar << Replays;
+
+	// the file is tiny, keep writes in order by waiting for the previous one
+	if (PendingSave.IsValid())
+	{
+		PendingSave.Wait();
+	}
+
+	PendingSave = Async(EAsyncExecution::ThreadPool, [Data = MoveTemp(Data)]()
+	{
+		// write next to the index and swap it in, so an interrupted write never leaves a truncated index behind
+		const FString Filename = GetIndexFilename();
+		const FString TempFilename = Filename + TEXT(".tmp");
+		return FFileHelper::SaveArrayToFile(Data, *TempFilename) && IFileManager::Get().Move(*Filename, *TempFilename, true, true);
+	});
+}
@@ -40,6 +40,10 @@
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
 *		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection.
 *		
+*		UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection
+*		Connection specific node that gathers nothing. Every few frames it rescores the shooter characters for its connection (speed, firing, distance to and angle from the viewer)
+*		and sets their per connection replication period accordingly, scaling the rates down when they would go over the connection's pawn bandwidth target.
+*		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
 *		
@@ -58,6 +62,19 @@
 *		Making something always relevant to connection: You will need to modify UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection. You will also want 
 *		to make sure the actor does not get put in one of the other nodes. The safest way to do this is by setting its EClassRepNodeMapping to NotRouted in UShooterReplicationGraph::InitGlobalActorClassSettings.
 *
+*	Class Routing Cache
+*	
+*		Routing classes looks at every loaded UClass and its CDO, which is a good part of a server's boot. A server started
+*		with -WriteRepGraphClassCache saves the routing it found to Saved/RepGraph/ShooterClassRouting.json, and the next
+*		boots of the same build route the classes listed there instead. Servers never write the cache on their own. To ship
+*		it with the content, run the packaged server once on the shipped map with -WriteRepGraphClassCache, copy the file to
+*		Content/RepGraph and package again: Content/RepGraph is staged as is and is checked before Saved. A new build or
+*		network version invalidates the cache, so it has to be regenerated for every build.
+*		The cache is only used if it was written by the same build and network version, its checksum matches and every
+*		listed class that is loaded still has the replication settings it was saved with, anything else falls back to
+*		looking at all classes. Classes missing from the cache, and classes loaded later, are routed when their first actor
+*		is added.
+*	
 *	How To Debug
 *	
 *		Its a good idea to just disable rep graph to see if your problem is specific to this system or just general replication/game play problem.
@@ -97,12 +114,20 @@
 #include "Online/ShooterPlayerState.h"
 #include "Weapons/ShooterWeapon.h"
 #include "Pickups/ShooterPickup.h"
+#include "Online/ShooterServerTelemetry.h"
+#include "Misc/FileHelper.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/NetworkVersion.h"
+#include "Serialization/JsonSerializer.h"
 
 DEFINE_LOG_CATEGORY( LogShooterReplicationGraph );
 
 float CVar_ShooterRepGraph_DestructionInfoMaxDist = 30000.f;
 static FAutoConsoleVariableRef CVarShooterRepGraphDestructMaxDist(TEXT("ShooterRepGraph.DestructInfo.MaxDist"), CVar_ShooterRepGraph_DestructionInfoMaxDist, TEXT("Max distance (not squared) to rep destruct infos at"), ECVF_Default );
 
+int32 CVar_ShooterRepGraph_ClassCache = 1;
+static FAutoConsoleVariableRef CVarShooterRepGraphClassCache(TEXT("ShooterRepGraph.ClassCache"), CVar_ShooterRepGraph_ClassCache, TEXT("If 1, classes are routed from the class routing cache when it matches this build"), ECVF_Default );
+
 int32 CVar_ShooterRepGraph_DisplayClientLevelStreaming = 0;
 static FAutoConsoleVariableRef CVarShooterRepGraphDisplayClientLevelStreaming(TEXT("ShooterRepGraph.DisplayClientLevelStreaming"), CVar_ShooterRepGraph_DisplayClientLevelStreaming, TEXT(""), ECVF_Default );
 
@@ -124,6 +149,45 @@ static FAutoConsoleVariableRef CVarShooterRepDynamicActorFrequencyBuckets(TEXT("
 int32 CVar_ShooterRepGraph_DisableSpatialRebuilds = 1;
 static FAutoConsoleVariableRef CVarShooterRepDisableSpatialRebuilds(TEXT("ShooterRepGraph.DisableSpatialRebuilds"), CVar_ShooterRepGraph_DisableSpatialRebuilds, TEXT(""), ECVF_Default );
 
+int32 CVar_ShooterRepGraph_AdaptivePawnRate_Enabled = 1;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateEnabled(TEXT("ShooterRepGraph.AdaptivePawnRate.Enabled"), CVar_ShooterRepGraph_AdaptivePawnRate_Enabled, TEXT("Adapt how often each pawn replicates to each connection"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptivePawnRate_MinHz = 5.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateMinHz(TEXT("ShooterRepGraph.AdaptivePawnRate.MinHz"), CVar_ShooterRepGraph_AdaptivePawnRate_MinHz, TEXT("Update rate of idle, distant pawns"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptivePawnRate_MaxHz = 30.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateMaxHz(TEXT("ShooterRepGraph.AdaptivePawnRate.MaxHz"), CVar_ShooterRepGraph_AdaptivePawnRate_MaxHz, TEXT("Update rate of fast moving, firing or nearby pawns in view"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptivePawnRate_FastSpeed = 600.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateFastSpeed(TEXT("ShooterRepGraph.AdaptivePawnRate.FastSpeed"), CVar_ShooterRepGraph_AdaptivePawnRate_FastSpeed, TEXT("Speed at which a pawn gets the max update rate"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptivePawnRate_NearDist = 2000.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateNearDist(TEXT("ShooterRepGraph.AdaptivePawnRate.NearDist"), CVar_ShooterRepGraph_AdaptivePawnRate_NearDist, TEXT("Pawns in view closer than this get the max update rate"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptivePawnRate_FarDist = 10000.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateFarDist(TEXT("ShooterRepGraph.AdaptivePawnRate.FarDist"), CVar_ShooterRepGraph_AdaptivePawnRate_FarDist, TEXT("Idle pawns further than this get the min update rate"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptivePawnRate_ViewConeDegrees = 100.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateViewConeDegrees(TEXT("ShooterRepGraph.AdaptivePawnRate.ViewConeDegrees"), CVar_ShooterRepGraph_AdaptivePawnRate_ViewConeDegrees, TEXT("Pawns within this cone around the view direction are in view"), ECVF_Default );
+
+// Size of a moving pawn's update: quantized location and velocity, byte rotation, view pitch, property handles and the
+// bunch header add up to about 32 bytes, rounded up for the odd update carrying more than movement. Check it against the
+// average ShooterCharacter update of a netprofile capture when pawn properties change.
+float CVar_ShooterRepGraph_AdaptivePawnRate_BytesPerUpdate = 48.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateBytesPerUpdate(TEXT("ShooterRepGraph.AdaptivePawnRate.BytesPerUpdate"), CVar_ShooterRepGraph_AdaptivePawnRate_BytesPerUpdate, TEXT("Estimated bytes of a pawn update"), ECVF_Default );
+
+// Twice what 64 pawns cost at MinHz (64 * 5 Hz * 48 bytes). The client rates of the net drivers stay at the engine's
+// defaults, so on most connections the share of the connection's net speed below is the budget that applies.
+float CVar_ShooterRepGraph_AdaptivePawnRate_BudgetBytesPerSecond = 32000.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateBudgetBytesPerSecond(TEXT("ShooterRepGraph.AdaptivePawnRate.BudgetBytesPerSecond"), CVar_ShooterRepGraph_AdaptivePawnRate_BudgetBytesPerSecond, TEXT("Target for the pawn updates of one connection, 0 for no target"), ECVF_Default );
+
+// Pawns get most of what the connection may send, the rest is left to weapons, projectiles, player states and the like.
+float CVar_ShooterRepGraph_AdaptivePawnRate_NetSpeedFraction = 0.6f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateNetSpeedFraction(TEXT("ShooterRepGraph.AdaptivePawnRate.NetSpeedFraction"), CVar_ShooterRepGraph_AdaptivePawnRate_NetSpeedFraction, TEXT("Share of the connection's net speed the pawn budget is capped at, 0 for no cap"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_AdaptivePawnRate_UpdateFrames = 6;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePawnRateUpdateFrames(TEXT("ShooterRepGraph.AdaptivePawnRate.UpdateFrames"), CVar_ShooterRepGraph_AdaptivePawnRate_UpdateFrames, TEXT("Replication frames between two updates of the pawn rates of a connection"), ECVF_Default );
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -137,7 +201,7 @@ void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool b
 	if (bSpatialize)
 	{
 		Info.SetCullDistanceSquared(CDO->NetCullDistanceSquared);
-		UE_LOG(LogShooterReplicationGraph, Log, TEXT("Setting cull distance for %s to %f (%f)"), *Class->GetName(), Info.GetCullDistanceSquared(), Info.GetCullDistance());
+		UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Setting cull distance for %s to %f (%f)"), *Class->GetName(), Info.GetCullDistanceSquared(), Info.GetCullDistance());
 	}
 
 	Info.ReplicationPeriodFrame = FMath::Max<uint32>( (uint32)FMath::RoundToFloat(ServerMaxTickRate / CDO->NetUpdateFrequency), 1);
@@ -148,7 +212,14 @@ void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool b
 		NativeClass = NativeClass->GetSuperClass();
 	}
 
-	UE_LOG(LogShooterReplicationGraph, Log, TEXT("Setting replication period for %s (%s) to %d frames (%.2f)"), *Class->GetName(), *NativeClass->GetName(), Info.ReplicationPeriodFrame, CDO->NetUpdateFrequency);
+	UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Setting replication period for %s (%s) to %d frames (%.2f)"), *Class->GetName(), *NativeClass->GetName(), Info.ReplicationPeriodFrame, CDO->NetUpdateFrequency);
+}
+
+int32 UShooterReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	// gathering, prioritizing and sending for every connection
+	FShooterServerTimingScope TimingScope(EShooterServerTiming::Replication);
+	return Super::ServerReplicateActors(DeltaSeconds);
 }
 
 void UShooterReplicationGraph::ResetGameWorldState()
@@ -156,6 +227,7 @@ void UShooterReplicationGraph::ResetGameWorldState()
 	Super::ResetGameWorldState();
 
 	AlwaysRelevantStreamingLevelActors.Empty();
+	ShooterCharacters.Reset();
 
 	for (UNetReplicationGraphConnection* ConnManager : Connections)
 	{
@@ -203,78 +275,30 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 
 	TArray<UClass*> AllReplicatedClasses;
 
-	for (TObjectIterator<UClass> It; It; ++It)
+	const double RoutingStartTime = FPlatformTime::Seconds();
+	const bool bFromCache = CVar_ShooterRepGraph_ClassCache && LoadClassRoutingCache(AllReplicatedClasses);
+	if (!bFromCache)
 	{
-		UClass* Class = *It;
-		AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
-		if (!ActorCDO || !ActorCDO->GetIsReplicated())
-		{
-			continue;
-		}
-
-		// Skip SKEL and REINST classes.
-		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
-		{
-			continue;
-		}
-
-		// --------------------------------------------------------------------
-		// This is a replicated class. Save this off for the second pass below
-		// --------------------------------------------------------------------
-		
-		AllReplicatedClasses.Add(Class);
+		BuildClassRouting(AllReplicatedClasses);
 
-		// Skip if already in the map (added explicitly)
-		if (ClassRepNodePolicies.Contains(Class, false))
+		if (CVar_ShooterRepGraph_ClassCache && FParse::Param(FCommandLine::Get(), TEXT("WriteRepGraphClassCache")))
 		{
-			continue;
+			SaveClassRoutingCache(AllReplicatedClasses);
 		}
-		
-		auto ShouldSpatialize = [](const AActor* CDO)
-		{
-			return CDO->GetIsReplicated() && (!(CDO->bAlwaysRelevant || CDO->bOnlyRelevantToOwner || CDO->bNetUseOwnerRelevancy));
-		};
-
-		auto GetLegacyDebugStr = [](const AActor* CDO)
-		{
-			return FString::Printf(TEXT("%s [%d/%d/%d]"), *CDO->GetClass()->GetName(), CDO->bAlwaysRelevant, CDO->bOnlyRelevantToOwner, CDO->bNetUseOwnerRelevancy);
-		};
-
-		// Only handle this class if it differs from its super. There is no need to put every child class explicitly in the graph class mapping
-		UClass* SuperClass = Class->GetSuperClass();
-		if (AActor* SuperCDO = Cast<AActor>(SuperClass->GetDefaultObject()))
-		{
-			if (	SuperCDO->GetIsReplicated() == ActorCDO->GetIsReplicated() 
-				&&	SuperCDO->bAlwaysRelevant == ActorCDO->bAlwaysRelevant
-				&&	SuperCDO->bOnlyRelevantToOwner == ActorCDO->bOnlyRelevantToOwner
-				&&	SuperCDO->bNetUseOwnerRelevancy == ActorCDO->bNetUseOwnerRelevancy
-				)
-			{
-				continue;
-			}
+	}
 
-			if (ShouldSpatialize(ActorCDO) == false && ShouldSpatialize(SuperCDO) == true)
-			{
-				UE_LOG(LogShooterReplicationGraph, Log, TEXT("Adding %s to NonSpatializedChildClasses. (Parent: %s)"), *GetLegacyDebugStr(ActorCDO), *GetLegacyDebugStr(SuperCDO));
-				NonSpatializedChildClasses.Add(Class);
-			}
-		}
-			
-		if (ShouldSpatialize(ActorCDO))
-		{
-			AddInfo(Class, EClassRepNodeMapping::Spatialize_Dynamic);
-		}
-		else if (ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner)
-		{
-			AddInfo(Class, EClassRepNodeMapping::RelevantAllConnections);
-		}
+	for (UClass* ReplicatedClass : AllReplicatedClasses)
+	{
+		RoutedClasses.Add(ReplicatedClass);
 	}
 
+	UE_LOG(LogShooterReplicationGraph, Display, TEXT("Routed %d replicated classes %s in %.1f ms."), AllReplicatedClasses.Num(), bFromCache ? TEXT("from the class cache") : TEXT("by looking at all classes"), (FPlatformTime::Seconds() - RoutingStartTime) * 1000.0);
+
 	// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 	// Setup FClassReplicationInfo. This is essentially the per class replication settings. Some we set explicitly, the rest we are setting via looking at the legacy settings on AActor.
 	// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 	
-	TArray<UClass*> ExplicitlySetClasses;
+	ExplicitlySetClasses.Reset();
 	auto SetClassInfo = [&](UClass* Class, const FClassReplicationInfo& Info) { GlobalActorReplicationInfoMap.SetClassInfo(Class, Info); ExplicitlySetClasses.Add(Class); };
 
 	FClassReplicationInfo PawnClassRepInfo;
@@ -294,47 +318,40 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	// Set FClassReplicationInfo based on legacy settings from all replicated classes
 	for (UClass* ReplicatedClass : AllReplicatedClasses)
 	{
-		if (ExplicitlySetClasses.FindByPredicate([&](const UClass* SetClass) { return ReplicatedClass->IsChildOf(SetClass); }) != nullptr)
-		{
-			continue;
-		}
-
-		const bool bClassIsSpatialized = IsSpatialized(ClassRepNodePolicies.GetChecked(ReplicatedClass));
-
-		FClassReplicationInfo ClassInfo;
-		InitClassReplicationInfo(ClassInfo, ReplicatedClass, bClassIsSpatialized, NetDriver->NetServerMaxTickRate);
-		GlobalActorReplicationInfoMap.SetClassInfo( ReplicatedClass, ClassInfo );
+		InitClassSettings(ReplicatedClass);
 	}
 
 
-	// Print out what we came up with
-	UE_LOG(LogShooterReplicationGraph, Log, TEXT(""));
-	UE_LOG(LogShooterReplicationGraph, Log, TEXT("Class Routing Map: "));
-	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
-	for (auto ClassMapIt = ClassRepNodePolicies.CreateIterator(); ClassMapIt; ++ClassMapIt)
-	{		
-		UClass* Class = CastChecked<UClass>(ClassMapIt.Key().ResolveObjectPtr());
-		const EClassRepNodeMapping Mapping = ClassMapIt.Value();
+	// Print out what we came up with, a line per class is too much for every server boot. ShooterRepGraph.PrintRouting prints the routing on demand.
+	if (UE_LOG_ACTIVE(LogShooterReplicationGraph, Verbose))
+	{
+		UE_LOG(LogShooterReplicationGraph, Verbose, TEXT(""));
+		UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Class Routing Map: "));
+		UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
+		for (auto ClassMapIt = ClassRepNodePolicies.CreateIterator(); ClassMapIt; ++ClassMapIt)
+		{		
+			UClass* Class = CastChecked<UClass>(ClassMapIt.Key().ResolveObjectPtr());
+			const EClassRepNodeMapping Mapping = ClassMapIt.Value();
+
+			// Only print if different than native class
+			UClass* ParentNativeClass = GetParentNativeClass(Class);
+			const EClassRepNodeMapping* ParentMapping = ClassRepNodePolicies.Get(ParentNativeClass);
+			if (ParentMapping && Class != ParentNativeClass && Mapping == *ParentMapping)
+			{
+				continue;
+			}
 
-		// Only print if different than native class
-		UClass* ParentNativeClass = GetParentNativeClass(Class);
-		const EClassRepNodeMapping* ParentMapping = ClassRepNodePolicies.Get(ParentNativeClass);
-		if (ParentMapping && Class != ParentNativeClass && Mapping == *ParentMapping)
-		{
-			continue;
+			UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("  %s (%s) -> %s"), *Class->GetName(), *GetNameSafe(ParentNativeClass), *Enum->GetNameStringByValue(static_cast<uint32>(Mapping)));
 		}
 
-		UE_LOG(LogShooterReplicationGraph, Log, TEXT("  %s (%s) -> %s"), *Class->GetName(), *GetNameSafe(ParentNativeClass), *Enum->GetNameStringByValue(static_cast<uint32>(Mapping)));
-	}
-
-	UE_LOG(LogShooterReplicationGraph, Log, TEXT(""));
-	UE_LOG(LogShooterReplicationGraph, Log, TEXT("Class Settings Map: "));
-	FClassReplicationInfo DefaultValues;
-	for (auto ClassRepInfoIt = GlobalActorReplicationInfoMap.CreateClassMapIterator(); ClassRepInfoIt; ++ClassRepInfoIt)
-	{
-		UClass* Class = CastChecked<UClass>(ClassRepInfoIt.Key().ResolveObjectPtr());
-		const FClassReplicationInfo& ClassInfo = ClassRepInfoIt.Value();
-		UE_LOG(LogShooterReplicationGraph, Log, TEXT("  %s (%s) -> %s"), *Class->GetName(), *GetNameSafe(GetParentNativeClass(Class)), *ClassInfo.BuildDebugStringDelta());
+		UE_LOG(LogShooterReplicationGraph, Verbose, TEXT(""));
+		UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Class Settings Map: "));
+		for (auto ClassRepInfoIt = GlobalActorReplicationInfoMap.CreateClassMapIterator(); ClassRepInfoIt; ++ClassRepInfoIt)
+		{
+			UClass* Class = CastChecked<UClass>(ClassRepInfoIt.Key().ResolveObjectPtr());
+			const FClassReplicationInfo& ClassInfo = ClassRepInfoIt.Value();
+			UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("  %s (%s) -> %s"), *Class->GetName(), *GetNameSafe(GetParentNativeClass(Class)), *ClassInfo.BuildDebugStringDelta());
+		}
 	}
 
 
@@ -356,6 +373,313 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 #endif
 }
 
+void UShooterReplicationGraph::BuildClassRouting(TArray<UClass*>& OutReplicatedClasses)
+{
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (RouteClass(Class))
+		{
+			OutReplicatedClasses.Add(Class);
+		}
+	}
+}
+
+bool UShooterReplicationGraph::RouteClass(UClass* Class)
+{
+	AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+	if (!ActorCDO || !ActorCDO->GetIsReplicated())
+	{
+		return false;
+	}
+
+	// Skip SKEL and REINST classes.
+	if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+	{
+		return false;
+	}
+
+	// Skip if already in the map (added explicitly)
+	if (ClassRepNodePolicies.Contains(Class, false))
+	{
+		return true;
+	}
+	
+	auto ShouldSpatialize = [](const AActor* CDO)
+	{
+		return CDO->GetIsReplicated() && (!(CDO->bAlwaysRelevant || CDO->bOnlyRelevantToOwner || CDO->bNetUseOwnerRelevancy));
+	};
+
+	auto GetLegacyDebugStr = [](const AActor* CDO)
+	{
+		return FString::Printf(TEXT("%s [%d/%d/%d]"), *CDO->GetClass()->GetName(), CDO->bAlwaysRelevant, CDO->bOnlyRelevantToOwner, CDO->bNetUseOwnerRelevancy);
+	};
+
+	// Only handle this class if it differs from its super. There is no need to put every child class explicitly in the graph class mapping
+	UClass* SuperClass = Class->GetSuperClass();
+	if (AActor* SuperCDO = Cast<AActor>(SuperClass->GetDefaultObject()))
+	{
+		if (	SuperCDO->GetIsReplicated() == ActorCDO->GetIsReplicated() 
+			&&	SuperCDO->bAlwaysRelevant == ActorCDO->bAlwaysRelevant
+			&&	SuperCDO->bOnlyRelevantToOwner == ActorCDO->bOnlyRelevantToOwner
+			&&	SuperCDO->bNetUseOwnerRelevancy == ActorCDO->bNetUseOwnerRelevancy
+			)
+		{
+			return true;
+		}
+
+		if (ShouldSpatialize(ActorCDO) == false && ShouldSpatialize(SuperCDO) == true)
+		{
+			UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Adding %s to NonSpatializedChildClasses. (Parent: %s)"), *GetLegacyDebugStr(ActorCDO), *GetLegacyDebugStr(SuperCDO));
+			NonSpatializedChildClasses.Add(Class);
+		}
+	}
+		
+	if (ShouldSpatialize(ActorCDO))
+	{
+		ClassRepNodePolicies.Set(Class, EClassRepNodeMapping::Spatialize_Dynamic);
+	}
+	else if (ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner)
+	{
+		ClassRepNodePolicies.Set(Class, EClassRepNodeMapping::RelevantAllConnections);
+	}
+
+	return true;
+}
+
+void UShooterReplicationGraph::InitClassSettings(UClass* ReplicatedClass)
+{
+	if (ExplicitlySetClasses.FindByPredicate([&](const UClass* SetClass) { return ReplicatedClass->IsChildOf(SetClass); }) != nullptr)
+	{
+		return;
+	}
+
+	const bool bClassIsSpatialized = IsSpatialized(ClassRepNodePolicies.GetChecked(ReplicatedClass));
+
+	FClassReplicationInfo ClassInfo;
+	InitClassReplicationInfo(ClassInfo, ReplicatedClass, bClassIsSpatialized, NetDriver->NetServerMaxTickRate);
+	GlobalActorReplicationInfoMap.SetClassInfo( ReplicatedClass, ClassInfo );
+}
+
+void UShooterReplicationGraph::AddNetworkActor(AActor* Actor)
+{
+	// classes missing from the class cache, or loaded after the routing was set up, are routed on their first actor
+	if (Actor)
+	{
+		RouteLateClass(Actor->GetClass());
+	}
+
+	Super::AddNetworkActor(Actor);
+}
+
+void UShooterReplicationGraph::RouteLateClass(UClass* Class)
+{
+	if (Class == nullptr || RoutedClasses.Contains(Class))
+	{
+		return;
+	}
+
+	// a class is only routed if it differs from its super, which has to be routed first
+	RouteLateClass(Class->GetSuperClass());
+
+	RoutedClasses.Add(Class);
+	if (RouteClass(Class))
+	{
+		InitClassSettings(Class);
+		UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Routed %s on its first actor."), *Class->GetName());
+	}
+}
+
+namespace ShooterClassRoutingCache
+{
+	static const int32 Version = 1;
+
+	FString GetCachedFilename()
+	{
+		return FPaths::ProjectContentDir() / TEXT("RepGraph") / TEXT("ShooterClassRouting.json");
+	}
+
+	FString GetSavedFilename()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("RepGraph") / TEXT("ShooterClassRouting.json");
+	}
+
+	/** the cache is only valid for the build and network version that wrote it */
+	FString GetBuildKey()
+	{
+		return FString::Printf(TEXT("%d-%s-%s-%u"), Version, *FEngineVersion::Current().ToString(), FApp::GetBuildVersion(), FNetworkVersion::GetLocalNetworkVersion());
+	}
+
+	/** the replication settings the routing of a class depends on */
+	FString GetReplicationFlags(const AActor* CDO)
+	{
+		return FString::Printf(TEXT("%d%d%d%d"), CDO->GetIsReplicated(), CDO->bAlwaysRelevant, CDO->bOnlyRelevantToOwner, CDO->bNetUseOwnerRelevancy);
+	}
+
+	struct FEntry
+	{
+		FString ClassPath;
+		FString Mapping;
+		bool bNonSpatializedChild;
+		FString Flags;
+	};
+
+	uint32 GetChecksum(const FString& BuildKey, const TArray<FEntry>& Entries)
+	{
+		uint32 Crc = FCrc::StrCrc32(*BuildKey);
+		for (const FEntry& Entry : Entries)
+		{
+			Crc = FCrc::StrCrc32(*FString::Printf(TEXT("%s|%s|%d|%s"), *Entry.ClassPath, *Entry.Mapping, Entry.bNonSpatializedChild, *Entry.Flags), Crc);
+		}
+		return Crc;
+	}
+}
+
+bool UShooterReplicationGraph::LoadClassRoutingCache(TArray<UClass*>& OutReplicatedClasses)
+{
+	using namespace ShooterClassRoutingCache;
+
+	// a cache staged with the content comes first, then one saved by an earlier -WriteRepGraphClassCache run
+	return LoadClassRoutingCacheFile(GetCachedFilename(), OutReplicatedClasses) || LoadClassRoutingCacheFile(GetSavedFilename(), OutReplicatedClasses);
+}
+
+bool UShooterReplicationGraph::LoadClassRoutingCacheFile(const FString& Filename, TArray<UClass*>& OutReplicatedClasses)
+{
+	using namespace ShooterClassRoutingCache;
+
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *Filename))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Json;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Json) || !Json.IsValid())
+	{
+		UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Class cache %s can't be read, looking at all classes."), *Filename);
+		return false;
+	}
+
+	const FString BuildKey = GetBuildKey();
+	if (Json->GetStringField(TEXT("BuildKey")) != BuildKey)
+	{
+		UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Class cache %s was written by %s, not this build (%s), looking at all classes."), *Filename, *Json->GetStringField(TEXT("BuildKey")), *BuildKey);
+		return false;
+	}
+
+	TArray<FEntry> Entries;
+	for (const TSharedPtr<FJsonValue>& Value : Json->GetArrayField(TEXT("Classes")))
+	{
+		const TSharedPtr<FJsonObject>* ClassJson = nullptr;
+		if (!Value->TryGetObject(ClassJson))
+		{
+			return false;
+		}
+
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.ClassPath = (*ClassJson)->GetStringField(TEXT("Class"));
+		Entry.Mapping = (*ClassJson)->GetStringField(TEXT("Mapping"));
+		Entry.bNonSpatializedChild = (*ClassJson)->GetBoolField(TEXT("NonSpatializedChild"));
+		Entry.Flags = (*ClassJson)->GetStringField(TEXT("Flags"));
+	}
+
+	// the checksum is written as a string, json numbers are doubles
+	if (Json->GetStringField(TEXT("Checksum")) != FString::Printf(TEXT("%u"), GetChecksum(BuildKey, Entries)))
+	{
+		UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Class cache %s fails its checksum, looking at all classes."), *Filename);
+		return false;
+	}
+
+	// check every loaded class before routing any, so a stale cache leaves nothing behind
+	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
+	TArray<TPair<UClass*, const FEntry*>> LoadedEntries;
+	for (const FEntry& Entry : Entries)
+	{
+		// classes that aren't loaded yet weren't seen by looking at all classes either
+		UClass* Class = FindObject<UClass>(nullptr, *Entry.ClassPath);
+		if (Class == nullptr)
+		{
+			continue;
+		}
+
+		const AActor* CDO = Cast<AActor>(Class->GetDefaultObject());
+		if (CDO == nullptr || GetReplicationFlags(CDO) != Entry.Flags || (!Entry.Mapping.IsEmpty() && Enum->GetValueByNameString(Entry.Mapping) == INDEX_NONE))
+		{
+			UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Class cache %s doesn't match %s, looking at all classes."), *Filename, *Entry.ClassPath);
+			return false;
+		}
+
+		LoadedEntries.Emplace(Class, &Entry);
+	}
+
+	for (const TPair<UClass*, const FEntry*>& LoadedEntry : LoadedEntries)
+	{
+		UClass* Class = LoadedEntry.Key;
+		const FEntry& Entry = *LoadedEntry.Value;
+
+		OutReplicatedClasses.Add(Class);
+
+		if (Entry.bNonSpatializedChild)
+		{
+			NonSpatializedChildClasses.Add(Class);
+		}
+
+		// explicitly added classes are in the cache as well, routing them again changes nothing
+		if (!Entry.Mapping.IsEmpty())
+		{
+			ClassRepNodePolicies.Set(Class, static_cast<EClassRepNodeMapping>(Enum->GetValueByNameString(Entry.Mapping)));
+		}
+	}
+
+	return true;
+}
+
+void UShooterReplicationGraph::SaveClassRoutingCache(const TArray<UClass*>& ReplicatedClasses)
+{
+	using namespace ShooterClassRoutingCache;
+
+	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
+
+	TArray<FEntry> Entries;
+	for (UClass* Class : ReplicatedClasses)
+	{
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.ClassPath = Class->GetPathName();
+		Entry.bNonSpatializedChild = NonSpatializedChildClasses.Contains(Class);
+		Entry.Flags = GetReplicationFlags(Class->GetDefaultObject<AActor>());
+
+		// only classes routed themselves, the others use the routing of their super
+		if (ClassRepNodePolicies.Contains(Class, false))
+		{
+			Entry.Mapping = Enum->GetNameStringByValue(static_cast<uint32>(ClassRepNodePolicies.GetChecked(Class)));
+		}
+	}
+
+	const FString BuildKey = GetBuildKey();
+
+	TArray<TSharedPtr<FJsonValue>> ClassValues;
+	for (const FEntry& Entry : Entries)
+	{
+		TSharedRef<FJsonObject> ClassJson = MakeShared<FJsonObject>();
+		ClassJson->SetStringField(TEXT("Class"), Entry.ClassPath);
+		ClassJson->SetStringField(TEXT("Mapping"), Entry.Mapping);
+		ClassJson->SetBoolField(TEXT("NonSpatializedChild"), Entry.bNonSpatializedChild);
+		ClassJson->SetStringField(TEXT("Flags"), Entry.Flags);
+		ClassValues.Add(MakeShared<FJsonValueObject>(ClassJson));
+	}
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("BuildKey"), BuildKey);
+	Json->SetStringField(TEXT("Checksum"), FString::Printf(TEXT("%u"), GetChecksum(BuildKey, Entries)));
+	Json->SetArrayField(TEXT("Classes"), ClassValues);
+
+	const FString Filename = GetSavedFilename();
+
+	FString Text;
+	const bool bSaved = FJsonSerializer::Serialize(Json, TJsonWriterFactory<>::Create(&Text)) && FFileHelper::SaveStringToFile(Text, *Filename);
+	UE_LOG(LogShooterReplicationGraph, Display, TEXT("%s class cache %s with %d classes."), bSaved ? TEXT("Wrote") : TEXT("Failed to write"), *Filename, Entries.Num());
+}
+
 void UShooterReplicationGraph::InitGlobalGraphNodes()
 {
 	// -----------------------------------------------
@@ -397,6 +721,9 @@ void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConn
 	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
 
 	AddConnectionGraphNode(AlwaysRelevantConnectionNode, RepGraphConnection);
+
+	UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection* AdaptivePawnRateNode = CreateNewNode<UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection>();
+	AddConnectionGraphNode(AdaptivePawnRateNode, RepGraphConnection);
 }
 
 EClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
@@ -408,6 +735,11 @@ EClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
 
 void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
 {
+	if (ActorInfo.Class->IsChildOf(AShooterCharacter::StaticClass()))
+	{
+		ShooterCharacters.ConditionalAdd(ActorInfo.Actor);
+	}
+
 	EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
 	switch(Policy)
 	{
@@ -452,6 +784,11 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 
 void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
 {
+	if (ActorInfo.Class->IsChildOf(AShooterCharacter::StaticClass()))
+	{
+		ShooterCharacters.RemoveFast(ActorInfo.Actor);
+	}
+
 	EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
 	switch(Policy)
 	{
@@ -813,6 +1150,148 @@ void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicat
 
 // ------------------------------------------------------------------------------
 
+void UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+
+	if (!CVar_ShooterRepGraph_AdaptivePawnRate_Enabled)
+	{
+		if (bRatesApplied)
+		{
+			bRatesApplied = false;
+			for (FActorRepListType Actor : ShooterGraph->ShooterCharacters)
+			{
+				ConnectionActorInfoMap.FindOrAdd(Actor).ReplicationPeriodFrame = GraphGlobals->GlobalActorReplicationInfoMap->GetClassInfo(Actor->GetClass()).ReplicationPeriodFrame;
+			}
+		}
+		return;
+	}
+
+	// rates follow what pawns do closely enough without being recomputed every frame
+	if (bRatesApplied && Params.ReplicationFrameNum - LastUpdateFrameNum < (uint32)FMath::Max(CVar_ShooterRepGraph_AdaptivePawnRate_UpdateFrames, 1))
+	{
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection_GatherActorListsForConnection );
+
+	LastUpdateFrameNum = Params.ReplicationFrameNum;
+	bRatesApplied = true;
+
+	const float MinHz = FMath::Max(CVar_ShooterRepGraph_AdaptivePawnRate_MinHz, 1.f);
+	const float MaxHz = FMath::Max(CVar_ShooterRepGraph_AdaptivePawnRate_MaxHz, MinHz);
+
+	float TotalMinHz = 0.f;
+	float TotalHz = 0.f;
+	PawnRates.Reset();
+
+	for (FActorRepListType Actor : ShooterGraph->ShooterCharacters)
+	{
+		const AShooterCharacter* Pawn = CastChecked<AShooterCharacter>(Actor);
+
+		// the connection's own pawn and view target always get the max rate
+		bool bIsViewer = false;
+		for (const FNetViewer& CurViewer : Params.Viewers)
+		{
+			if (Pawn == CurViewer.ViewTarget || (CurViewer.InViewer && Pawn == CurViewer.InViewer->GetPawn()))
+			{
+				bIsViewer = true;
+				break;
+			}
+		}
+
+		FPawnRate& PawnRate = PawnRates.AddDefaulted_GetRef();
+		PawnRate.Pawn = Actor;
+		PawnRate.Hz = bIsViewer ? MaxHz : FMath::Lerp(MinHz, MaxHz, GetPawnScore(Pawn, Params));
+		PawnRate.MinHz = bIsViewer ? MaxHz : MinHz;
+
+		TotalMinHz += PawnRate.MinHz;
+		TotalHz += PawnRate.Hz;
+	}
+
+	// the connection's net speed is capped by the net driver's client rates, a budget above it would never be reached
+	LastBudgetBytesPerSecond = CVar_ShooterRepGraph_AdaptivePawnRate_BudgetBytesPerSecond;
+	const UNetConnection* NetConnection = Params.ConnectionManager.NetConnection;
+	if (LastBudgetBytesPerSecond > 0.f && CVar_ShooterRepGraph_AdaptivePawnRate_NetSpeedFraction > 0.f && NetConnection && NetConnection->CurrentNetSpeed > 0)
+	{
+		LastBudgetBytesPerSecond = FMath::Min(LastBudgetBytesPerSecond, NetConnection->CurrentNetSpeed * CVar_ShooterRepGraph_AdaptivePawnRate_NetSpeedFraction);
+	}
+
+	// scale what is above the min rates down until the estimated bandwidth fits the target, the min rates themselves are kept
+	LastBudgetScale = 1.f;
+	const float BytesPerUpdate = FMath::Max(CVar_ShooterRepGraph_AdaptivePawnRate_BytesPerUpdate, 1.f);
+	if (LastBudgetBytesPerSecond > 0.f && TotalHz * BytesPerUpdate > LastBudgetBytesPerSecond && TotalHz > TotalMinHz)
+	{
+		const float BudgetHz = LastBudgetBytesPerSecond / BytesPerUpdate;
+		LastBudgetScale = FMath::Clamp((BudgetHz - TotalMinHz) / (TotalHz - TotalMinHz), 0.f, 1.f);
+
+		if (BudgetHz < TotalMinHz && !bWarnedMinRatesOverBudget)
+		{
+			UE_LOG(LogShooterReplicationGraph, Warning, TEXT("%d pawns at their min rates need about %.0f bytes/s, over the %.0f bytes/s pawn budget, rates can't be lowered any further."),
+				PawnRates.Num(), TotalMinHz * BytesPerUpdate, LastBudgetBytesPerSecond);
+			bWarnedMinRatesOverBudget = true;
+		}
+	}
+
+	const float ServerTickRate = ShooterGraph->NetDriver->NetServerMaxTickRate;
+	LastTotalHz = 0.f;
+
+	for (const FPawnRate& PawnRate : PawnRates)
+	{
+		const float Hz = PawnRate.MinHz + (PawnRate.Hz - PawnRate.MinHz) * LastBudgetScale;
+		SetPawnRate(ConnectionActorInfoMap.FindOrAdd(PawnRate.Pawn), Hz, ServerTickRate);
+		LastTotalHz += Hz;
+	}
+}
+
+float UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection::GetPawnScore(const AShooterCharacter* Pawn, const FConnectionGatherActorListParameters& Params) const
+{
+	const FVector PawnLocation = Pawn->GetActorLocation();
+	const float ViewConeCos = FMath::Cos(FMath::DegreesToRadians(CVar_ShooterRepGraph_AdaptivePawnRate_ViewConeDegrees * 0.5f));
+
+	// closeness to the nearest viewer, halved for viewers not looking at the pawn
+	float RelevanceScore = 0.f;
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		const FVector ToPawn = PawnLocation - CurViewer.ViewLocation;
+		const float Dist = ToPawn.Size();
+		const float DistScore = 1.f - FMath::GetRangePct(CVar_ShooterRepGraph_AdaptivePawnRate_NearDist, CVar_ShooterRepGraph_AdaptivePawnRate_FarDist, FMath::Clamp(Dist, CVar_ShooterRepGraph_AdaptivePawnRate_NearDist, CVar_ShooterRepGraph_AdaptivePawnRate_FarDist));
+		const bool bInView = Dist < KINDA_SMALL_NUMBER || (ToPawn / Dist | CurViewer.ViewDir) >= ViewConeCos;
+
+		RelevanceScore = FMath::Max(RelevanceScore, bInView ? DistScore : DistScore * 0.5f);
+	}
+
+	// moving fast or firing, still less important when far away
+	const AShooterWeapon* Weapon = Pawn->GetWeapon();
+	const bool bIsFiring = Weapon && Weapon->GetCurrentState() == EWeaponState::Firing;
+	const float SpeedScore = FMath::Clamp(Pawn->GetVelocity().Size() / FMath::Max(CVar_ShooterRepGraph_AdaptivePawnRate_FastSpeed, 1.f), 0.f, 1.f);
+	const float ActivityScore = bIsFiring ? 1.f : SpeedScore;
+
+	return FMath::Max(RelevanceScore, ActivityScore * FMath::Lerp(0.5f, 1.f, RelevanceScore));
+}
+
+void UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection::SetPawnRate(FConnectionReplicationActorInfo& ConnectionActorInfo, float RateHz, float ServerTickRate) const
+{
+	const uint8 NewPeriodFrame = (uint8)FMath::Clamp(FMath::RoundToInt(ServerTickRate / RateHz), 1, (int32)MAX_uint8);
+	if (NewPeriodFrame < ConnectionActorInfo.ReplicationPeriodFrame && ConnectionActorInfo.LastRepFrameNum > 0)
+	{
+		ConnectionActorInfo.NextReplicationFrameNum = FMath::Min(ConnectionActorInfo.NextReplicationFrameNum, ConnectionActorInfo.LastRepFrameNum + NewPeriodFrame);
+	}
+
+	ConnectionActorInfo.ReplicationPeriodFrame = NewPeriodFrame;
+}
+
+void UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	DebugInfo.Log(FString::Printf(TEXT("Pawns: %d, Total rate: %.1f Hz, Budget: %.0f bytes/s, Budget scale: %.2f"), PawnRates.Num(), LastTotalHz, LastBudgetBytesPerSecond, LastBudgetScale));
+	DebugInfo.PopIndent();
+}
+
+// ------------------------------------------------------------------------------
+
 void UShooterReplicationGraph::PrintRepNodePolicies()
 {
 	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
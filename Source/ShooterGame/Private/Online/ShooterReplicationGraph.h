@@ -44,6 +44,8 @@ public:
 	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
 	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
 	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+	virtual void AddNetworkActor(AActor* Actor) override;
 	
 	UPROPERTY()
 	TArray<UClass*>	SpatializedClasses;
@@ -62,6 +64,9 @@ public:
 
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
+	/** All replicated shooter characters, for UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection */
+	FActorRepListRefView ShooterCharacters;
+
 	void OnCharacterEquipWeapon(AShooterCharacter* Character, AShooterWeapon* NewWeapon);
 	void OnCharacterUnEquipWeapon(AShooterCharacter* Character, AShooterWeapon* OldWeapon);
 
@@ -75,9 +80,33 @@ private:
 
 	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
 
+	/** routes every loaded replicated class that differs from its super, looking at all classes */
+	void BuildClassRouting(TArray<UClass*>& OutReplicatedClasses);
+
+	/** routes a replicated class if it differs from its super, returns false if the class doesn't replicate */
+	bool RouteClass(UClass* Class);
+
+	/** sets the replication settings of a routed class from its CDO, unless a super class had them set explicitly */
+	void InitClassSettings(UClass* ReplicatedClass);
+
+	/** routes a class that wasn't looked at when the graph was set up, and its supers */
+	void RouteLateClass(UClass* Class);
+
+	/** routes the classes from the cache written by a previous run, false if it is missing or doesn't match this build */
+	bool LoadClassRoutingCache(TArray<UClass*>& OutReplicatedClasses);
+	bool LoadClassRoutingCacheFile(const FString& Filename, TArray<UClass*>& OutReplicatedClasses);
+
+	void SaveClassRoutingCache(const TArray<UClass*>& ReplicatedClasses);
+
 	bool IsSpatialized(EClassRepNodeMapping Mapping) const { return Mapping >= EClassRepNodeMapping::Spatialize_Static; }
 
 	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
+
+	/** classes whose replication settings were set explicitly, their children keep them */
+	TArray<UClass*> ExplicitlySetClasses;
+
+	/** classes looked at for routing, whether they replicate or not */
+	TSet<FObjectKey> RoutedClasses;
 };
 
 UCLASS()
@@ -144,4 +173,57 @@ private:
 	
 	TArray<FActorRepListRefView> ReplicationActorLists;
 	FActorRepListRefView ForceNetUpdateReplicationActorList;
-};
\ No newline at end of file
+};
+
+/**
+ * Connection node that doesn't gather anything, but sets how often each shooter character replicates to its connection.
+ * Fast moving, firing and nearby in view pawns replicate up to ShooterRepGraph.AdaptivePawnRate.MaxHz, idle and distant
+ * ones down to ShooterRepGraph.AdaptivePawnRate.MinHz, and the rates are scaled down when their estimated total goes over
+ * the connection's bandwidth target. Clients hide the lower rates with longer smoothing, see UShooterCharacterMovement.
+ */
+UCLASS()
+class UShooterReplicationGraphNode_AdaptivePawnRate_ForConnection : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override { }
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+private:
+
+	/** how much a connection wants updates of a pawn, from 0 (idle and far away) to 1 */
+	float GetPawnScore(const AShooterCharacter* Pawn, const FConnectionGatherActorListParameters& Params) const;
+
+	/** sets the pawn's replication period on the connection, and brings its next update closer if the period got shorter */
+	void SetPawnRate(FConnectionReplicationActorInfo& ConnectionActorInfo, float RateHz, float ServerTickRate) const;
+
+	struct FPawnRate
+	{
+		AActor* Pawn;
+		float MinHz;
+		float Hz;
+	};
+
+	/** scratch space, kept around to avoid allocations */
+	TArray<FPawnRate> PawnRates;
+
+	uint32 LastUpdateFrameNum = 0;
+
+	/** pawn rates were changed from the class default, and need a reset if the node gets disabled */
+	bool bRatesApplied = false;
+
+	/** results of the last update, for LogNode */
+	float LastTotalHz = 0.f;
+	float LastBudgetBytesPerSecond = 0.f;
+	float LastBudgetScale = 1.f;
+
+	/** the min rates alone went over the budget, which is only logged once per connection */
+	bool bWarnedMinRatesOverBudget = false;
+};
@@ -0,0 +1,341 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterServerReplayRecorder.h"
+#include "ShooterGameInstance.h"
+#include "Online/ShooterServerTelemetry.h"
+#include "Online/ShooterReplayIndex.h"
+#include "NetworkReplayStreaming.h"
+#include "Engine/DemoNetDriver.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterServerReplay"), STATGROUP_ShooterServerReplay, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Recording"), STAT_ShooterServerReplay_Recording, STATGROUP_ShooterServerReplay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Segments Recorded"), STAT_ShooterServerReplay_Segments, STATGROUP_ShooterServerReplay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Segments Deleted"), STAT_ShooterServerReplay_Deleted, STATGROUP_ShooterServerReplay);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Game Thread (ms)"), STAT_ShooterServerReplay_FrameTime, STATGROUP_ShooterServerReplay);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Segment (KB/s)"), STAT_ShooterServerReplay_Bandwidth, STATGROUP_ShooterServerReplay);
+
+int32 CVar_ShooterServerReplay_Enabled = 0;
+static FAutoConsoleVariableRef CVarShooterServerReplayEnabled(TEXT("ShooterServerReplay.Enabled"), CVar_ShooterServerReplay_Enabled, TEXT("If 1, dedicated servers record every match, takes effect on next match"), ECVF_Default );
+
+float CVar_ShooterServerReplay_SegmentLength = 300.0f;
+static FAutoConsoleVariableRef CVarShooterServerReplaySegmentLength(TEXT("ShooterServerReplay.SegmentLength"), CVar_ShooterServerReplay_SegmentLength, TEXT("Seconds of match recorded into one replay before starting the next one"), ECVF_Default );
+
+int32 CVar_ShooterServerReplay_MaxSegments = 100;
+static FAutoConsoleVariableRef CVarShooterServerReplayMaxSegments(TEXT("ShooterServerReplay.MaxSegments"), CVar_ShooterServerReplay_MaxSegments, TEXT("Number of recorded segments kept on disk, oldest are deleted past that"), ECVF_Default );
+
+int32 CVar_ShooterServerReplay_MaxDiskMB = 2048;
+static FAutoConsoleVariableRef CVarShooterServerReplayMaxDiskMB(TEXT("ShooterServerReplay.MaxDiskMB"), CVar_ShooterServerReplay_MaxDiskMB, TEXT("Disk space used by recorded segments, oldest are deleted past that"), ECVF_Default );
+
+float CVar_ShooterServerReplay_RecordHz = 10.0f;
+static FAutoConsoleVariableRef CVarShooterServerReplayRecordHz(TEXT("ShooterServerReplay.RecordHz"), CVar_ShooterServerReplay_RecordHz, TEXT("Replay frames recorded per second on servers, 0 to keep the engine default"), ECVF_Default );
+
+// Checkpoints hold the whole world state, the demo driver spreads saving them over frames within this budget.
+float CVar_ShooterServerReplay_CheckpointMaxMSPerFrame = 2.0f;
+static FAutoConsoleVariableRef CVarShooterServerReplayCheckpointMaxMSPerFrame(TEXT("ShooterServerReplay.CheckpointMaxMSPerFrame"), CVar_ShooterServerReplay_CheckpointMaxMSPerFrame, TEXT("Milliseconds per frame spent saving a replay checkpoint on servers, 0 to keep the engine default"), ECVF_Default );
+
+float CVar_ShooterServerReplay_ReportInterval = 60.0f;
+static FAutoConsoleVariableRef CVarShooterServerReplayReportInterval(TEXT("ShooterServerReplay.ReportInterval"), CVar_ShooterServerReplay_ReportInterval, TEXT("Seconds between logs of the game thread time, with or without recording"), ECVF_Default );
+
+namespace
+{
+	/** every segment name starts with it, so retention never touches other replays */
+	const TCHAR* ServerReplayPrefix = TEXT("ServerReplay_");
+
+	void SetEngineCVar(const TCHAR* Name, float Value)
+	{
+		IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+		if (CVar && Value > 0.0f)
+		{
+			CVar->Set(Value, ECVF_SetByCode);
+		}
+	}
+}
+
+FShooterServerReplayRecorder::FShooterServerReplayRecorder(UGameInstance* InGameInstance)
+	: GameInstance(InGameInstance)
+	, SegmentStartTime(0.0)
+	, SegmentNum(0)
+	, bEnumeratingStreams(false)
+	, ReportedFrameCount(0)
+	, ReportedFrameTimeSumMS(0.0)
+	, LastReportTime(0.0)
+{
+}
+
+FShooterServerReplayRecorder::~FShooterServerReplayRecorder()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
+}
+
+void FShooterServerReplayRecorder::Initialize()
+{
+	ReplayStreamer = FNetworkReplayStreaming::Get().GetFactory().CreateReplayStreamer();
+
+	TickDelegateHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FShooterServerReplayRecorder::Tick), 1.0f);
+
+	LastReportTime = FPlatformTime::Seconds();
+
+	// apply retention to what previous runs left behind
+	UpdateSegments();
+}
+
+void FShooterServerReplayRecorder::OnMatchStarted()
+{
+	// compare against the frames before the match, which never record
+	ReportFrameTime();
+
+	if (CVar_ShooterServerReplay_Enabled == 0 || IsRecording())
+	{
+		return;
+	}
+
+	MatchStartTime = FDateTime::UtcNow();
+	SegmentNum = 0;
+	StartSegment();
+}
+
+void FShooterServerReplayRecorder::OnMatchEnded()
+{
+	if (IsRecording())
+	{
+		ReportFrameTime();
+		StopSegment();
+	}
+}
+
+void FShooterServerReplayRecorder::StartSegment()
+{
+	UWorld* World = GameInstance.IsValid() ? GameInstance->GetWorld() : nullptr;
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	SetEngineCVar(TEXT("demo.RecordHz"), CVar_ShooterServerReplay_RecordHz);
+	SetEngineCVar(TEXT("demo.CheckpointSaveMaxMSPerFrameOverride"), CVar_ShooterServerReplay_CheckpointMaxMSPerFrame);
+
+	SegmentNum++;
+	CurrentSegmentName = FString::Printf(TEXT("%s%s_%03d"), ServerReplayPrefix, *MatchStartTime.ToString(TEXT("%Y%m%d-%H%M%S")), SegmentNum);
+	SegmentStartTime = FPlatformTime::Seconds();
+
+	const FString MapName = World->GetMapName();
+	const FString FriendlyName = FString::Printf(TEXT("%s #%d"), *MapName, SegmentNum);
+
+	// the local file streamer writes the replay to disk in chunks while recording, nothing accumulates in memory
+	GameInstance->StartRecordingReplay(CurrentSegmentName, FriendlyName);
+
+	if (World->GetDemoNetDriver() == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Server replay: failed to start recording %s."), *CurrentSegmentName);
+		CurrentSegmentName.Empty();
+		return;
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("Server replay: recording %s."), *CurrentSegmentName);
+	SET_DWORD_STAT(STAT_ShooterServerReplay_Recording, 1);
+
+	UShooterGameInstance* const ShooterGameInstance = Cast<UShooterGameInstance>(GameInstance.Get());
+	FShooterReplayIndex* ReplayIndex = ShooterGameInstance ? ShooterGameInstance->GetReplayIndex() : nullptr;
+	if (ReplayIndex)
+	{
+		FShooterReplayInfo Info;
+		Info.Name = CurrentSegmentName;
+		Info.FriendlyName = FriendlyName;
+		Info.Timestamp = FDateTime::UtcNow();
+		Info.MapName = MapName;
+		Info.NetworkVersion = FNetworkVersion::GetReplayVersion().NetworkVersion;
+		Info.bIsLive = true;
+		ReplayIndex->AddReplay(Info);
+	}
+}
+
+void FShooterServerReplayRecorder::StopSegment()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	if (GameInstance.IsValid())
+	{
+		GameInstance->StopRecordingReplay();
+	}
+
+	FFinishedSegment& Finished = FinishedSegments.AddDefaulted_GetRef();
+	Finished.Name = CurrentSegmentName;
+	Finished.Duration = FPlatformTime::Seconds() - SegmentStartTime;
+
+	UE_LOG(LogShooter, Log, TEXT("Server replay: finished %s after %.0f s."), *CurrentSegmentName, Finished.Duration);
+	INC_DWORD_STAT(STAT_ShooterServerReplay_Segments);
+	SET_DWORD_STAT(STAT_ShooterServerReplay_Recording, 0);
+
+	CurrentSegmentName.Empty();
+}
+
+bool FShooterServerReplayRecorder::Tick(float DeltaSeconds)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(FShooterServerReplayRecorder_Tick);
+
+	const double Now = FPlatformTime::Seconds();
+
+	if (IsRecording())
+	{
+		UWorld* World = GameInstance.IsValid() ? GameInstance->GetWorld() : nullptr;
+		if (World == nullptr || World->GetDemoNetDriver() == nullptr)
+		{
+			// the demo driver went away with the world, the next match starts a new recording
+			StopSegment();
+		}
+		else if (CVar_ShooterServerReplay_SegmentLength > 0.0f && Now - SegmentStartTime >= CVar_ShooterServerReplay_SegmentLength)
+		{
+			// each segment starts with a checkpoint, so it plays on its own
+			StopSegment();
+			StartSegment();
+		}
+	}
+
+	if (CVar_ShooterServerReplay_ReportInterval > 0.0f && Now - LastReportTime >= CVar_ShooterServerReplay_ReportInterval)
+	{
+		ReportFrameTime();
+	}
+
+	if (FinishedSegments.Num() > 0)
+	{
+		UpdateSegments();
+	}
+
+	return true;
+}
+
+void FShooterServerReplayRecorder::ReportFrameTime()
+{
+	UShooterGameInstance* ShooterGameInstance = Cast<UShooterGameInstance>(GameInstance.Get());
+	FShooterServerTelemetry* Telemetry = ShooterGameInstance ? ShooterGameInstance->GetServerTelemetry() : nullptr;
+	if (Telemetry)
+	{
+		uint64 TotalFrameCount = 0;
+		double TotalFrameTimeSumMS = 0.0;
+		Telemetry->GetFrameTimeTotals(TotalFrameCount, TotalFrameTimeSumMS);
+
+		const uint64 FrameCount = TotalFrameCount - ReportedFrameCount;
+		if (FrameCount > 0)
+		{
+			const float AverageMS = (TotalFrameTimeSumMS - ReportedFrameTimeSumMS) / FrameCount;
+			SET_FLOAT_STAT(STAT_ShooterServerReplay_FrameTime, AverageMS);
+			UE_LOG(LogShooter, Log, TEXT("Server replay: game thread %.2f ms per frame over %llu frames, %s."), AverageMS, FrameCount, IsRecording() ? TEXT("recording") : TEXT("not recording"));
+		}
+
+		ReportedFrameCount = TotalFrameCount;
+		ReportedFrameTimeSumMS = TotalFrameTimeSumMS;
+	}
+
+	LastReportTime = FPlatformTime::Seconds();
+}
+
+void FShooterServerReplayRecorder::UpdateSegments()
+{
+	if (!ReplayStreamer.IsValid() || bEnumeratingStreams)
+	{
+		return;
+	}
+
+	bEnumeratingStreams = true;
+	ReplayStreamer->EnumerateStreams(FNetworkVersion::GetReplayVersion(), INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &FShooterServerReplayRecorder::OnEnumerateStreamsComplete));
+}
+
+void FShooterServerReplayRecorder::OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result)
+{
+	bEnumeratingStreams = false;
+
+	if (!Result.WasSuccessful())
+	{
+		return;
+	}
+
+	UShooterGameInstance* const ShooterGameInstance = Cast<UShooterGameInstance>(GameInstance.Get());
+	FShooterReplayIndex* ReplayIndex = ShooterGameInstance ? ShooterGameInstance->GetReplayIndex() : nullptr;
+	if (ReplayIndex)
+	{
+		ReplayIndex->Reconcile(FNetworkVersion::GetReplayVersion(), Result.FoundStreams);
+	}
+
+	// sizes are final once the streamer no longer lists the segment as live
+	for (int32 i = FinishedSegments.Num() - 1; i >= 0; i--)
+	{
+		const FFinishedSegment& Finished = FinishedSegments[i];
+		const FNetworkReplayStreamInfo* StreamInfo = Result.FoundStreams.FindByPredicate([&Finished](const FNetworkReplayStreamInfo& Info) { return Info.Name == Finished.Name; });
+		if (StreamInfo == nullptr || !StreamInfo->bIsLive)
+		{
+			if (StreamInfo && Finished.Duration > 0.0f)
+			{
+				const float KBPerSecond = StreamInfo->SizeInBytes / 1024.0f / Finished.Duration;
+				SET_FLOAT_STAT(STAT_ShooterServerReplay_Bandwidth, KBPerSecond);
+				UE_LOG(LogShooter, Log, TEXT("Server replay: %s is %lld KB, %.1f KB/s."), *Finished.Name, StreamInfo->SizeInBytes / 1024, KBPerSecond);
+			}
+			FinishedSegments.RemoveAt(i);
+		}
+	}
+
+	ApplyRetention();
+}
+
+void FShooterServerReplayRecorder::ApplyRetention()
+{
+	UShooterGameInstance* const ShooterGameInstance = Cast<UShooterGameInstance>(GameInstance.Get());
+	FShooterReplayIndex* ReplayIndex = ShooterGameInstance ? ShooterGameInstance->GetReplayIndex() : nullptr;
+	if (ReplayIndex == nullptr || !ReplayStreamer.IsValid())
+	{
+		return;
+	}
+
+	const int64 MaxBytes = (int64)CVar_ShooterServerReplay_MaxDiskMB * 1024 * 1024;
+
+	int32 NumKept = 0;
+	int64 BytesKept = 0;
+	TArray<FString> ToDelete;
+
+	// newest first, so everything past the budget is the oldest
+	for (const FShooterReplayInfo& Info : ReplayIndex->GetReplays())
+	{
+		if (!Info.Name.StartsWith(ServerReplayPrefix) || Info.Name == CurrentSegmentName || PendingDeletes.Contains(Info.Name))
+		{
+			continue;
+		}
+
+		NumKept++;
+		BytesKept += Info.SizeInBytes;
+
+		if ((CVar_ShooterServerReplay_MaxSegments > 0 && NumKept > CVar_ShooterServerReplay_MaxSegments) || (MaxBytes > 0 && BytesKept > MaxBytes))
+		{
+			ToDelete.Add(Info.Name);
+		}
+	}
+
+	for (const FString& Name : ToDelete)
+	{
+		PendingDeletes.Add(Name);
+		ReplayStreamer->DeleteFinishedStream(Name, FDeleteFinishedStreamCallback::CreateSP(this, &FShooterServerReplayRecorder::OnDeleteFinishedStreamComplete, Name));
+	}
+}
+
+void FShooterServerReplayRecorder::OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result, FString DeletedName)
+{
+	PendingDeletes.Remove(DeletedName);
+
+	if (!Result.WasSuccessful())
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Server replay: failed to delete %s."), *DeletedName);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_ShooterServerReplay_Deleted);
+
+	UShooterGameInstance* const ShooterGameInstance = Cast<UShooterGameInstance>(GameInstance.Get());
+	FShooterReplayIndex* ReplayIndex = ShooterGameInstance ? ShooterGameInstance->GetReplayIndex() : nullptr;
+	if (ReplayIndex)
+	{
+		ReplayIndex->RemoveReplay(DeletedName);
+	}
+}
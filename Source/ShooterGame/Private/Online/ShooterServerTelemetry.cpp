@@ -0,0 +1,346 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterServerTelemetry.h"
+#include "Async/Async.h"
+
+float CVar_ShooterTelemetry_ExportInterval = 10.0f;
+static FAutoConsoleVariableRef CVarShooterTelemetryExportInterval(TEXT("ShooterTelemetry.ExportInterval"), CVar_ShooterTelemetry_ExportInterval, TEXT("Seconds between writes of the server metrics file, 0 to stop writing it"), ECVF_Default );
+
+// Frames slower than this are logged, so spikes can be matched with the rest of the log.
+float CVar_ShooterTelemetry_HitchMS = 100.0f;
+static FAutoConsoleVariableRef CVarShooterTelemetryHitchMS(TEXT("ShooterTelemetry.HitchMS"), CVar_ShooterTelemetry_HitchMS, TEXT("Game thread time of a frame logged as a hitch, in milliseconds, 0 to never log"), ECVF_Default );
+
+namespace
+{
+	/** label of each EShooterServerTiming in the metrics */
+	const TCHAR* TimingNames[] =
+	{
+		TEXT("replication"),
+		TEXT("ai"),
+		TEXT("weapon_traces"),
+		TEXT("payload_http"),
+		TEXT("gc"),
+	};
+	static_assert(UE_ARRAY_COUNT(TimingNames) == (int32)EShooterServerTiming::Num, "Every timing needs a name");
+}
+
+const float FShooterServerTelemetry::FrameTimeBucketsMS[] = { 2.0f, 4.0f, 8.0f, 16.0f, 33.0f, 50.0f, 100.0f, 250.0f, 1000.0f };
+const int32 FShooterServerTelemetry::NumFrameTimeBuckets = UE_ARRAY_COUNT(FShooterServerTelemetry::FrameTimeBucketsMS) + 1;
+
+bool FShooterServerTelemetry::bEnabled = false;
+double FShooterServerTelemetry::FrameTimingSeconds[(int32)EShooterServerTiming::Num] = {};
+bool FShooterServerTelemetry::ActiveTimings[(int32)EShooterServerTiming::Num] = {};
+int32 FShooterServerTelemetry::IntervalClientCorrections = 0;
+
+FShooterServerTelemetry::FFrameTimeHistogram::FFrameTimeHistogram()
+{
+	BucketCounts.SetNumZeroed(NumFrameTimeBuckets);
+	Reset();
+}
+
+void FShooterServerTelemetry::FFrameTimeHistogram::Add(float FrameTimeMS)
+{
+	int32 Bucket = 0;
+	while (Bucket < NumFrameTimeBuckets - 1 && FrameTimeMS > FrameTimeBucketsMS[Bucket])
+	{
+		Bucket++;
+	}
+
+	BucketCounts[Bucket]++;
+	SumMS += FrameTimeMS;
+	MaxMS = FMath::Max(MaxMS, FrameTimeMS);
+	Count++;
+}
+
+void FShooterServerTelemetry::FFrameTimeHistogram::Reset()
+{
+	FMemory::Memzero(BucketCounts.GetData(), BucketCounts.Num() * sizeof(uint64));
+	SumMS = 0.0;
+	MaxMS = 0.0f;
+	Count = 0;
+}
+
+float FShooterServerTelemetry::FFrameTimeHistogram::GetPercentileMS(float Percentile) const
+{
+	const uint64 Target = (uint64)FMath::CeilToDouble(Count * (double)Percentile);
+
+	uint64 Seen = 0;
+	for (int32 Bucket = 0; Bucket < NumFrameTimeBuckets - 1; Bucket++)
+	{
+		Seen += BucketCounts[Bucket];
+		if (Seen >= Target)
+		{
+			// never report more than the slowest frame, the bucket bound can be far above it
+			return FMath::Min(FrameTimeBucketsMS[Bucket], MaxMS);
+		}
+	}
+
+	return MaxMS;
+}
+
+FShooterServerTelemetry::FShooterServerTelemetry(UGameInstance* InGameInstance)
+	: GameInstance(InGameInstance)
+	, IntervalStartTime(0.0)
+	, LastIntervalSeconds(0.0f)
+	, NumConnections(0)
+	, InBytesPerSecond(0)
+	, OutBytesPerSecond(0)
+	, AverageLagMS(0.0f)
+	, MaxLagMS(0.0f)
+	, TotalClientCorrections(0)
+	, LastIntervalClientCorrections(0)
+	, FrameStartTime(0.0)
+	, PreloadSeconds(0.0f)
+	, ReadySeconds(0.0f)
+{
+	FMemory::Memzero(TotalTimingSeconds);
+	FMemory::Memzero(IntervalTimingSeconds);
+	FMemory::Memzero(LastIntervalTimingSeconds);
+}
+
+FShooterServerTelemetry::~FShooterServerTelemetry()
+{
+	bEnabled = false;
+
+	FTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartDelegateHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameDelegateHandle);
+
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+}
+
+void FShooterServerTelemetry::Initialize()
+{
+	TickDelegateHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FShooterServerTelemetry::Tick), 1.0f);
+	WorldTickStartDelegateHandle = FWorldDelegates::OnWorldTickStart.AddSP(this, &FShooterServerTelemetry::OnWorldTickStart);
+	EndFrameDelegateHandle = FCoreDelegates::OnEndFrame.AddSP(this, &FShooterServerTelemetry::OnEndFrame);
+
+	IntervalStartTime = FPlatformTime::Seconds();
+	bEnabled = true;
+}
+
+void FShooterServerTelemetry::SetPreloadTime(double SecondsSinceStart)
+{
+	PreloadSeconds = SecondsSinceStart;
+}
+
+void FShooterServerTelemetry::NotifyReady()
+{
+	// later matches travel to a new map, only the first one is part of the boot
+	if (ReadySeconds > 0.0f)
+	{
+		return;
+	}
+
+	ReadySeconds = FPlatformTime::Seconds() - GStartTime;
+	UE_LOG(LogShooter, Display, TEXT("Telemetry: server ready %.2f s after starting, gameplay assets preloaded after %.2f s."), ReadySeconds, PreloadSeconds);
+}
+
+void FShooterServerTelemetry::AddTime(EShooterServerTiming Timing, double Seconds)
+{
+	if (bEnabled)
+	{
+		FrameTimingSeconds[(int32)Timing] += Seconds;
+	}
+}
+
+void FShooterServerTelemetry::AddClientCorrection()
+{
+	if (bEnabled)
+	{
+		IntervalClientCorrections++;
+	}
+}
+
+bool FShooterServerTelemetry::StartTiming(EShooterServerTiming Timing)
+{
+	if (!bEnabled || ActiveTimings[(int32)Timing])
+	{
+		return false;
+	}
+
+	ActiveTimings[(int32)Timing] = true;
+	return true;
+}
+
+void FShooterServerTelemetry::StopTiming(EShooterServerTiming Timing, double Seconds)
+{
+	ActiveTimings[(int32)Timing] = false;
+	AddTime(Timing, Seconds);
+}
+
+bool FShooterServerTelemetry::Tick(float DeltaSeconds)
+{
+	if (CVar_ShooterTelemetry_ExportInterval > 0.0f && FPlatformTime::Seconds() - IntervalStartTime >= CVar_ShooterTelemetry_ExportInterval)
+	{
+		Export();
+	}
+
+	return true;
+}
+
+void FShooterServerTelemetry::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (FrameStartTime == 0.0 && GameInstance.IsValid() && World == GameInstance->GetWorld())
+	{
+		FrameStartTime = FPlatformTime::Seconds();
+	}
+}
+
+void FShooterServerTelemetry::OnEndFrame()
+{
+	for (int32 i = 0; i < (int32)EShooterServerTiming::Num; i++)
+	{
+		TotalTimingSeconds[i] += FrameTimingSeconds[i];
+		IntervalTimingSeconds[i] += FrameTimingSeconds[i];
+		FrameTimingSeconds[i] = 0.0;
+	}
+
+	// idle time waiting for the next server tick is spent before the world tick starts, so it isn't counted
+	if (FrameStartTime > 0.0)
+	{
+		const float FrameTimeMS = (FPlatformTime::Seconds() - FrameStartTime) * 1000.0;
+		TotalFrameTimes.Add(FrameTimeMS);
+		IntervalFrameTimes.Add(FrameTimeMS);
+		FrameStartTime = 0.0;
+
+		if (CVar_ShooterTelemetry_HitchMS > 0.0f && FrameTimeMS >= CVar_ShooterTelemetry_HitchMS)
+		{
+			UE_LOG(LogShooter, Log, TEXT("Server telemetry: hitch of %.1f ms."), FrameTimeMS);
+		}
+	}
+}
+
+void FShooterServerTelemetry::Export()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(FShooterServerTelemetry_Export);
+
+	UWorld* World = GameInstance.IsValid() ? GameInstance->GetWorld() : nullptr;
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+	InBytesPerSecond = NetDriver ? NetDriver->InBytesPerSecond : 0;
+	OutBytesPerSecond = NetDriver ? NetDriver->OutBytesPerSecond : 0;
+
+	float LagSumMS = 0.0f;
+	MaxLagMS = 0.0f;
+	for (int32 i = 0; i < NumConnections; i++)
+	{
+		const float LagMS = NetDriver->ClientConnections[i] ? NetDriver->ClientConnections[i]->AvgLag * 1000.0f : 0.0f;
+		LagSumMS += LagMS;
+		MaxLagMS = FMath::Max(MaxLagMS, LagMS);
+	}
+	AverageLagMS = NumConnections > 0 ? LagSumMS / NumConnections : 0.0f;
+
+	TotalClientCorrections += IntervalClientCorrections;
+	LastIntervalClientCorrections = IntervalClientCorrections;
+	IntervalClientCorrections = 0;
+
+	const double Now = FPlatformTime::Seconds();
+	LastIntervalSeconds = Now - IntervalStartTime;
+	LastIntervalFrameTimes = IntervalFrameTimes;
+	FMemory::Memcpy(LastIntervalTimingSeconds, IntervalTimingSeconds);
+
+	IntervalFrameTimes.Reset();
+	FMemory::Memzero(IntervalTimingSeconds);
+	IntervalStartTime = Now;
+
+	// a slow disk shouldn't pile up writes, skip this one and catch up on the next
+	if (PendingWrite.IsValid() && !PendingWrite.IsReady())
+	{
+		return;
+	}
+
+	PendingWrite = Async(EAsyncExecution::ThreadPool, [Metrics = BuildMetrics()]()
+	{
+		// write next to the file and swap it in, so the collector never reads a partial file
+		const FString Filename = GetMetricsFilename();
+		const FString TempFilename = Filename + TEXT(".tmp");
+		return FFileHelper::SaveStringToFile(Metrics, *TempFilename) && IFileManager::Get().Move(*Filename, *TempFilename, true, true);
+	});
+}
+
+FString FShooterServerTelemetry::BuildMetrics() const
+{
+	FString Metrics;
+	Metrics.Reserve(4096);
+
+	Metrics += TEXT("# HELP shooter_server_frame_time_ms Game thread time per server frame, idle time excluded.\n");
+	Metrics += TEXT("# TYPE shooter_server_frame_time_ms histogram\n");
+
+	// Prometheus buckets are cumulative
+	uint64 CumulativeCount = 0;
+	for (int32 Bucket = 0; Bucket < NumFrameTimeBuckets; Bucket++)
+	{
+		CumulativeCount += TotalFrameTimes.BucketCounts[Bucket];
+		const FString UpperBound = Bucket < NumFrameTimeBuckets - 1 ? FString::SanitizeFloat(FrameTimeBucketsMS[Bucket]) : FString(TEXT("+Inf"));
+		Metrics += FString::Printf(TEXT("shooter_server_frame_time_ms_bucket{le=\"%s\"} %llu\n"), *UpperBound, CumulativeCount);
+	}
+	Metrics += FString::Printf(TEXT("shooter_server_frame_time_ms_sum %.3f\n"), TotalFrameTimes.SumMS);
+	Metrics += FString::Printf(TEXT("shooter_server_frame_time_ms_count %llu\n"), TotalFrameTimes.Count);
+
+	Metrics += TEXT("# HELP shooter_server_subsystem_seconds_total Game thread time spent in a server subsystem.\n");
+	Metrics += TEXT("# TYPE shooter_server_subsystem_seconds_total counter\n");
+	for (int32 i = 0; i < (int32)EShooterServerTiming::Num; i++)
+	{
+		Metrics += FString::Printf(TEXT("shooter_server_subsystem_seconds_total{subsystem=\"%s\"} %.6f\n"), TimingNames[i], TotalTimingSeconds[i]);
+	}
+
+	Metrics += TEXT("# HELP shooter_server_connections Client connections of the net driver.\n");
+	Metrics += TEXT("# TYPE shooter_server_connections gauge\n");
+	Metrics += FString::Printf(TEXT("shooter_server_connections %d\n"), NumConnections);
+
+	Metrics += TEXT("# HELP shooter_server_connection_lag_ms Round trip time of the client connections, averaged by the net driver.\n");
+	Metrics += TEXT("# TYPE shooter_server_connection_lag_ms gauge\n");
+	Metrics += FString::Printf(TEXT("shooter_server_connection_lag_ms{stat=\"avg\"} %.1f\n"), AverageLagMS);
+	Metrics += FString::Printf(TEXT("shooter_server_connection_lag_ms{stat=\"max\"} %.1f\n"), MaxLagMS);
+
+	Metrics += TEXT("# HELP shooter_server_client_corrections_total Client moves the server corrected.\n");
+	Metrics += TEXT("# TYPE shooter_server_client_corrections_total counter\n");
+	Metrics += FString::Printf(TEXT("shooter_server_client_corrections_total %llu\n"), TotalClientCorrections);
+
+	Metrics += TEXT("# HELP shooter_server_net_bytes_per_second Bandwidth of the net driver over the last second.\n");
+	Metrics += TEXT("# TYPE shooter_server_net_bytes_per_second gauge\n");
+	Metrics += FString::Printf(TEXT("shooter_server_net_bytes_per_second{direction=\"in\"} %d\n"), InBytesPerSecond);
+	Metrics += FString::Printf(TEXT("shooter_server_net_bytes_per_second{direction=\"out\"} %d\n"), OutBytesPerSecond);
+
+	Metrics += TEXT("# HELP shooter_server_boot_seconds Seconds from the server starting to the end of a boot phase, 0 until it ended.\n");
+	Metrics += TEXT("# TYPE shooter_server_boot_seconds gauge\n");
+	Metrics += FString::Printf(TEXT("shooter_server_boot_seconds{phase=\"preload\"} %.3f\n"), PreloadSeconds);
+	Metrics += FString::Printf(TEXT("shooter_server_boot_seconds{phase=\"ready\"} %.3f\n"), ReadySeconds);
+
+	return Metrics;
+}
+
+void FShooterServerTelemetry::AddSessionStatus(TMap<FString, FString>& Body) const
+{
+	const FFrameTimeHistogram& Frames = LastIntervalFrameTimes;
+	const float AverageMS = Frames.Count > 0 ? Frames.SumMS / Frames.Count : 0.0f;
+
+	Body.Add("ServerFrameTimeAvgMs", FString::Printf(TEXT("%.2f"), AverageMS));
+	Body.Add("ServerFrameTimeP99Ms", FString::Printf(TEXT("%.2f"), Frames.GetPercentileMS(0.99f)));
+	Body.Add("ServerFrameTimeMaxMs", FString::Printf(TEXT("%.2f"), Frames.MaxMS));
+	Body.Add("ServerFramesPerSecond", FString::Printf(TEXT("%.1f"), LastIntervalSeconds > 0.0f ? Frames.Count / LastIntervalSeconds : 0.0f));
+
+	// average per frame of the last interval
+	for (int32 i = 0; i < (int32)EShooterServerTiming::Num; i++)
+	{
+		const double MSPerFrame = Frames.Count > 0 ? LastIntervalTimingSeconds[i] * 1000.0 / Frames.Count : 0.0;
+		Body.Add(FString::Printf(TEXT("ServerTimeMs_%s"), TimingNames[i]), FString::Printf(TEXT("%.3f"), MSPerFrame));
+	}
+
+	Body.Add("NumConnections", FString::FromInt(NumConnections));
+	Body.Add("InBytesPerSecond", FString::FromInt(InBytesPerSecond));
+	Body.Add("OutBytesPerSecond", FString::FromInt(OutBytesPerSecond));
+	Body.Add("AverageLagMs", FString::Printf(TEXT("%.1f"), AverageLagMS));
+	Body.Add("CorrectionsPerSecond", FString::Printf(TEXT("%.2f"), LastIntervalSeconds > 0.0f ? LastIntervalClientCorrections / LastIntervalSeconds : 0.0f));
+	Body.Add("ReadySeconds", FString::Printf(TEXT("%.2f"), ReadySeconds));
+}
+
+FString FShooterServerTelemetry::GetMetricsFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Telemetry") / TEXT("ShooterServer.prom");
+}
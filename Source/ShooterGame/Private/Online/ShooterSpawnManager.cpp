@@ -0,0 +1,238 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterSpawnManager.h"
+#include "Online/ShooterPlayerState.h"
+#include "ShooterTeamStart.h"
+
+// Spawns with no living enemy closer than this get the best proximity score.
+float CVar_ShooterSpawn_SafeDistance = 3000.f;
+static FAutoConsoleVariableRef CVarShooterSpawnSafeDistance(TEXT("ShooterSpawn.SafeDistance"), CVar_ShooterSpawn_SafeDistance, TEXT("Distance to the closest enemy at which a spawn is considered safe"), ECVF_Default );
+
+int32 CVar_ShooterSpawn_MaxSightChecks = 2;
+static FAutoConsoleVariableRef CVarShooterSpawnMaxSightChecks(TEXT("ShooterSpawn.MaxSightChecks"), CVar_ShooterSpawn_MaxSightChecks, TEXT("How many of the closest enemies are traced against when scoring a spawn"), ECVF_Default );
+
+float CVar_ShooterSpawn_SightPenalty = 0.25f;
+static FAutoConsoleVariableRef CVarShooterSpawnSightPenalty(TEXT("ShooterSpawn.SightPenalty"), CVar_ShooterSpawn_SightPenalty, TEXT("Score multiplier applied for each close enemy that can see the spawn"), ECVF_Default );
+
+FShooterSpawnManager::FShooterSpawnManager()
+	: bHasTeamStarts(false)
+	, PawnIndexFrame(0)
+	, CellSize(2000.f)
+	, bInitialized(false)
+{
+}
+
+FIntPoint FShooterSpawnManager::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FShooterSpawnManager::Initialize(UWorld* World)
+{
+	BotStarts.Reset();
+	PlayerStarts.Reset();
+	BotTeamStarts.Reset();
+	PlayerTeamStarts.Reset();
+	PlainStarts.Reset();
+	bHasTeamStarts = false;
+	PIEStart = nullptr;
+
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		APlayerStart* TestSpawn = *It;
+		if (TestSpawn->IsA<APlayerStartPIE>())
+		{
+			if (!PIEStart.IsValid())
+			{
+				PIEStart = TestSpawn;
+			}
+			continue;
+		}
+
+		AShooterTeamStart* TeamStart = Cast<AShooterTeamStart>(TestSpawn);
+		if (TeamStart == nullptr)
+		{
+			PlainStarts.Add(TestSpawn);
+			continue;
+		}
+
+		bHasTeamStarts = true;
+
+		if (!TeamStart->bNotForBots)
+		{
+			BotStarts.Add(TeamStart);
+			BotTeamStarts.FindOrAdd(TeamStart->SpawnTeam).Add(TeamStart);
+		}
+
+		if (!TeamStart->bNotForPlayers)
+		{
+			PlayerStarts.Add(TeamStart);
+			PlayerTeamStarts.FindOrAdd(TeamStart->SpawnTeam).Add(TeamStart);
+		}
+	}
+
+	PawnIndexFrame = 0;
+	bInitialized = true;
+
+	UE_LOG(LogGameMode, Log, TEXT("Spawn manager: %d player starts, %d bot starts, %d teams, %d plain starts"), PlayerStarts.Num(), BotStarts.Num(), PlayerTeamStarts.Num(), PlainStarts.Num());
+}
+
+const TArray<TWeakObjectPtr<AShooterTeamStart>>& FShooterSpawnManager::GetStarts(bool bForBots) const
+{
+	return bForBots ? BotStarts : PlayerStarts;
+}
+
+const TArray<TWeakObjectPtr<AShooterTeamStart>>& FShooterSpawnManager::GetTeamStarts(bool bForBots, int32 TeamNum) const
+{
+	static const TArray<TWeakObjectPtr<AShooterTeamStart>> NoStarts;
+
+	const TArray<TWeakObjectPtr<AShooterTeamStart>>* Starts = (bForBots ? BotTeamStarts : PlayerTeamStarts).Find(TeamNum);
+	return Starts ? *Starts : NoStarts;
+}
+
+void FShooterSpawnManager::AddPawn(const FIndexedPawn& Pawn)
+{
+	PawnGrid.FindOrAdd(GetCell(Pawn.Location)).Add(Pawn);
+}
+
+void FShooterSpawnManager::UpdatePawnIndex(UWorld* World)
+{
+	if (PawnIndexFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(FShooterSpawnManager_UpdatePawnIndex);
+
+	PawnIndexFrame = GFrameCounter;
+	for (auto& Cell : PawnGrid)
+	{
+		Cell.Value.Reset();
+	}
+
+	for (ACharacter* Character : TActorRange<ACharacter>(World))
+	{
+		const AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(Character);
+		const AShooterPlayerState* PlayerState = Cast<AShooterPlayerState>(Character->GetPlayerState());
+
+		FIndexedPawn Pawn;
+		Pawn.Location = Character->GetActorLocation();
+		Pawn.CapsuleRadius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+		Pawn.CapsuleHalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		Pawn.TeamNum = PlayerState ? PlayerState->GetTeamNum() : INDEX_NONE;
+		Pawn.bAlive = ShooterCharacter && ShooterCharacter->IsAlive();
+		Pawn.Controller = Character->GetController();
+		Pawn.Actor = Character;
+		AddPawn(Pawn);
+	}
+}
+
+void FShooterSpawnManager::ReserveSpawn(const FVector& Location, float CapsuleRadius, float CapsuleHalfHeight)
+{
+	FIndexedPawn Pawn;
+	Pawn.Location = Location;
+	Pawn.CapsuleRadius = CapsuleRadius;
+	Pawn.CapsuleHalfHeight = CapsuleHalfHeight;
+	Pawn.TeamNum = INDEX_NONE;
+	Pawn.bAlive = false;
+	Pawn.Controller = nullptr;
+	Pawn.Actor = nullptr;
+	AddPawn(Pawn);
+}
+
+bool FShooterSpawnManager::IsOccupied(const FVector& Location, float CapsuleRadius, float CapsuleHalfHeight) const
+{
+	const FIntPoint Cell = GetCell(Location);
+	for (int32 X = -1; X <= 1; ++X)
+	{
+		for (int32 Y = -1; Y <= 1; ++Y)
+		{
+			const TArray<FIndexedPawn>* CellPawns = PawnGrid.Find(Cell + FIntPoint(X, Y));
+			if (CellPawns == nullptr)
+			{
+				continue;
+			}
+
+			for (const FIndexedPawn& Other : *CellPawns)
+			{
+				const float CombinedHeight = (CapsuleHalfHeight + Other.CapsuleHalfHeight) * 2.0f;
+				const float CombinedRadius = CapsuleRadius + Other.CapsuleRadius;
+
+				// check if player start overlaps this pawn
+				if (FMath::Abs(Location.Z - Other.Location.Z) < CombinedHeight && (Location - Other.Location).Size2D() < CombinedRadius)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+float FShooterSpawnManager::ScoreSpawn(UWorld* World, const FVector& Location, const AController* Player, int32 TeamNum) const
+{
+	const float SafeDistance = CVar_ShooterSpawn_SafeDistance;
+	const int32 CellRange = FMath::CeilToInt(SafeDistance / CellSize);
+	const FIntPoint Cell = GetCell(Location);
+
+	struct FCloseEnemy
+	{
+		const FIndexedPawn* Pawn;
+		float DistSq;
+	};
+	TArray<FCloseEnemy, TInlineAllocator<16>> CloseEnemies;
+
+	for (int32 X = -CellRange; X <= CellRange; ++X)
+	{
+		for (int32 Y = -CellRange; Y <= CellRange; ++Y)
+		{
+			const TArray<FIndexedPawn>* CellPawns = PawnGrid.Find(Cell + FIntPoint(X, Y));
+			if (CellPawns == nullptr)
+			{
+				continue;
+			}
+
+			for (const FIndexedPawn& Other : *CellPawns)
+			{
+				const bool bIsEnemy = Other.bAlive && Other.Controller != Player && (TeamNum == INDEX_NONE || Other.TeamNum != TeamNum);
+				if (!bIsEnemy)
+				{
+					continue;
+				}
+
+				const float DistSq = FVector::DistSquared(Location, Other.Location);
+				if (DistSq < FMath::Square(SafeDistance))
+				{
+					CloseEnemies.Add({ &Other, DistSq });
+				}
+			}
+		}
+	}
+
+	if (CloseEnemies.Num() == 0)
+	{
+		return 1.0f;
+	}
+
+	CloseEnemies.Sort([](const FCloseEnemy& A, const FCloseEnemy& B) { return A.DistSq < B.DistSq; });
+
+	float Score = FMath::Sqrt(CloseEnemies[0].DistSq) / SafeDistance;
+
+	// only the closest few enemies are traced, so the cost per spawn stays bounded no matter how crowded the area is
+	const int32 NumSightChecks = FMath::Min(CloseEnemies.Num(), CVar_ShooterSpawn_MaxSightChecks);
+	for (int32 i = 0; i < NumSightChecks; ++i)
+	{
+		const FIndexedPawn& Enemy = *CloseEnemies[i].Pawn;
+		FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(SpawnSightTrace), false, Enemy.Actor);
+
+		const FVector EyeLocation = Enemy.Location + FVector(0.f, 0.f, Enemy.CapsuleHalfHeight * 0.8f);
+		if (!World->LineTraceTestByChannel(EyeLocation, Location, COLLISION_WEAPON, TraceParams))
+		{
+			Score *= CVar_ShooterSpawn_SightPenalty;
+		}
+	}
+
+	return Score;
+}
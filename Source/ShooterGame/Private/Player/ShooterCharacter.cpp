@@ -7,7 +7,9 @@
 #include "Online/ShooterPlayerState.h"
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
-#include "Sound/SoundNodeLocalPlayer.h"
+#include "Sound/ShooterLocallyControlledActors.h"
+#include "Player/ShooterCharacterUpdater.h"
+#include "ShooterGameInstance.h"
 #include "AudioThread.h"
 
 static int32 NetVisualizeRelevancyTestPoints = 0;
@@ -84,10 +86,14 @@ void AShooterCharacter::PostInitializeComponents()
 	// set initial mesh visibility (3rd person view)
 	UpdatePawnMeshes();
 
-	// create material instance for setting team colors (3rd person view)
-	for (int32 iMat = 0; iMat < GetMesh()->GetNumMaterials(); iMat++)
+	// remember the materials team colors are based on
+	if (GetNetMode() != NM_DedicatedServer)
 	{
-		MeshMIDs.Add(GetMesh()->CreateAndSetMaterialInstanceDynamic(iMat));
+		for (int32 iMat = 0; iMat < GetMesh()->GetNumMaterials(); iMat++)
+		{
+			MeshBaseMaterials.Add(GetMesh()->GetMaterial(iMat));
+		}
+		Mesh1PBaseMaterial = Mesh1P->GetMaterial(0);
 	}
 
 	// play respawn effects
@@ -122,8 +128,7 @@ void AShooterCharacter::PawnClientRestart()
 	SetCurrentWeapon(CurrentWeapon);
 
 	// set team colors for 1st person view
-	UMaterialInstanceDynamic* Mesh1PMID = Mesh1P->CreateAndSetMaterialInstanceDynamic(0);
-	UpdateTeamColors(Mesh1PMID);
+	UpdateTeamColors();
 }
 
 void AShooterCharacter::PossessedBy(class AController* InController)
@@ -131,7 +136,7 @@ void AShooterCharacter::PossessedBy(class AController* InController)
 	Super::PossessedBy(InController);
 
 	// [server] as soon as PlayerState is assigned, set team colors of this pawn for local player
-	UpdateTeamColorsAllMIDs();
+	UpdateTeamColors();
 }
 
 void AShooterCharacter::OnRep_PlayerState()
@@ -141,7 +146,7 @@ void AShooterCharacter::OnRep_PlayerState()
 	// [client] as soon as PlayerState is assigned, set team colors of this pawn for local player
 	if (GetPlayerState() != NULL)
 	{
-		UpdateTeamColorsAllMIDs();
+		UpdateTeamColors();
 	}
 }
 
@@ -191,16 +196,25 @@ void AShooterCharacter::UpdatePawnMeshes()
 	GetMesh()->SetOwnerNoSee(bFirstPerson);
 }
 
-void AShooterCharacter::UpdateTeamColors(UMaterialInstanceDynamic* UseMID)
+void AShooterCharacter::UpdateTeamColors()
 {
-	if (UseMID)
+	AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(GetPlayerState());
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyPlayerState == NULL || MyGameState == NULL || GetNetMode() == NM_DedicatedServer)
 	{
-		AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(GetPlayerState());
-		if (MyPlayerState != NULL)
-		{
-			float MaterialParam = (float)MyPlayerState->GetTeamNum();
-			UseMID->SetScalarParameterValue(TEXT("Team Color Index"), MaterialParam);
-		}
+		return;
+	}
+
+	// all pawns of a team share the same instances, which keeps them out of per spawn allocations
+	const int32 TeamNum = MyPlayerState->GetTeamNum();
+	for (int32 iMat = 0; iMat < MeshBaseMaterials.Num(); iMat++)
+	{
+		GetMesh()->SetMaterial(iMat, MyGameState->GetTeamMaterial(MeshBaseMaterials[iMat], TeamNum));
+	}
+
+	if (Mesh1PBaseMaterial)
+	{
+		Mesh1P->SetMaterial(0, MyGameState->GetTeamMaterial(Mesh1PBaseMaterial, TeamNum));
 	}
 }
 
@@ -282,6 +296,10 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 		else
 		{
 			PlayHit(ActualDamage, DamageEvent, EventInstigator ? EventInstigator->GetPawn() : NULL, DamageCauser);
+			UpdateLowHealthSound();
+
+			// health regen, if the controller has it
+			RequestFrameUpdates();
 		}
 
 		MakeNoise(1.0f, EventInstigator ? EventInstigator->GetPawn() : this);
@@ -564,14 +582,25 @@ void AShooterCharacter::SpawnDefaultInventory()
 		return;
 	}
 
+	// weapons left by dead pawns are reused when the game mode has some
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+
 	int32 NumWeaponClasses = DefaultInventoryClasses.Num();
 	for (int32 i = 0; i < NumWeaponClasses; i++)
 	{
 		if (DefaultInventoryClasses[i])
 		{
-			FActorSpawnParameters SpawnInfo;
-			SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-			AShooterWeapon* NewWeapon = GetWorld()->SpawnActor<AShooterWeapon>(DefaultInventoryClasses[i], SpawnInfo);
+			AShooterWeapon* NewWeapon = nullptr;
+			if (GameMode)
+			{
+				NewWeapon = GameMode->AcquireWeapon(DefaultInventoryClasses[i]);
+			}
+			else
+			{
+				FActorSpawnParameters SpawnInfo;
+				SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+				NewWeapon = GetWorld()->SpawnActor<AShooterWeapon>(DefaultInventoryClasses[i], SpawnInfo);
+			}
 			AddWeapon(NewWeapon);
 		}
 	}
@@ -590,16 +619,28 @@ void AShooterCharacter::DestroyInventory()
 		return;
 	}
 
-	// remove all weapons from inventory and destroy them
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+
+	// remove all weapons from inventory and give them back to the game mode, or destroy them
 	for (int32 i = Inventory.Num() - 1; i >= 0; i--)
 	{
 		AShooterWeapon* Weapon = Inventory[i];
 		if (Weapon)
 		{
 			RemoveWeapon(Weapon);
-			Weapon->Destroy();
+			if (GameMode)
+			{
+				GameMode->ReleaseWeapon(Weapon);
+			}
+			else
+			{
+				Weapon->Destroy();
+			}
 		}
 	}
+
+	// a pooled weapon may soon belong to another pawn
+	CurrentWeapon = nullptr;
 }
 
 void AShooterCharacter::AddWeapon(AShooterWeapon* Weapon)
@@ -740,20 +781,7 @@ void AShooterCharacter::SetTargeting(bool bNewTargeting)
 		UGameplayStatics::SpawnSoundAttached(TargetingSound, GetRootComponent());
 	}
 
-	if (GetLocalRole() < ROLE_Authority)
-	{
-		ServerSetTargeting(bNewTargeting);
-	}
-}
-
-bool AShooterCharacter::ServerSetTargeting_Validate(bool bNewTargeting)
-{
-	return true;
-}
-
-void AShooterCharacter::ServerSetTargeting_Implementation(bool bNewTargeting)
-{
-	SetTargeting(bNewTargeting);
+	// the server learns about it from the compressed flags of our next move, see UShooterCharacterMovement
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -764,20 +792,18 @@ void AShooterCharacter::SetRunning(bool bNewRunning, bool bToggle)
 	bWantsToRun = bNewRunning;
 	bWantsToRunToggled = bNewRunning && bToggle;
 
-	if (GetLocalRole() < ROLE_Authority)
+	// toggled running ends on its own, and run sounds follow movement
+	if (bNewRunning)
 	{
-		ServerSetRunning(bNewRunning, bToggle);
+		RequestFrameUpdates();
 	}
 }
 
-bool AShooterCharacter::ServerSetRunning_Validate(bool bNewRunning, bool bToggle)
+void AShooterCharacter::SetMoveInput(bool bInWantsToRun, bool bInRunToggled, bool bInIsTargeting)
 {
-	return true;
-}
-
-void AShooterCharacter::ServerSetRunning_Implementation(bool bNewRunning, bool bToggle)
-{
-	SetRunning(bNewRunning, bToggle);
+	bWantsToRun = bInWantsToRun;
+	bWantsToRunToggled = bInRunToggled;
+	bIsTargeting = bInIsTargeting;
 }
 
 void AShooterCharacter::UpdateRunSounds()
@@ -1067,73 +1093,122 @@ bool AShooterCharacter::IsRunning() const
 	return (bWantsToRun || bWantsToRunToggled) && !GetVelocity().IsZero() && (GetVelocity().GetSafeNormal2D() | GetActorForwardVector()) > -0.1;
 }
 
-void AShooterCharacter::Tick(float DeltaSeconds)
+void AShooterCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// nothing native left to do in the actor tick, FShooterCharacterUpdater takes over while a state needs per frame work
+	const bool bHasScriptTick = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AShooterCharacter, ReceiveTick))
+		&& (bAllowReceiveTickEventOnDedicatedServer || GetNetMode() != NM_DedicatedServer);
+	if (!bHasScriptTick)
+	{
+		SetActorTickEnabled(false);
+	}
+
+	if (NetVisualizeRelevancyTestPoints == 1)
+	{
+		RequestFrameUpdates();
+	}
+}
+
+void AShooterCharacter::RequestFrameUpdates()
 {
-	Super::Tick(DeltaSeconds);
+	UShooterGameInstance* GameInstance = Cast<UShooterGameInstance>(GetGameInstance());
+	FShooterCharacterUpdater* CharacterUpdater = GameInstance ? GameInstance->GetCharacterUpdater() : nullptr;
+	if (CharacterUpdater && !bIsDying)
+	{
+		CharacterUpdater->RequestUpdates(this);
+	}
+}
+
+bool AShooterCharacter::UpdateFrameState(float DeltaSeconds)
+{
+	if (bIsDying)
+	{
+		return false;
+	}
+
+	bool bNeedsUpdates = false;
 
 	if (bWantsToRunToggled && !IsRunning())
 	{
 		SetRunning(false, false);
 	}
-	AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(Controller);
-	if (MyPC && MyPC->HasHealthRegen())
+
+	if (GEngine->UseSound())
+	{
+		UpdateRunSounds();
+		bNeedsUpdates |= RunLoopAC != nullptr && RunLoopAC->IsActive();
+	}
+	bNeedsUpdates |= bWantsToRun || bWantsToRunToggled;
+
+	if (GetLocalRole() == ROLE_Authority && Health < GetMaxHealth())
 	{
-		if (this->Health < this->GetMaxHealth())
+		AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(Controller);
+		if (MyPC && MyPC->HasHealthRegen())
 		{
-			this->Health += 5 * DeltaSeconds;
-			if (Health > this->GetMaxHealth())
-			{
-				Health = this->GetMaxHealth();
-			}
+			Health = FMath::Min(Health + 5 * DeltaSeconds, (float)GetMaxHealth());
+			UpdateLowHealthSound();
+			bNeedsUpdates |= Health < GetMaxHealth();
 		}
 	}
 
-	if (GEngine->UseSound())
+	if (NetVisualizeRelevancyTestPoints == 1)
 	{
-		if (LowHealthSound)
+		TArray<FVector> PointsToTest;
+		BuildPauseReplicationCheckPoints(PointsToTest);
+
+		for (FVector PointToTest : PointsToTest)
 		{
-			if ((this->Health > 0 && this->Health < this->GetMaxHealth() * LowHealthPercentage) && (!LowHealthWarningPlayer || !LowHealthWarningPlayer->IsPlaying()))
-			{
-				LowHealthWarningPlayer = UGameplayStatics::SpawnSoundAttached(LowHealthSound, GetRootComponent(),
-					NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, true);
-				if (LowHealthWarningPlayer)
-				{
-					LowHealthWarningPlayer->SetVolumeMultiplier(0.0f);
-				}
-			}
-			else if ((this->Health > this->GetMaxHealth() * LowHealthPercentage || this->Health < 0) && LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
-			{
-				LowHealthWarningPlayer->Stop();
-			}
-			if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
-			{
-				const float MinVolume = 0.3f;
-				const float VolumeMultiplier = (1.0f - (this->Health / (this->GetMaxHealth() * LowHealthPercentage)));
-				LowHealthWarningPlayer->SetVolumeMultiplier(MinVolume + (1.0f - MinVolume) * VolumeMultiplier);
-			}
+			DrawDebugSphere(GetWorld(), PointToTest, 10.0f, 8, FColor::Red);
 		}
-
-		UpdateRunSounds();
+		bNeedsUpdates = true;
 	}
 
-	const APlayerController* PC = Cast<APlayerController>(GetController());
-	const bool bLocallyControlled = (PC ? PC->IsLocalController() : false);
-	const uint32 UniqueID = GetUniqueID();
-	FAudioThread::RunCommandOnAudioThread([UniqueID, bLocallyControlled]()
+	return bNeedsUpdates;
+}
+
+void AShooterCharacter::UpdateLowHealthSound()
+{
+	if (LowHealthSound == nullptr || !GEngine->UseSound() || GetNetMode() == NM_DedicatedServer)
 	{
-	    USoundNodeLocalPlayer::GetLocallyControlledActorCache().Add(UniqueID, bLocallyControlled);
-	});
-	
-	TArray<FVector> PointsToTest;
-	BuildPauseReplicationCheckPoints(PointsToTest);
+		return;
+	}
 
-	if (NetVisualizeRelevancyTestPoints == 1)
+	if ((this->Health > 0 && this->Health < this->GetMaxHealth() * LowHealthPercentage) && (!LowHealthWarningPlayer || !LowHealthWarningPlayer->IsPlaying()))
 	{
-		for (FVector PointToTest : PointsToTest)
+		LowHealthWarningPlayer = UGameplayStatics::SpawnSoundAttached(LowHealthSound, GetRootComponent(),
+			NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, true);
+		if (LowHealthWarningPlayer)
 		{
-			DrawDebugSphere(GetWorld(), PointToTest, 10.0f, 8, FColor::Red);
+			LowHealthWarningPlayer->SetVolumeMultiplier(0.0f);
 		}
 	}
+	else if ((this->Health > this->GetMaxHealth() * LowHealthPercentage || this->Health < 0) && LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
+	{
+		LowHealthWarningPlayer->Stop();
+	}
+
+	// volume only depends on health, so it only changes along with it
+	if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
+	{
+		const float MinVolume = 0.3f;
+		const float VolumeMultiplier = (1.0f - (this->Health / (this->GetMaxHealth() * LowHealthPercentage)));
+		LowHealthWarningPlayer->SetVolumeMultiplier(MinVolume + (1.0f - MinVolume) * VolumeMultiplier);
+	}
+}
+
+void AShooterCharacter::OnRep_Health()
+{
+	UpdateLowHealthSound();
+}
+
+void AShooterCharacter::OnRep_WantsToRun()
+{
+	if (bWantsToRun)
+	{
+		RequestFrameUpdates();
+	}
 }
 
 void AShooterCharacter::BeginDestroy()
@@ -1142,11 +1217,7 @@ void AShooterCharacter::BeginDestroy()
 
 	if (!GExitPurge)
 	{
-		const uint32 UniqueID = GetUniqueID();
-		FAudioThread::RunCommandOnAudioThread([UniqueID]()
-		{
-			USoundNodeLocalPlayer::GetLocallyControlledActorCache().Remove(UniqueID);
-		});
+		FShooterLocallyControlledActors::Remove(GetUniqueID());
 	}
 }
 
@@ -1300,14 +1371,6 @@ float AShooterCharacter::GetLowHealthPercentage() const
 	return LowHealthPercentage;
 }
 
-void AShooterCharacter::UpdateTeamColorsAllMIDs()
-{
-	for (int32 i = 0; i < MeshMIDs.Num(); ++i)
-	{
-		UpdateTeamColors(MeshMIDs[i]);
-	}
-}
-
 void AShooterCharacter::BuildPauseReplicationCheckPoints(TArray<FVector>& RelevancyCheckPoints)
 {
 	FBoxSphereBounds Bounds = GetCapsuleComponent()->CalcBounds(GetCapsuleComponent()->GetComponentTransform());
@@ -2,6 +2,27 @@
 
 #include "ShooterGame.h"
 #include "Player/ShooterCharacterMovement.h"
+#include "Online/ShooterServerTelemetry.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterMovement"), STATGROUP_ShooterMovement, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Client Corrections"), STAT_ShooterMovement_Corrections, STATGROUP_ShooterMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Corrections"), STAT_ShooterMovement_ServerCorrections, STATGROUP_ShooterMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Upstream Bytes/s"), STAT_ShooterMovement_UpstreamBytesPerSecond, STATGROUP_ShooterMovement);
+
+float CVar_ShooterMovement_NetStatsInterval = 0.0f;
+static FAutoConsoleVariableRef CVarShooterMovementNetStatsInterval(TEXT("ShooterMovement.NetStatsInterval"), CVar_ShooterMovement_NetStatsInterval, TEXT("Seconds between logs of corrections and upstream bandwidth of the local player, 0 to disable"), ECVF_Default );
+
+float CVar_ShooterMovement_MaxSmoothTime = 0.3f;
+static FAutoConsoleVariableRef CVarShooterMovementMaxSmoothTime(TEXT("ShooterMovement.MaxSmoothTime"), CVar_ShooterMovement_MaxSmoothTime, TEXT("Longest smoothing of simulated pawns, however rarely their updates arrive"), ECVF_Default );
+
+namespace
+{
+	/** compressed move flags, the engine keeps Custom_0 to Custom_3 for games */
+	const uint8 FLAG_WantsToRun = FSavedMove_Character::FLAG_Custom_0;
+	const uint8 FLAG_RunToggled = FSavedMove_Character::FLAG_Custom_1;
+	const uint8 FLAG_IsTargeting = FSavedMove_Character::FLAG_Custom_2;
+}
 
 //----------------------------------------------------------------------//
 // UPawnMovementComponent
@@ -9,6 +30,11 @@
 UShooterCharacterMovement::UShooterCharacterMovement(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	NumCorrections = 0;
+	NumCorrectionsReceived = 0;
+	LastNetStatsReportTime = 0.0f;
+	LastSimulatedUpdateTime = 0.0f;
+	SimulatedUpdateInterval = 0.0f;
 }
 
 
@@ -31,3 +57,213 @@ float UShooterCharacterMovement::GetMaxSpeed() const
 
 	return MaxSpeed;
 }
+
+void UShooterCharacterMovement::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	// the owning client already set its own state, only the server follows the flags
+	AShooterCharacter* ShooterCharacterOwner = Cast<AShooterCharacter>(CharacterOwner);
+	if (ShooterCharacterOwner == nullptr || ShooterCharacterOwner->GetLocalRole() < ROLE_Authority || ShooterCharacterOwner->IsLocallyControlled())
+	{
+		return;
+	}
+
+	const bool bWantsToRun = (Flags & FLAG_WantsToRun) != 0;
+	const bool bRunToggled = (Flags & FLAG_RunToggled) != 0;
+	if (bWantsToRun != ShooterCharacterOwner->WantsToRun() || bRunToggled != ShooterCharacterOwner->IsRunToggled())
+	{
+		ShooterCharacterOwner->SetRunning(bWantsToRun, bRunToggled);
+	}
+
+	const bool bIsTargeting = (Flags & FLAG_IsTargeting) != 0;
+	if (bIsTargeting != ShooterCharacterOwner->IsTargeting())
+	{
+		ShooterCharacterOwner->SetTargeting(bIsTargeting);
+	}
+}
+
+FNetworkPredictionData_Client* UShooterCharacterMovement::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UShooterCharacterMovement* MutableThis = const_cast<UShooterCharacterMovement*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Shooter(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UShooterCharacterMovement::SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation)
+{
+	if (CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		const float Now = GetWorld()->GetTimeSeconds();
+		if (LastSimulatedUpdateTime > 0.0f)
+		{
+			// averaged so a single late packet doesn't stretch the smoothing
+			const float Interval = FMath::Min(Now - LastSimulatedUpdateTime, CVar_ShooterMovement_MaxSmoothTime);
+			SimulatedUpdateInterval = SimulatedUpdateInterval > 0.0f ? FMath::Lerp(SimulatedUpdateInterval, Interval, 0.25f) : Interval;
+
+			const UShooterCharacterMovement* DefaultMovement = GetClass()->GetDefaultObject<UShooterCharacterMovement>();
+			NetworkSimulatedSmoothLocationTime = FMath::Clamp(SimulatedUpdateInterval, DefaultMovement->NetworkSimulatedSmoothLocationTime, FMath::Max(CVar_ShooterMovement_MaxSmoothTime, DefaultMovement->NetworkSimulatedSmoothLocationTime));
+			NetworkSimulatedSmoothRotationTime = FMath::Clamp(SimulatedUpdateInterval, DefaultMovement->NetworkSimulatedSmoothRotationTime, FMath::Max(CVar_ShooterMovement_MaxSmoothTime, DefaultMovement->NetworkSimulatedSmoothRotationTime));
+		}
+		LastSimulatedUpdateTime = Now;
+	}
+
+	Super::SmoothCorrection(OldLocation, OldRotation, NewLocation, NewRotation);
+}
+
+void UShooterCharacterMovement::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		ReportNetStats();
+	}
+}
+
+bool UShooterCharacterMovement::ClientUpdatePositionAfterServerUpdate()
+{
+	AShooterCharacter* ShooterCharacterOwner = Cast<AShooterCharacter>(CharacterOwner);
+	if (ShooterCharacterOwner == nullptr)
+	{
+		return Super::ClientUpdatePositionAfterServerUpdate();
+	}
+
+	const bool bRealWantsToRun = ShooterCharacterOwner->WantsToRun();
+	const bool bRealRunToggled = ShooterCharacterOwner->IsRunToggled();
+	const bool bRealIsTargeting = ShooterCharacterOwner->IsTargeting();
+
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	ShooterCharacterOwner->SetMoveInput(bRealWantsToRun, bRealRunToggled, bRealIsTargeting);
+	return bResult;
+}
+
+void UShooterCharacterMovement::OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+	NumCorrections++;
+	NumCorrectionsReceived++;
+	INC_DWORD_STAT(STAT_ShooterMovement_Corrections);
+}
+
+void UShooterCharacterMovement::SendClientAdjustment()
+{
+	// a pending adjustment that doesn't just acknowledge a good move is a correction
+	const FNetworkPredictionData_Server_Character* ServerData = HasPredictionData_Server() ? GetPredictionData_Server_Character() : nullptr;
+	if (ServerData && ServerData->PendingAdjustment.TimeStamp > 0.0f && !ServerData->PendingAdjustment.bAckGoodMove)
+	{
+		FShooterServerTelemetry::AddClientCorrection();
+		INC_DWORD_STAT(STAT_ShooterMovement_ServerCorrections);
+	}
+
+	Super::SendClientAdjustment();
+}
+
+void UShooterCharacterMovement::ReportNetStats()
+{
+	// the whole connection goes upstream, but moves are by far the biggest part of it
+	const UNetConnection* NetConnection = CharacterOwner->GetNetConnection();
+	const int32 UpstreamBytesPerSecond = NetConnection ? NetConnection->OutBytesPerSecond : 0;
+	SET_DWORD_STAT(STAT_ShooterMovement_UpstreamBytesPerSecond, UpstreamBytesPerSecond);
+
+	if (CVar_ShooterMovement_NetStatsInterval <= 0.0f)
+	{
+		return;
+	}
+
+	const float Now = GetWorld()->GetRealTimeSeconds();
+	const float Elapsed = Now - LastNetStatsReportTime;
+	if (Elapsed >= CVar_ShooterMovement_NetStatsInterval)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Movement: %d corrections in %.1fs, upstream %d bytes/s"), NumCorrections, Elapsed, UpstreamBytesPerSecond);
+
+		NumCorrections = 0;
+		LastNetStatsReportTime = Now;
+	}
+}
+
+//----------------------------------------------------------------------//
+// FSavedMove_Shooter
+//----------------------------------------------------------------------//
+void FSavedMove_Shooter::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToRun = false;
+	bSavedRunToggled = false;
+	bSavedIsTargeting = false;
+}
+
+uint8 FSavedMove_Shooter::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bSavedWantsToRun)
+	{
+		Result |= FLAG_WantsToRun;
+	}
+	if (bSavedRunToggled)
+	{
+		Result |= FLAG_RunToggled;
+	}
+	if (bSavedIsTargeting)
+	{
+		Result |= FLAG_IsTargeting;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_Shooter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_Shooter* NewShooterMove = static_cast<const FSavedMove_Shooter*>(NewMove.Get());
+	if (bSavedWantsToRun != NewShooterMove->bSavedWantsToRun || bSavedRunToggled != NewShooterMove->bSavedRunToggled || bSavedIsTargeting != NewShooterMove->bSavedIsTargeting)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Shooter::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	const AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(C);
+	if (ShooterCharacter)
+	{
+		bSavedWantsToRun = ShooterCharacter->WantsToRun();
+		bSavedRunToggled = ShooterCharacter->IsRunToggled();
+		bSavedIsTargeting = ShooterCharacter->IsTargeting();
+	}
+}
+
+void FSavedMove_Shooter::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(C);
+	if (ShooterCharacter)
+	{
+		ShooterCharacter->SetMoveInput(bSavedWantsToRun, bSavedRunToggled, bSavedIsTargeting);
+	}
+}
+
+//----------------------------------------------------------------------//
+// FNetworkPredictionData_Client_Shooter
+//----------------------------------------------------------------------//
+FNetworkPredictionData_Client_Shooter::FNetworkPredictionData_Client_Shooter(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Shooter::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Shooter());
+}
@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Player/ShooterCharacterUpdater.h"
+
+DECLARE_STATS_GROUP(TEXT("ShooterCharacters"), STATGROUP_ShooterCharacters, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Update Characters"), STAT_ShooterCharacters_Update, STATGROUP_ShooterCharacters);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters Updated"), STAT_ShooterCharacters_Updated, STATGROUP_ShooterCharacters);
+
+void FShooterCharacterUpdater::RequestUpdates(AShooterCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void FShooterCharacterUpdater::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterCharacters_Update);
+
+	for (int32 i = Characters.Num() - 1; i >= 0; i--)
+	{
+		AShooterCharacter* Character = Characters[i].Get();
+		if (Character == nullptr || Character->IsPendingKill())
+		{
+			Characters.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		// same as the actor tick would, no updates while paused and the world's time dilation applies
+		UWorld* World = Character->GetWorld();
+		if (World == nullptr || World->IsPaused())
+		{
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_ShooterCharacters_Updated);
+
+		if (!Character->UpdateFrameState(World->GetDeltaSeconds()))
+		{
+			Characters.RemoveAtSwap(i, 1, false);
+		}
+	}
+}
+
+TStatId FShooterCharacterUpdater::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FShooterCharacterUpdater, STATGROUP_Tickables);
+}
@@ -6,11 +6,28 @@
 #include "UI/Widgets/SShooterDemoHUD.h"
 #include "Engine/DemoNetDriver.h"
 
+DECLARE_STATS_GROUP(TEXT("ShooterReplay"), STATGROUP_ShooterReplay, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Seeks"), STAT_ShooterReplay_Seeks, STATGROUP_ShooterReplay);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Seek (ms)"), STAT_ShooterReplay_LastSeekTime, STATGROUP_ShooterReplay);
+
+float CVar_ShooterReplay_CosmeticSpeedLimit = 4.0f;
+static FAutoConsoleVariableRef CVarShooterReplayCosmeticSpeedLimit(TEXT("ShooterReplay.CosmeticSpeedLimit"), CVar_ShooterReplay_CosmeticSpeedLimit, TEXT("Impact effects, sounds and the HUD are skipped when a replay plays faster than this, 0 to never skip them"), ECVF_Default );
+
+int32 CVar_ShooterReplay_HideWorldWhileSeeking = 1;
+static FAutoConsoleVariableRef CVarShooterReplayHideWorldWhileSeeking(TEXT("ShooterReplay.HideWorldWhileSeeking"), CVar_ShooterReplay_HideWorldWhileSeeking, TEXT("If 1, the world isn't rendered while a replay seeks"), ECVF_Default );
+
 AShooterDemoSpectator::AShooterDemoSpectator(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	bShowMouseCursor = true;
 	PrimaryActorTick.bTickEvenWhenPaused = true;
 	bShouldPerformFullTickWhenPaused = true;
+
+	PendingSeekTime = -1.0f;
+	SeekStartTime = 0.0;
+	LastSeekDuration = 0.0f;
+	bSeeking = false;
+	bWorldRenderingSuppressed = false;
 }
 
 void AShooterDemoSpectator::SetupInputComponent()
@@ -67,24 +84,105 @@ void AShooterDemoSpectator::OnToggleInGameMenu()
 	}
 }
 
-static float PlaybackSpeedLUT[5] = { 0.1f, 0.5f, 1.0f, 2.0f, 4.0f };
+// the fastest speeds only stay smooth because cosmetic work is skipped, see ShouldSkipCosmetics
+static float PlaybackSpeedLUT[7] = { 0.1f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f };
 
 void AShooterDemoSpectator::OnIncreasePlaybackSpeed()
 {
-	PlaybackSpeed = FMath::Clamp( PlaybackSpeed + 1, 0, 4 );
+	PlaybackSpeed = FMath::Clamp( PlaybackSpeed + 1, 0, (int32)UE_ARRAY_COUNT(PlaybackSpeedLUT) - 1 );
 
 	GetWorldSettings()->DemoPlayTimeDilation = PlaybackSpeedLUT[ PlaybackSpeed ];
 }
 
 void AShooterDemoSpectator::OnDecreasePlaybackSpeed()
 {
-	PlaybackSpeed = FMath::Clamp( PlaybackSpeed - 1, 0, 4 );
+	PlaybackSpeed = FMath::Clamp( PlaybackSpeed - 1, 0, (int32)UE_ARRAY_COUNT(PlaybackSpeedLUT) - 1 );
 
 	GetWorldSettings()->DemoPlayTimeDilation = PlaybackSpeedLUT[ PlaybackSpeed ];
 }
 
+void AShooterDemoSpectator::SeekTo(float TimeInSeconds)
+{
+	UDemoNetDriver* DemoDriver = GetWorld() ? GetWorld()->GetDemoNetDriver() : nullptr;
+	if (DemoDriver == nullptr)
+	{
+		return;
+	}
+
+	TimeInSeconds = FMath::Clamp(TimeInSeconds, 0.0f, DemoDriver->GetDemoTotalTime());
+
+	if (bSeeking)
+	{
+		// scrubbing the timeline, only the last requested time matters
+		PendingSeekTime = TimeInSeconds;
+		return;
+	}
+
+	bSeeking = true;
+	PendingSeekTime = -1.0f;
+	SeekStartTime = FPlatformTime::Seconds();
+	INC_DWORD_STAT(STAT_ShooterReplay_Seeks);
+
+	// nobody needs to see the frames the driver fast-forwards through
+	SetWorldRenderingSuppressed(CVar_ShooterReplay_HideWorldWhileSeeking != 0);
+
+	DemoDriver->GotoTimeInSeconds(TimeInSeconds, FOnGotoTimeDelegate::CreateUObject(this, &AShooterDemoSpectator::OnSeekComplete));
+}
+
+void AShooterDemoSpectator::OnSeekComplete(bool bWasSuccessful)
+{
+	bSeeking = false;
+	LastSeekDuration = FPlatformTime::Seconds() - SeekStartTime;
+	SET_FLOAT_STAT(STAT_ShooterReplay_LastSeekTime, LastSeekDuration * 1000.0f);
+
+	UE_LOG(LogShooter, Log, TEXT("Replay seek %s in %.1f ms"), bWasSuccessful ? TEXT("completed") : TEXT("failed"), LastSeekDuration * 1000.0f);
+
+	if (PendingSeekTime >= 0.0f)
+	{
+		SeekTo(PendingSeekTime);
+	}
+	else
+	{
+		SetWorldRenderingSuppressed(false);
+	}
+}
+
+void AShooterDemoSpectator::SetWorldRenderingSuppressed(bool bSuppressed)
+{
+	if (bWorldRenderingSuppressed == bSuppressed)
+	{
+		return;
+	}
+
+	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
+	if (LocalPlayer && LocalPlayer->ViewportClient)
+	{
+		LocalPlayer->ViewportClient->bDisableWorldRendering = bSuppressed;
+		bWorldRenderingSuppressed = bSuppressed;
+	}
+}
+
+bool AShooterDemoSpectator::ShouldSkipCosmetics(const UWorld* World)
+{
+	if (World == nullptr || !World->IsPlayingReplay())
+	{
+		return false;
+	}
+
+	const UDemoNetDriver* DemoDriver = World->GetDemoNetDriver();
+	if (DemoDriver && DemoDriver->IsFastForwarding())
+	{
+		return true;
+	}
+
+	const AWorldSettings* WorldSettings = World->GetWorldSettings();
+	return WorldSettings && CVar_ShooterReplay_CosmeticSpeedLimit > 0.0f && WorldSettings->DemoPlayTimeDilation > CVar_ShooterReplay_CosmeticSpeedLimit;
+}
+
 void AShooterDemoSpectator::Destroyed()
 {
+	SetWorldRenderingSuppressed(false);
+
 	if (GEngine != nullptr && GEngine->GameViewport != nullptr && DemoHUD.IsValid())
 	{
 		// Remove HUD
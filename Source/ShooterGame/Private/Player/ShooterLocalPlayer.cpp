@@ -23,34 +23,64 @@ UShooterPersistentUser* UShooterLocalPlayer::GetPersistentUser() const
 	return PersistentUser;
 }
 
-void UShooterLocalPlayer::LoadPersistentUser()
+void UShooterLocalPlayer::GetPersistentUserSlot(FString& OutSlotName, int32& OutUserIndex) const
 {
-	FString SaveGameName = GetNickname();
+	OutSlotName = GetNickname();
 
 #if PLATFORM_SWITCH
 	// on Switch, the displayable nickname can change, so we can't use it as a save ID (explicitly stated in docs, so changing for pre-cert)
-	FPlatformMisc::GetUniqueStringNameForControllerId(GetControllerId(), SaveGameName);
+	FPlatformMisc::GetUniqueStringNameForControllerId(GetControllerId(), OutSlotName);
 #endif
 
+	// Use the platform id here to be resilient in the face of controller swapping and similar situations.
+	FPlatformUserId PlatformId = GetControllerId();
+
+	IOnlineIdentityPtr Identity = Online::GetIdentityInterface(GetWorld());
+	if (Identity.IsValid() && GetPreferredUniqueNetId().IsValid())
+	{
+		PlatformId = Identity->GetPlatformUserIdFromUniqueNetId(*GetPreferredUniqueNetId());
+	}
+
+	OutUserIndex = PlatformId;
+}
+
+void UShooterLocalPlayer::LoadPersistentUser()
+{
+	FString SaveGameName;
+	int32 SaveGameUserIndex;
+	GetPersistentUserSlot(SaveGameName, SaveGameUserIndex);
+
 	// if we changed controllerid / user, then we need to load the appropriate persistent user.
 	if (PersistentUser != nullptr && ( GetControllerId() != PersistentUser->GetUserIndex() || SaveGameName != PersistentUser->GetName() ) )
 	{
-		PersistentUser->SaveIfDirty();
+		FlushPersistentUser();
 		PersistentUser = nullptr;
 	}
 
 	if (PersistentUser == NULL)
 	{
-		// Use the platform id here to be resilient in the face of controller swapping and similar situations.
-		FPlatformUserId PlatformId = GetControllerId();
+		PersistentUser = UShooterPersistentUser::LoadPersistentUser(SaveGameName, SaveGameUserIndex );
+	}
+}
 
-		IOnlineIdentityPtr Identity = Online::GetIdentityInterface(GetWorld());
-		if (Identity.IsValid() && GetPreferredUniqueNetId().IsValid())
-		{
-			PlatformId = Identity->GetPlatformUserIdFromUniqueNetId(*GetPreferredUniqueNetId());
-		}
+void UShooterLocalPlayer::PrefetchPersistentUser()
+{
+	if (PersistentUser == nullptr)
+	{
+		FString SaveGameName;
+		int32 SaveGameUserIndex;
+		GetPersistentUserSlot(SaveGameName, SaveGameUserIndex);
 
-		PersistentUser = UShooterPersistentUser::LoadPersistentUser(SaveGameName, PlatformId );
+		UShooterPersistentUser::PrefetchPersistentUser(SaveGameName, SaveGameUserIndex);
+	}
+}
+
+void UShooterLocalPlayer::FlushPersistentUser()
+{
+	if (PersistentUser != nullptr)
+	{
+		PersistentUser->SaveIfDirty();
+		PersistentUser->FlushPendingSave();
 	}
 }
 
@@ -68,7 +98,7 @@ void UShooterLocalPlayer::SetControllerId(int32 NewControllerId)
 	// if we changed controllerid / user, then we need to load the appropriate persistent user.
 	if (PersistentUser != nullptr && ( GetControllerId() != PersistentUser->GetUserIndex() || SaveGameName != PersistentUser->GetName() ) )
 	{
-		PersistentUser->SaveIfDirty();
+		FlushPersistentUser();
 		PersistentUser = nullptr;
 	}
 
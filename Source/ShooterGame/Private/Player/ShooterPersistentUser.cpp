@@ -3,11 +3,75 @@
 #include "ShooterGame.h"
 #include "Player/ShooterPersistentUser.h"
 #include "ShooterLocalPlayer.h"
+#include "Async/Async.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+
+float CVar_ShooterSave_Debounce = 1.0f;
+static FAutoConsoleVariableRef CVarShooterSaveDebounce(TEXT("ShooterSave.Debounce"), CVar_ShooterSave_Debounce, TEXT("Persistent user saves are written once no other save was requested for this many seconds"), ECVF_Default );
+
+namespace
+{
+	/** save data read ahead of LoadPersistentUser, by slot */
+	TMap<FString, TFuture<TArray<uint8>>> PrefetchedSaves;
+
+	FString GetPrefetchKey(const FString& SlotName, const int32 UserIndex)
+	{
+		return FString::Printf(TEXT("%s_%d"), *SlotName, UserIndex);
+	}
+
+#if PLATFORM_DESKTOP
+	/** same location the generic save game system uses, so UGameplayStatics keeps finding our saves */
+	FString GetSaveGameFilename(const FString& SlotName)
+	{
+		return FString::Printf(TEXT("%sSaveGames/%s.sav"), *FPaths::ProjectSavedDir(), *SlotName);
+	}
+#endif
+
+	/** safe to call from any thread */
+	bool WriteSaveData(const FString& SlotName, const int32 UserIndex, const TArray<uint8>& Data)
+	{
+#if PLATFORM_DESKTOP
+		// write next to the save and swap it in, so a crash or full disk mid write never leaves a truncated save behind
+		const FString Filename = GetSaveGameFilename(SlotName);
+		const FString TempFilename = Filename + TEXT(".tmp");
+		if (FFileHelper::SaveArrayToFile(Data, *TempFilename) && IFileManager::Get().Move(*Filename, *TempFilename, true, true))
+		{
+			return true;
+		}
+
+		IFileManager::Get().Delete(*TempFilename, false, false, true);
+		return false;
+#else
+		ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+		return SaveSystem && SaveSystem->SaveGame(false, *SlotName, UserIndex, Data);
+#endif
+	}
+
+	/** safe to call from any thread, returns an empty array if there is no save */
+	TArray<uint8> ReadSaveData(const FString& SlotName, const int32 UserIndex)
+	{
+		TArray<uint8> Data;
+#if PLATFORM_DESKTOP
+		FFileHelper::LoadFileToArray(Data, *GetSaveGameFilename(SlotName), FILEREAD_Silent);
+#else
+		ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+		if (SaveSystem && SaveSystem->DoesSaveGameExist(*SlotName, UserIndex))
+		{
+			SaveSystem->LoadGame(false, *SlotName, UserIndex, Data);
+		}
+#endif
+		return Data;
+	}
+}
 
 UShooterPersistentUser::UShooterPersistentUser(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	SetToDefaults();
+
+	bSavePending = false;
+	LastSaveRequestTime = 0.0;
 }
 
 void UShooterPersistentUser::SetToDefaults()
@@ -101,8 +165,123 @@ bool UShooterPersistentUser::IsInvertedYAxisDirty() const
 
 void UShooterPersistentUser::SavePersistentUser()
 {
-	UGameplayStatics::SaveGameToSlot(this, SlotName, UserIndex);
+	// serialized when the save is actually written, so it picks up every change made in between
+	bSavePending = true;
 	bIsDirty = false;
+	LastSaveRequestTime = FPlatformTime::Seconds();
+
+	if (!SaveTickerHandle.IsValid())
+	{
+		SaveTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UShooterPersistentUser::TickPendingSave));
+	}
+}
+
+bool UShooterPersistentUser::TickPendingSave(float DeltaSeconds)
+{
+	if (PendingWrite.IsValid())
+	{
+		if (!PendingWrite.IsReady())
+		{
+			return true;
+		}
+
+		if (!PendingWrite.Get())
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Failed to write persistent user %s, will retry on next save."), *SlotName);
+			bIsDirty = true;
+		}
+		PendingWrite = TFuture<bool>();
+	}
+
+	if (bSavePending && FPlatformTime::Seconds() - LastSaveRequestTime >= CVar_ShooterSave_Debounce)
+	{
+		WriteSave();
+	}
+
+	if (bSavePending || PendingWrite.IsValid())
+	{
+		return true;
+	}
+
+	SaveTickerHandle.Reset();
+	return false;
+}
+
+void UShooterPersistentUser::WriteSave()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(UShooterPersistentUser_WriteSave);
+
+	bSavePending = false;
+
+	// read ahead data of this slot is outdated now
+	PrefetchedSaves.Remove(GetPrefetchKey(SlotName, UserIndex));
+
+	TArray<uint8> Data;
+	if (!UGameplayStatics::SaveGameToMemory(this, Data))
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Failed to serialize persistent user %s."), *SlotName);
+		return;
+	}
+
+	// only one write per user at a time, so writes can't land out of order
+	check(!PendingWrite.IsValid());
+	PendingWrite = Async(EAsyncExecution::ThreadPool, [SlotName = SlotName, UserIndex = UserIndex, Data = MoveTemp(Data)]()
+	{
+		return WriteSaveData(SlotName, UserIndex, Data);
+	});
+}
+
+void UShooterPersistentUser::FlushPendingSave()
+{
+	if (PendingWrite.IsValid())
+	{
+		// write again right away if it failed
+		bSavePending |= !PendingWrite.Get();
+		PendingWrite = TFuture<bool>();
+	}
+
+	if (bSavePending)
+	{
+		WriteSave();
+	}
+
+	if (PendingWrite.IsValid())
+	{
+		if (!PendingWrite.Get())
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Failed to write persistent user %s."), *SlotName);
+		}
+		PendingWrite = TFuture<bool>();
+	}
+
+	if (SaveTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+		SaveTickerHandle.Reset();
+	}
+}
+
+void UShooterPersistentUser::PrefetchPersistentUser(const FString& SlotName, const int32 UserIndex)
+{
+	if (SlotName.Len() == 0 || GIsBuildMachine)
+	{
+		return;
+	}
+
+	const FString Key = GetPrefetchKey(SlotName, UserIndex);
+	if (!PrefetchedSaves.Contains(Key))
+	{
+		PrefetchedSaves.Add(Key, Async(EAsyncExecution::ThreadPool, [SlotName, UserIndex]()
+		{
+			return ReadSaveData(SlotName, UserIndex);
+		}));
+	}
+}
+
+void UShooterPersistentUser::ClearPrefetchedSaves()
+{
+	// reads still in flight finish on their own, nobody waits for them anymore
+	PrefetchedSaves.Empty();
 }
 
 UShooterPersistentUser* UShooterPersistentUser::LoadPersistentUser(FString SlotName, const int32 UserIndex)
@@ -113,7 +292,20 @@ UShooterPersistentUser* UShooterPersistentUser::LoadPersistentUser(FString SlotN
 	// Persistent users aren't valid in this state.
 	if (SlotName.Len() > 0)
 	{
-		if (!GIsBuildMachine && UGameplayStatics::DoesSaveGameExist(SlotName, UserIndex))
+		// use data read in the background if we have it, only deserializing is left to do here
+		const FString PrefetchKey = GetPrefetchKey(SlotName, UserIndex);
+		if (TFuture<TArray<uint8>>* Prefetched = PrefetchedSaves.Find(PrefetchKey))
+		{
+			const TArray<uint8> Data = Prefetched->Get();
+			PrefetchedSaves.Remove(PrefetchKey);
+
+			if (Data.Num() > 0)
+			{
+				Result = Cast<UShooterPersistentUser>(UGameplayStatics::LoadGameFromMemory(Data));
+			}
+		}
+
+		if (Result == nullptr && !GIsBuildMachine && UGameplayStatics::DoesSaveGameExist(SlotName, UserIndex))
 		{
 			Result = Cast<UShooterPersistentUser>(UGameplayStatics::LoadGameFromSlot(SlotName, UserIndex));
 		}
@@ -19,34 +19,13 @@
 #include "ShooterGameInstance.h"
 #include "ShooterLeaderboards.h"
 #include "ShooterGameViewportClient.h"
-#include "Sound/SoundNodeLocalPlayer.h"
+#include "Sound/ShooterLocallyControlledActors.h"
+#include "Online/ShooterMatchResults.h"
 #include "AudioThread.h"
 #include "OnlineSubsystemUtils.h"
 
 #define  ACH_FRAG_SOMEONE	TEXT("ACH_FRAG_SOMEONE")
-#define  ACH_SOME_KILLS		TEXT("ACH_SOME_KILLS")
-#define  ACH_LOTS_KILLS		TEXT("ACH_LOTS_KILLS")
-#define  ACH_FINISH_MATCH	TEXT("ACH_FINISH_MATCH")
-#define  ACH_LOTS_MATCHES	TEXT("ACH_LOTS_MATCHES")
-#define  ACH_FIRST_WIN		TEXT("ACH_FIRST_WIN")
-#define  ACH_LOTS_WIN		TEXT("ACH_LOTS_WIN")
-#define  ACH_MANY_WIN		TEXT("ACH_MANY_WIN")
-#define  ACH_SHOOT_BULLETS	TEXT("ACH_SHOOT_BULLETS")
-#define  ACH_SHOOT_ROCKETS	TEXT("ACH_SHOOT_ROCKETS")
-#define  ACH_GOOD_SCORE		TEXT("ACH_GOOD_SCORE")
-#define  ACH_GREAT_SCORE	TEXT("ACH_GREAT_SCORE")
-#define  ACH_PLAY_SANCTUARY	TEXT("ACH_PLAY_SANCTUARY")
-#define  ACH_PLAY_HIGHRISE	TEXT("ACH_PLAY_HIGHRISE")
-
-static const int32 SomeKillsCount = 10;
-static const int32 LotsKillsCount = 20;
-static const int32 LotsMatchesCount = 5;
-static const int32 LotsWinsCount = 3;
-static const int32 ManyWinsCount = 5;
-static const int32 LotsBulletsCount = 100;
-static const int32 LotsRocketsCount = 10;
-static const int32 GoodScoreCount = 10;
-static const int32 GreatScoreCount = 15;
+
 
 #if !defined(TRACK_STATS_LOCALLY)
 #define TRACK_STATS_LOCALLY 1
@@ -70,6 +49,7 @@ AShooterPlayerController::AShooterPlayerController(const FObjectInitializer& Obj
 	bHasQueriedPlatformStats = false;
 	bHasQueriedPlatformAchievements = false;
 	bHasInitializedInputComponent = false;
+	LocallyControlledSlot = INDEX_NONE;
 }
 
 void AShooterPlayerController::SetupInputComponent()
@@ -158,13 +138,6 @@ void AShooterPlayerController::TickActor(float DeltaTime, enum ELevelTick TickTy
 			}
 		}
 	}
-
-	const bool bLocallyControlled = IsLocalController();
-	const uint32 UniqueID = GetUniqueID();
-	FAudioThread::RunCommandOnAudioThread([UniqueID, bLocallyControlled]()
-	{
-		USoundNodeLocalPlayer::GetLocallyControlledActorCache().Add(UniqueID, bLocallyControlled);
-	});
 };
 
 void AShooterPlayerController::BeginDestroy()
@@ -177,11 +150,31 @@ void AShooterPlayerController::BeginDestroy()
 
 	if (!GExitPurge)
 	{
-		const uint32 UniqueID = GetUniqueID();
-		FAudioThread::RunCommandOnAudioThread([UniqueID]()
-		{
-			USoundNodeLocalPlayer::GetLocallyControlledActorCache().Remove(UniqueID);
-		});
+		FShooterLocallyControlledActors::ReleaseSlot(LocallyControlledSlot);
+		LocallyControlledSlot = INDEX_NONE;
+	}
+}
+
+void AShooterPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FShooterLocallyControlledActors::ReleaseSlot(LocallyControlledSlot);
+	LocallyControlledSlot = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterPlayerController::SetPawn(APawn* InPawn)
+{
+	Super::SetPawn(InPawn);
+
+	PublishLocallyControlledActors();
+}
+
+void AShooterPlayerController::PublishLocallyControlledActors()
+{
+	if (LocallyControlledSlot != INDEX_NONE)
+	{
+		FShooterLocallyControlledActors::Publish(LocallyControlledSlot, GetUniqueID(), GetPawn() ? GetPawn()->GetUniqueID() : 0);
 	}
 }
 
@@ -197,6 +190,13 @@ void AShooterPlayerController::SetPlayer( UPlayer* InPlayer )
 
 		FInputModeGameOnly InputMode;
 		SetInputMode(InputMode);
+
+		// lets USoundNodeLocalPlayer pick the local branch for our sounds
+		if (LocallyControlledSlot == INDEX_NONE)
+		{
+			LocallyControlledSlot = FShooterLocallyControlledActors::AcquireSlot();
+		}
+		PublishLocallyControlledActors();
 	}
 }
 
@@ -646,6 +646,12 @@ void AShooterPlayerController::SetInfiniteClip(bool bEnable)
 void AShooterPlayerController::SetHealthRegen(bool bEnable)
 {
 	bHealthRegen = bEnable;
+
+	AShooterCharacter* MyPawn = Cast<AShooterCharacter>(GetPawn());
+	if (bEnable && MyPawn)
+	{
+		MyPawn->RequestFrameUpdates();
+	}
 }
 
 void AShooterPlayerController::SetGodMode(bool bEnable)
@@ -835,10 +841,8 @@ void AShooterPlayerController::ClientGameEnded_Implementation(class AActor* EndG
 		ShooterHUD->SetMatchState(bIsWinner ? EShooterMatchState::Won : EShooterMatchState::Lost);
 	}
 
-	UpdateSaveFileOnGameEnd(bIsWinner);
-	UpdateAchievementsOnGameEnd();
-	UpdateLeaderboardsOnGameEnd();
-	UpdateStatsOnGameEnd(bIsWinner);
+	// posted over the next frames, so the scoreboard opens without a hitch
+	SubmitMatchResults(bIsWinner);
 
 	// Flag that the game has just ended (if it's ended due to host loss we want to wait for ClientReturnToMainMenu_Implementation first, incase we don't want to process)
 	bGameEndedFrame = true;
@@ -1049,17 +1053,57 @@ void AShooterPlayerController::ClientTeamMessage_Implementation( APlayerState* S
 
 void AShooterPlayerController::Say( const FString& Msg )
 {
-	ServerSay(Msg.Left(128));
+	ServerSay(Msg.Left(128), false);
 }
 
-bool AShooterPlayerController::ServerSay_Validate( const FString& Msg )
+void AShooterPlayerController::TeamSay( const FString& Msg )
+{
+	ServerSay(Msg.Left(128), true);
+}
+
+bool AShooterPlayerController::ServerSay_Validate( const FString& Msg, bool bTeamOnly )
 {
 	return true;
 }
 
-void AShooterPlayerController::ServerSay_Implementation( const FString& Msg )
+void AShooterPlayerController::ServerSay_Implementation( const FString& Msg, bool bTeamOnly )
 {
-	GetWorld()->GetAuthGameMode<AShooterGameMode>()->Broadcast(this, Msg, ServerSayString);
+	// batched and rate limited, see FShooterChatRouter
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode && GameMode->GetChatRouter().IsValid())
+	{
+		GameMode->GetChatRouter()->SubmitMessage(this, Msg, bTeamOnly);
+	}
+}
+
+void AShooterPlayerController::ClientReceiveChat_Implementation( const TArray<FShooterChatMessage>& Messages, int32 NumRejected )
+{
+	AShooterHUD* ShooterHUD = GetShooterHUD();
+	if (ShooterHUD == nullptr)
+	{
+		return;
+	}
+
+	TArray<FText> ChatLines;
+	ChatLines.Reserve(Messages.Num() + 1);
+	for (const FShooterChatMessage& Message : Messages)
+	{
+		if (Message.bTeamOnly)
+		{
+			ChatLines.Add(FText::Format(NSLOCTEXT("ShooterGame.HUD", "TeamChatLine", "(Team) {0}"), FText::FromString(Message.Text)));
+		}
+		else
+		{
+			ChatLines.Add(FText::FromString(Message.Text));
+		}
+	}
+
+	if (NumRejected > 0)
+	{
+		ChatLines.Add(FText::Format(NSLOCTEXT("ShooterGame.HUD", "ChatRateLimited", "{0} {0}|plural(one=message,other=messages) not sent, slow down."), NumRejected));
+	}
+
+	ShooterHUD->AddChatLines(ChatLines, false);
 }
 
 AShooterHUD* AShooterPlayerController::GetShooterHUD() const
@@ -1126,274 +1170,66 @@ void AShooterPlayerController::ShowInGameMenu()
 		ShooterIngameMenu->ToggleGameMenu();
 	}
 }
-void AShooterPlayerController::UpdateAchievementsOnGameEnd()
+void AShooterPlayerController::SubmitMatchResults(bool bIsWinner)
 {
-	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
-	if (LocalPlayer)
+	UShooterLocalPlayer* LocalPlayer = Cast<UShooterLocalPlayer>(Player);
+	AShooterPlayerState* ShooterPlayerState = Cast<AShooterPlayerState>(PlayerState);
+	UShooterGameInstance* SGI = GetWorld() ? Cast<UShooterGameInstance>(GetWorld()->GetGameInstance()) : nullptr;
+	if (LocalPlayer == nullptr || ShooterPlayerState == nullptr || SGI == nullptr || SGI->GetMatchResults() == nullptr)
 	{
-		AShooterPlayerState* ShooterPlayerState = Cast<AShooterPlayerState>(PlayerState);
-		if (ShooterPlayerState)
-		{			
-			const UShooterPersistentUser*  PersistentUser = GetPersistentUser();
-
-			if (PersistentUser)
-			{						
-				const int32 Wins = PersistentUser->GetWins();
-				const int32 Losses = PersistentUser->GetLosses();
-				const int32 Matches = Wins + Losses;
-
-				const int32 TotalKills = PersistentUser->GetKills();
-				const int32 MatchScore = (int32)ShooterPlayerState->GetScore();
-
-				const int32 TotalBulletsFired = PersistentUser->GetBulletsFired();
-				const int32 TotalRocketsFired = PersistentUser->GetRocketsFired();
-			
-				float TotalGameAchievement = 0;
-				float CurrentGameAchievement = 0;
-			
-				///////////////////////////////////////
-				// Kill achievements
-				if (TotalKills >= 1)
-				{
-					CurrentGameAchievement += 100.0f;
-				}
-				TotalGameAchievement += 100;
-
-				{
-					float fSomeKillPct = ((float)TotalKills / (float)SomeKillsCount) * 100.0f;
-					fSomeKillPct = FMath::RoundToFloat(fSomeKillPct);
-					UpdateAchievementProgress(ACH_SOME_KILLS, fSomeKillPct);
-
-					CurrentGameAchievement += FMath::Min(fSomeKillPct, 100.0f);
-					TotalGameAchievement += 100;
-				}
-
-				{
-					float fLotsKillPct = ((float)TotalKills / (float)LotsKillsCount) * 100.0f;
-					fLotsKillPct = FMath::RoundToFloat(fLotsKillPct);
-					UpdateAchievementProgress(ACH_LOTS_KILLS, fLotsKillPct);
-
-					CurrentGameAchievement += FMath::Min(fLotsKillPct, 100.0f);
-					TotalGameAchievement += 100;
-				}
-				///////////////////////////////////////
-
-				///////////////////////////////////////
-				// Match Achievements
-				{
-					UpdateAchievementProgress(ACH_FINISH_MATCH, 100.0f);
-
-					CurrentGameAchievement += 100;
-					TotalGameAchievement += 100;
-				}
-			
-				{
-					float fLotsRoundsPct = ((float)Matches / (float)LotsMatchesCount) * 100.0f;
-					fLotsRoundsPct = FMath::RoundToFloat(fLotsRoundsPct);
-					UpdateAchievementProgress(ACH_LOTS_MATCHES, fLotsRoundsPct);
-
-					CurrentGameAchievement += FMath::Min(fLotsRoundsPct, 100.0f);
-					TotalGameAchievement += 100;
-				}
-				///////////////////////////////////////
-
-				///////////////////////////////////////
-				// Win Achievements
-				if (Wins >= 1)
-				{
-					UpdateAchievementProgress(ACH_FIRST_WIN, 100.0f);
-
-					CurrentGameAchievement += 100.0f;
-				}
-				TotalGameAchievement += 100;
-
-				{			
-					float fLotsWinPct = ((float)Wins / (float)LotsWinsCount) * 100.0f;
-					fLotsWinPct = FMath::RoundToInt(fLotsWinPct);
-					UpdateAchievementProgress(ACH_LOTS_WIN, fLotsWinPct);
-
-					CurrentGameAchievement += FMath::Min(fLotsWinPct, 100.0f);
-					TotalGameAchievement += 100;
-				}
-
-				{			
-					float fManyWinPct = ((float)Wins / (float)ManyWinsCount) * 100.0f;
-					fManyWinPct = FMath::RoundToInt(fManyWinPct);
-					UpdateAchievementProgress(ACH_MANY_WIN, fManyWinPct);
-
-					CurrentGameAchievement += FMath::Min(fManyWinPct, 100.0f);
-					TotalGameAchievement += 100;
-				}
-				///////////////////////////////////////
-
-				///////////////////////////////////////
-				// Ammo Achievements
-				{
-					float fLotsBulletsPct = ((float)TotalBulletsFired / (float)LotsBulletsCount) * 100.0f;
-					fLotsBulletsPct = FMath::RoundToFloat(fLotsBulletsPct);
-					UpdateAchievementProgress(ACH_SHOOT_BULLETS, fLotsBulletsPct);
-
-					CurrentGameAchievement += FMath::Min(fLotsBulletsPct, 100.0f);
-					TotalGameAchievement += 100;
-				}
-
-				{
-					float fLotsRocketsPct = ((float)TotalRocketsFired / (float)LotsRocketsCount) * 100.0f;
-					fLotsRocketsPct = FMath::RoundToFloat(fLotsRocketsPct);
-					UpdateAchievementProgress(ACH_SHOOT_ROCKETS, fLotsRocketsPct);
-
-					CurrentGameAchievement += FMath::Min(fLotsRocketsPct, 100.0f);
-					TotalGameAchievement += 100;
-				}
-				///////////////////////////////////////
-
-				///////////////////////////////////////
-				// Score Achievements
-				{
-					float fGoodScorePct = ((float)MatchScore / (float)GoodScoreCount) * 100.0f;
-					fGoodScorePct = FMath::RoundToFloat(fGoodScorePct);
-					UpdateAchievementProgress(ACH_GOOD_SCORE, fGoodScorePct);
-				}
+		return;
+	}
 
-				{
-					float fGreatScorePct = ((float)MatchScore / (float)GreatScoreCount) * 100.0f;
-					fGreatScorePct = FMath::RoundToFloat(fGreatScorePct);
-					UpdateAchievementProgress(ACH_GREAT_SCORE, fGreatScorePct);
-				}
-				///////////////////////////////////////
-
-				///////////////////////////////////////
-				// Map Play Achievements
-				UWorld* World = GetWorld();
-				if (World)
-				{			
-					FString MapName = *FPackageName::GetShortName(World->PersistentLevel->GetOutermost()->GetName());
-					if (MapName.Find(TEXT("Highrise")) != -1)
-					{
-						UpdateAchievementProgress(ACH_PLAY_HIGHRISE, 100.0f);
-					}
-					else if (MapName.Find(TEXT("Sanctuary")) != -1)
-					{
-						UpdateAchievementProgress(ACH_PLAY_SANCTUARY, 100.0f);
-					}
-				}
-				///////////////////////////////////////			
-
-				const IOnlineEventsPtr Events = Online::GetEventsInterface(World);
-				const IOnlineIdentityPtr Identity = Online::GetIdentityInterface(World);
-
-				if (Events.IsValid() && Identity.IsValid())
-				{							
-					const int32 UserIndex = LocalPlayer->GetControllerId();
-					TSharedPtr<const FUniqueNetId> UniqueID = Identity->GetUniquePlayerId(UserIndex);
-					if (UniqueID.IsValid())
-					{				
-						FOnlineEventParms Params;
-
-						float fGamePct = (CurrentGameAchievement / TotalGameAchievement) * 100.0f;
-						fGamePct = FMath::RoundToFloat(fGamePct);
-						Params.Add( TEXT( "CompletionPercent" ), FVariantData( (float)fGamePct ) );
-						if (UniqueID.IsValid())
-						{				
-							Events->TriggerEvent(*UniqueID, TEXT("GameProgress"), Params);
-						}
-					}
-				}
-			}
-		}
+	// update local saved profile, written to disk by the results pipeline
+	UShooterPersistentUser* const PersistentUser = GetPersistentUser();
+	if (PersistentUser)
+	{
+		PersistentUser->AddMatchResult(ShooterPlayerState->GetKills(), ShooterPlayerState->GetDeaths(), ShooterPlayerState->GetNumBulletsFired(), ShooterPlayerState->GetNumRocketsFired(), bIsWinner);
 	}
-}
 
-void AShooterPlayerController::UpdateLeaderboardsOnGameEnd()
-{
-	UShooterLocalPlayer* LocalPlayer = Cast<UShooterLocalPlayer>(Player);
-	if (LocalPlayer)
+	TSharedRef<FShooterMatchResult> Result = MakeShareable(new FShooterMatchResult());
+	Result->ControllerId = LocalPlayer->GetControllerId();
+	Result->UserId = LocalPlayer->GetCachedUniqueNetId().GetUniqueNetId();
+	if (!Result->UserId.IsValid())
 	{
-		// update leaderboards - note this does not respect existing scores and overwrites them. We would first need to read the leaderboards if we wanted to do that.
-		IOnlineSubsystem* const OnlineSub = Online::GetSubsystem(GetWorld());
-		if (OnlineSub)
+		const IOnlineIdentityPtr Identity = Online::GetIdentityInterface(GetWorld());
+		if (Identity.IsValid())
 		{
-			IOnlineIdentityPtr Identity = OnlineSub->GetIdentityInterface();
-			if (Identity.IsValid())
-			{
-				TSharedPtr<const FUniqueNetId> UserId = Identity->GetUniquePlayerId(LocalPlayer->GetControllerId());
-				if (UserId.IsValid())
-				{
-					IOnlineLeaderboardsPtr Leaderboards = OnlineSub->GetLeaderboardsInterface();
-					if (Leaderboards.IsValid())
-					{
-						AShooterPlayerState* ShooterPlayerState = Cast<AShooterPlayerState>(PlayerState);
-						if (ShooterPlayerState)
-						{
-							FShooterAllTimeMatchResultsWrite ResultsWriteObject;
-							int32 MatchWriteData = 1;
-							int32 KillsWriteData = ShooterPlayerState->GetKills();
-							int32 DeathsWriteData = ShooterPlayerState->GetDeaths();
-
-#if TRACK_STATS_LOCALLY
-							StatMatchesPlayed = (MatchWriteData += StatMatchesPlayed);
-							StatKills = (KillsWriteData += StatKills);
-							StatDeaths = (DeathsWriteData += StatDeaths);
-#endif
-
-							ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_SCORE, KillsWriteData);
-							ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_KILLS, KillsWriteData);
-							ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_DEATHS, DeathsWriteData);
-							ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_MATCHESPLAYED, MatchWriteData);
-
-							// the call will copy the user id and write object to its own memory
-							Leaderboards->WriteLeaderboards(ShooterPlayerState->SessionName, *UserId, ResultsWriteObject);
-							Leaderboards->FlushLeaderboards(TEXT("SHOOTERGAME"));
-						}
-					}
-				}
-			}
+			Result->UserId = Identity->GetUniquePlayerId(LocalPlayer->GetControllerId());
 		}
 	}
-}
+	Result->SessionName = ShooterPlayerState->SessionName;
+	Result->MapName = FPackageName::GetShortName(GetWorld()->PersistentLevel->GetOutermost()->GetName());
 
-void AShooterPlayerController::UpdateStatsOnGameEnd(bool bIsWinner)
-{
-	const IOnlineStatsPtr Stats = Online::GetStatsInterface(GetWorld());
-	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
-	AShooterPlayerState* ShooterPlayerState = Cast<AShooterPlayerState>(PlayerState);
+	Result->Kills = ShooterPlayerState->GetKills();
+	Result->Deaths = ShooterPlayerState->GetDeaths();
+	Result->Score = (int32)ShooterPlayerState->GetScore();
+	Result->bIsWinner = bIsWinner;
 
-	if (Stats.IsValid() && LocalPlayer != nullptr && ShooterPlayerState != nullptr)
+	if (PersistentUser)
 	{
-		FUniqueNetIdRepl UniqueId = LocalPlayer->GetCachedUniqueNetId();
-
-		if (UniqueId.IsValid() )
-		{
-			TArray<FOnlineStatsUserUpdatedStats> UpdatedUserStats;
+		Result->TotalKills = PersistentUser->GetKills();
+		Result->TotalWins = PersistentUser->GetWins();
+		Result->TotalLosses = PersistentUser->GetLosses();
+		Result->TotalBulletsFired = PersistentUser->GetBulletsFired();
+		Result->TotalRocketsFired = PersistentUser->GetRocketsFired();
+	}
 
-			FOnlineStatsUserUpdatedStats& UpdatedStats = UpdatedUserStats.Emplace_GetRef( UniqueId.GetUniqueNetId().ToSharedRef() );
-			UpdatedStats.Stats.Add( TEXT("Kills"), FOnlineStatUpdate( ShooterPlayerState->GetKills(), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			UpdatedStats.Stats.Add( TEXT("Deaths"), FOnlineStatUpdate( ShooterPlayerState->GetDeaths(), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			UpdatedStats.Stats.Add( TEXT("RoundsPlayed"), FOnlineStatUpdate( 1, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			if (bIsWinner)
-			{
-				UpdatedStats.Stats.Add( TEXT("RoundsWon"), FOnlineStatUpdate( 1, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			}
+	int32 MatchWriteData = 1;
+	int32 KillsWriteData = ShooterPlayerState->GetKills();
+	int32 DeathsWriteData = ShooterPlayerState->GetDeaths();
 
-			Stats->UpdateStats( UniqueId.GetUniqueNetId().ToSharedRef(), UpdatedUserStats, FOnlineStatsUpdateStatsComplete() );
-		}
-	}
-}
+#if TRACK_STATS_LOCALLY
+	StatMatchesPlayed = (MatchWriteData += StatMatchesPlayed);
+	StatKills = (KillsWriteData += StatKills);
+	StatDeaths = (DeathsWriteData += StatDeaths);
+#endif
 
+	Result->LeaderboardKills = KillsWriteData;
+	Result->LeaderboardDeaths = DeathsWriteData;
+	Result->LeaderboardMatchesPlayed = MatchWriteData;
 
-void AShooterPlayerController::UpdateSaveFileOnGameEnd(bool bIsWinner)
-{
-	AShooterPlayerState* ShooterPlayerState = Cast<AShooterPlayerState>(PlayerState);
-	if (ShooterPlayerState)
-	{
-		// update local saved profile
-		UShooterPersistentUser* const PersistentUser = GetPersistentUser();
-		if (PersistentUser)
-		{
-			PersistentUser->AddMatchResult(ShooterPlayerState->GetKills(), ShooterPlayerState->GetDeaths(), ShooterPlayerState->GetNumBulletsFired(), ShooterPlayerState->GetNumRocketsFired(), bIsWinner);
-			PersistentUser->SaveIfDirty();
-		}
-	}
+	SGI->GetMatchResults()->Submit(Result, PersistentUser);
 }
 
 void AShooterPlayerController::PreClientTravel(const FString& PendingURL, ETravelType TravelType, bool bIsSeamlessTravel)
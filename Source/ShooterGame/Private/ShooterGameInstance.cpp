@@ -15,12 +15,19 @@
 #include "ShooterMenuItemWidgetStyle.h"
 #include "ShooterGameViewportClient.h"
 #include "Player/ShooterPlayerController_Menu.h"
+#include "Player/ShooterLocalPlayer.h"
 #include "Online/ShooterPlayerState.h"
 #include "Online/ShooterGameSession.h"
 #include "Online/ShooterOnlineSessionClient.h"
+#include "Online/ShooterMatchResults.h"
+#include "Online/ShooterReplayIndex.h"
+#include "Online/ShooterServerReplayRecorder.h"
+#include "Online/ShooterServerTelemetry.h"
+#include "Player/ShooterCharacterUpdater.h"
 #include "OnlineSubsystemUtils.h"
 #include "Core/PlayFabClientAPI.h"
 #include "ShooterGameUserSettings.h"
+#include "Engine/AssetManager.h"
 
 #if !defined(CONTROLLER_SWAPPING)
 	#define CONTROLLER_SWAPPING 0
@@ -30,6 +37,10 @@
 	#define NEED_XBOX_LIVE_FOR_ONLINE 0
 #endif
 
+// Seeking loads the checkpoint before the target time and fast-forwards from there, so this bounds how far a seek has to simulate.
+float CVar_ShooterReplay_CheckpointInterval = 10.0f;
+static FAutoConsoleVariableRef CVarShooterReplayCheckpointInterval(TEXT("ShooterReplay.CheckpointInterval"), CVar_ShooterReplay_CheckpointInterval, TEXT("Seconds between replay checkpoints while recording, 0 to keep the engine default"), ECVF_Default );
+
 FAutoConsoleVariable CVarShooterGameTestEncryption(TEXT("ShooterGame.TestEncryption"), 0, TEXT("If true, clients will send an encryption token with their request to join the server and attempt to encrypt the connection using a debug key. This is NOT SECURE and for demonstration purposes only."));
 
 void SShooterWaitDialog::Construct(const FArguments& InArgs)
@@ -134,6 +145,28 @@ void UShooterGameInstance::Init()
 	TickDelegate = FTickerDelegate::CreateUObject(this, &UShooterGameInstance::Tick);
 	TickDelegateHandle = FTicker::GetCoreTicker().AddTicker(TickDelegate);
 
+	if (!IsDedicatedServerInstance())
+	{
+		MatchResults = MakeShareable(new FShooterMatchResultsPipeline(this));
+		MatchResults->Initialize();
+	}
+
+	ReplayIndex = MakeShareable(new FShooterReplayIndex());
+	ReplayIndex->Load();
+
+	if (IsDedicatedServerInstance())
+	{
+		ServerReplayRecorder = MakeShareable(new FShooterServerReplayRecorder(this));
+		ServerReplayRecorder->Initialize();
+
+		ServerTelemetry = MakeShareable(new FShooterServerTelemetry(this));
+		ServerTelemetry->Initialize();
+
+		PreloadServerAssets();
+	}
+
+	CharacterUpdater = MakeShareable(new FShooterCharacterUpdater());
+
 	// Initialize the debug key with a set value for AES256. This is not secure and for example purposes only.
 	DebugTestEncryptionKey.SetNum(32);
 
@@ -145,6 +178,15 @@ void UShooterGameInstance::Init()
 
 void UShooterGameInstance::Shutdown()
 {
+	// saves are written in the background, make sure they made it to disk
+	for (ULocalPlayer* LocalPlayer : LocalPlayers)
+	{
+		if (UShooterLocalPlayer* ShooterLocalPlayer = Cast<UShooterLocalPlayer>(LocalPlayer))
+		{
+			ShooterLocalPlayer->FlushPersistentUser();
+		}
+	}
+
 	Super::Shutdown();
 	
 	// Clear the activities delegate
@@ -155,6 +197,42 @@ void UShooterGameInstance::Shutdown()
 
 	// Unregister ticker delegate
 	FTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
+
+	MatchResults.Reset();
+	ServerReplayRecorder.Reset();
+	ServerTelemetry.Reset();
+	ServerPreloadHandle.Reset();
+	ReplayIndex.Reset();
+	CharacterUpdater.Reset();
+}
+
+void UShooterGameInstance::StartRecordingReplay(const FString& InName, const FString& FriendlyName, const TArray<FString>& AdditionalOptions, TSharedPtr<IAnalyticsProvider> AnalyticsProvider)
+{
+	// the demo driver reads it every time it considers saving a checkpoint
+	if (CVar_ShooterReplay_CheckpointInterval > 0.0f)
+	{
+		IConsoleVariable* CheckpointUploadDelay = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.CheckpointUploadDelay"));
+		if (CheckpointUploadDelay)
+		{
+			CheckpointUploadDelay->Set(CVar_ShooterReplay_CheckpointInterval, ECVF_SetByCode);
+		}
+	}
+
+	Super::StartRecordingReplay(InName, FriendlyName, AdditionalOptions, AnalyticsProvider);
+
+	// only we know the map, the streamer doesn't. The server recorder indexes its own segments.
+	UWorld* const World = GetWorld();
+	if (!IsDedicatedServerInstance() && ReplayIndex.IsValid() && !InName.IsEmpty() && World && World->GetDemoNetDriver())
+	{
+		FShooterReplayInfo Info;
+		Info.Name = InName;
+		Info.FriendlyName = FriendlyName;
+		Info.Timestamp = FDateTime::UtcNow();
+		Info.MapName = World->GetMapName();
+		Info.NetworkVersion = FNetworkVersion::GetReplayVersion().NetworkVersion;
+		Info.bIsLive = true;
+		ReplayIndex->AddReplay(Info);
+	}
 }
 
 void UShooterGameInstance::HandleNetworkConnectionStatusChanged( const FString& ServiceName, EOnlineServerConnectionStatus::Type LastConnectionStatus, EOnlineServerConnectionStatus::Type ConnectionStatus )
@@ -248,6 +326,31 @@ void UShooterGameInstance::OnPostLoadMap(UWorld*)
 	}
 }
 
+void UShooterGameInstance::PreloadServerAssets()
+{
+	if (ServerPreloadAssets.Num() == 0 || !UAssetManager::IsValid())
+	{
+		return;
+	}
+
+	// one request for the whole set, the async loader reads and creates its packages side by side instead of one after the other.
+	// The first map loads while they do, and finds whatever it shares with them in memory or already on its way.
+	const double StartTime = FPlatformTime::Seconds();
+	ServerPreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(ServerPreloadAssets,
+		FStreamableDelegate::CreateUObject(this, &UShooterGameInstance::OnServerAssetsPreloaded, StartTime), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UShooterGameInstance::OnServerAssetsPreloaded(double StartTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	UE_LOG(LogShooter, Display, TEXT("Preloaded %d server assets in %.2f s."), ServerPreloadAssets.Num(), Now - StartTime);
+
+	if (ServerTelemetry.IsValid())
+	{
+		ServerTelemetry->SetPreloadTime(Now - GStartTime);
+	}
+}
+
 void UShooterGameInstance::OnUserCanPlayInvite(const FUniqueNetId& UserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResults)
 {
 	CleanupOnlinePrivilegeTask();
@@ -662,6 +765,13 @@ void UShooterGameInstance::BeginWelcomeScreenState()
 
 	ULocalPlayer* const LocalPlayer = GetFirstGamePlayer();
 	LocalPlayer->SetCachedUniqueNetId(nullptr);
+
+	// the save is loaded once the player is through the welcome screen, start reading it now
+	if (UShooterLocalPlayer* ShooterLocalPlayer = Cast<UShooterLocalPlayer>(LocalPlayer))
+	{
+		ShooterLocalPlayer->PrefetchPersistentUser();
+	}
+
 	check(!WelcomeMenuUI.IsValid());
 	WelcomeMenuUI = MakeShareable(new FShooterWelcomeMenu);
 	WelcomeMenuUI->Construct( this );
@@ -678,6 +788,9 @@ void UShooterGameInstance::EndWelcomeScreenState()
 		WelcomeMenuUI->RemoveFromGameViewport();
 		WelcomeMenuUI = nullptr;
 	}
+
+	// the player that pressed start has loaded its save by now, the others read ahead won't be asked for
+	UShooterPersistentUser::ClearPrefetchedSaves();
 }
 
 void UShooterGameInstance::SetPresenceForLocalPlayers(const FString& StatusStr, const FVariantData& PresenceData)
@@ -1416,6 +1529,12 @@ void UShooterGameInstance::RemoveExistingLocalPlayer(ULocalPlayer* ExistingPlaye
 		}
 	}
 
+	// a debounced save may still be waiting, write it before the player and its save go away
+	if (UShooterLocalPlayer* ShooterLocalPlayer = Cast<UShooterLocalPlayer>(ExistingPlayer))
+	{
+		ShooterLocalPlayer->FlushPersistentUser();
+	}
+
 	// Remove local split-screen players from the list
 	RemoveLocalPlayer( ExistingPlayer );
 }
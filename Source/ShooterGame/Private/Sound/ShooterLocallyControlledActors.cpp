@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Sound/ShooterLocallyControlledActors.h"
+
+TAtomic<uint32> FShooterLocallyControlledActors::ActorIDs[FShooterLocallyControlledActors::MaxSlots * 2];
+uint32 FShooterLocallyControlledActors::UsedSlotsMask = 0;
+
+int32 FShooterLocallyControlledActors::AcquireSlot()
+{
+	check(IsInGameThread());
+
+#if !UE_SERVER
+	if (!IsRunningDedicatedServer())
+	{
+		for (int32 Slot = 0; Slot < MaxSlots; ++Slot)
+		{
+			if ((UsedSlotsMask & (1u << Slot)) == 0)
+			{
+				UsedSlotsMask |= (1u << Slot);
+				return Slot;
+			}
+		}
+
+		UE_LOG(LogShooter, Warning, TEXT("No locally controlled actor slot left, local player sounds will use the remote branch."));
+	}
+#endif
+
+	return INDEX_NONE;
+}
+
+void FShooterLocallyControlledActors::ReleaseSlot(int32 Slot)
+{
+	check(IsInGameThread());
+
+	if (Slot >= 0 && Slot < MaxSlots)
+	{
+		Publish(Slot, 0, 0);
+		UsedSlotsMask &= ~(1u << Slot);
+	}
+}
+
+void FShooterLocallyControlledActors::Publish(int32 Slot, uint32 ControllerID, uint32 PawnID)
+{
+	check(Slot >= 0 && Slot < MaxSlots);
+
+	// only this thread writes, relaxed loads are enough to detect changes
+	if (ActorIDs[Slot * 2].Load(EMemoryOrder::Relaxed) != ControllerID)
+	{
+		ActorIDs[Slot * 2] = ControllerID;
+	}
+	if (ActorIDs[Slot * 2 + 1].Load(EMemoryOrder::Relaxed) != PawnID)
+	{
+		ActorIDs[Slot * 2 + 1] = PawnID;
+	}
+}
+
+void FShooterLocallyControlledActors::Remove(uint32 UniqueID)
+{
+	if (UniqueID == 0 || UsedSlotsMask == 0)
+	{
+		return;
+	}
+
+	for (TAtomic<uint32>& ActorID : ActorIDs)
+	{
+		if (ActorID.Load(EMemoryOrder::Relaxed) == UniqueID)
+		{
+			ActorID = 0;
+		}
+	}
+}
+
+bool FShooterLocallyControlledActors::IsLocallyControlled(uint32 UniqueID)
+{
+#if !UE_SERVER
+	// sounds without owner have id 0, same as unused entries
+	if (UniqueID != 0)
+	{
+		for (const TAtomic<uint32>& ActorID : ActorIDs)
+		{
+			if (ActorID.Load() == UniqueID)
+			{
+				return true;
+			}
+		}
+	}
+#endif
+
+	return false;
+}
@@ -3,22 +3,17 @@
 #include "ShooterGame.h"
 #include "Sound/SoundNodeLocalPlayer.h"
 #include "SoundDefinitions.h"
+#include "Sound/ShooterLocallyControlledActors.h"
 
 #define LOCTEXT_NAMESPACE "SoundNodeLocalPlayer"
 
-TMap<uint32, bool> USoundNodeLocalPlayer::LocallyControlledActorCache;
-
 USoundNodeLocalPlayer::USoundNodeLocalPlayer(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
 
 void USoundNodeLocalPlayer::ParseNodes(FAudioDevice* AudioDevice, const UPTRINT NodeWaveInstanceHash, FActiveSound& ActiveSound, const FSoundParseParameters& ParseParams, TArray<FWaveInstance*>& WaveInstances)
 {
-	bool bLocallyControlled = false;
-	if (bool* LocallyControlledPtr = LocallyControlledActorCache.Find(ActiveSound.GetOwnerID()))
-	{
-		bLocallyControlled = *LocallyControlledPtr;
-	}
+	const bool bLocallyControlled = FShooterLocallyControlledActors::IsLocallyControlled(ActiveSound.GetOwnerID());
 
 	const int32 PlayIndex = bLocallyControlled ? 0 : 1;
 
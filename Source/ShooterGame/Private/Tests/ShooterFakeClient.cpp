@@ -0,0 +1,360 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "Tests/ShooterFakeClient.h"
+#include "ShooterGame.h"
+#include "Misc/NetworkVersion.h"
+#include "Net/DataChannel.h"
+#include "OnlineSubsystemUtils.h"
+#include "PacketHandler.h"
+
+namespace
+{
+	/** the net driver definition every fake client creates its own named driver from */
+	const FName FakeClientNetDriverDefinition(TEXT("ShooterFakeClient"));
+}
+
+void FShooterFakePlayerInput::Init(int32 Seed)
+{
+	Random.Initialize(Seed);
+	LastMovement = nullptr;
+	LastMovementCorrections = 0;
+	Reset();
+}
+
+void FShooterFakePlayerInput::Reset()
+{
+	ActionTimeLeft = 0.0f;
+	ForwardInput = 0.0f;
+	RightInput = 0.0f;
+	TurnInput = 0.0f;
+	bWantsRun = false;
+	bWantsFire = false;
+	bFiring = false;
+}
+
+void FShooterFakePlayerInput::ChooseAction()
+{
+	ActionTimeLeft = Random.FRandRange(0.5f, 3.0f);
+	ForwardInput = Random.FRandRange(-0.5f, 1.0f);
+	RightInput = Random.FRandRange(-1.0f, 1.0f);
+	TurnInput = Random.FRandRange(-0.5f, 0.5f);
+	bWantsRun = Random.FRand() < 0.3f;
+
+	// running stops firing, so only fire while walking
+	bWantsFire = !bWantsRun && Random.FRand() < 0.5f;
+}
+
+void FShooterFakePlayerInput::Drive(AShooterCharacter* Character, float TimeDelta)
+{
+	ActionTimeLeft -= TimeDelta;
+	if (ActionTimeLeft <= 0.0f)
+	{
+		ChooseAction();
+
+		if (Random.FRand() < 0.2f)
+		{
+			Character->Jump();
+		}
+	}
+
+	Character->MoveForward(ForwardInput);
+	Character->MoveRight(RightInput);
+	Character->TurnAtRate(TurnInput);
+
+	if (Character->IsRunning() != bWantsRun)
+	{
+		Character->SetRunning(bWantsRun, false);
+	}
+
+	if (bWantsFire != bFiring)
+	{
+		if (bWantsFire)
+		{
+			Character->OnStartFire();
+		}
+		else
+		{
+			Character->OnStopFire();
+		}
+		bFiring = bWantsFire;
+	}
+}
+
+int32 FShooterFakePlayerInput::TakeNewCorrections(AShooterCharacter* Character)
+{
+	UShooterCharacterMovement* Movement = Character ? Cast<UShooterCharacterMovement>(Character->GetCharacterMovement()) : nullptr;
+	if (Movement == nullptr)
+	{
+		return 0;
+	}
+
+	if (Movement != LastMovement.Get())
+	{
+		LastMovement = Movement;
+		LastMovementCorrections = 0;
+	}
+
+	const int32 NewCorrections = Movement->GetNumCorrectionsReceived() - LastMovementCorrections;
+	LastMovementCorrections = Movement->GetNumCorrectionsReceived();
+	return NewCorrections;
+}
+
+void UShooterFakeClientConnection::HandleClientPlayer(APlayerController* PC, UNetConnection* NetConnection)
+{
+	// what the engine does for the controller of a local player, without a local player or viewport to hand it to
+	PC->SetRole(ROLE_AutonomousProxy);
+	PC->NetConnection = NetConnection;
+	PlayerController = PC;
+	OwningActor = PC;
+	State = USOCK_Open;
+}
+
+bool UShooterFakeClientNetDriver::InitConnectionClass()
+{
+	NetConnectionClass = UShooterFakeClientConnection::StaticClass();
+	return true;
+}
+
+bool UShooterFakeClientNetDriver::ShouldReplicateFunction(AActor* Actor, UFunction* Function) const
+{
+	// the actors of a fake client's world name the game net driver, but this is the only driver of that world
+	return Actor && Actor->GetWorld() == GetWorld();
+}
+
+bool UShooterFakeClientNetDriver::ShouldReplicateActor(AActor* Actor) const
+{
+	return Actor && Actor->GetWorld() == GetWorld();
+}
+
+bool UShooterFakeClient::Connect(UGameInstance* GameInstance, const FString& ServerAddress, const FString& InPlayerName, int32 Seed)
+{
+	static int32 NumFakeClients = 0;
+	const int32 FakeClientId = NumFakeClients++;
+
+	PlayerName = InPlayerName;
+	Input.Init(Seed);
+	bJoined = false;
+	bFailed = false;
+
+	if (!GEngine->NetDriverDefinitions.ContainsByPredicate([](const FNetDriverDefinition& Definition) { return Definition.DefName == FakeClientNetDriverDefinition; }))
+	{
+		FNetDriverDefinition Definition;
+		Definition.DefName = FakeClientNetDriverDefinition;
+		Definition.DriverClassName = *UShooterFakeClientNetDriver::StaticClass()->GetPathName();
+		Definition.DriverClassNameFallback = Definition.DriverClassName;
+		GEngine->NetDriverDefinitions.Add(Definition);
+	}
+
+	// an empty world of its own, ticked by the engine with the other world contexts
+	World = UWorld::CreateWorld(EWorldType::Game, false, *FString::Printf(TEXT("ShooterFakeClient%d"), FakeClientId), nullptr, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.OwningGameInstance = GameInstance;
+	WorldContext.SetCurrentWorld(World);
+	World->SetGameInstance(GameInstance);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	// a name of its own too: the engine travels back to the menu on failures of the game net driver only
+	NetDriverName = *FString::Printf(TEXT("ShooterFakeClientNetDriver%d"), FakeClientId);
+	if (!GEngine->CreateNamedNetDriver(World, NetDriverName, FakeClientNetDriverDefinition))
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Fake client %s: failed to create its net driver."), *PlayerName);
+		Disconnect();
+		return false;
+	}
+
+	NetDriver = GEngine->FindNamedNetDriver(World, NetDriverName);
+	NetDriver->SetWorld(World);
+	World->SetNetDriver(NetDriver);
+
+	FString Error;
+	if (!NetDriver->InitConnect(this, FURL(nullptr, *ServerAddress, TRAVEL_Absolute), Error))
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Fake client %s: failed to connect to %s: %s"), *PlayerName, *ServerAddress, *Error);
+		Disconnect();
+		return false;
+	}
+
+	UNetConnection* Connection = NetDriver->ServerConnection;
+	if (Connection->Handler.IsValid())
+	{
+		Connection->Handler->BeginHandshaking(FPacketHandlerHandshakeComplete::CreateUObject(this, &UShooterFakeClient::SendHello));
+	}
+	else
+	{
+		SendHello();
+	}
+
+	return true;
+}
+
+void UShooterFakeClient::SendHello()
+{
+	UNetConnection* Connection = GetConnection();
+	if (Connection == nullptr)
+	{
+		return;
+	}
+
+	uint8 IsLittleEndian = uint8(PLATFORM_LITTLE_ENDIAN);
+	uint32 LocalNetworkVersion = FNetworkVersion::GetLocalNetworkVersion();
+	FString EncryptionToken;
+	FNetControlMessage<NMT_Hello>::Send(Connection, IsLittleEndian, LocalNetworkVersion, EncryptionToken);
+	Connection->FlushNet();
+}
+
+void UShooterFakeClient::Tick(float TimeDelta)
+{
+	UNetConnection* Connection = GetConnection();
+	APlayerController* PC = Connection ? Connection->PlayerController : nullptr;
+	if (PC == nullptr)
+	{
+		return;
+	}
+
+	// a local player acknowledges its pawns on ClientRestart, the server doesn't take moves for pawns that aren't
+	APawn* Pawn = PC->GetPawn();
+	if (Pawn && Pawn != PC->AcknowledgedPawn)
+	{
+		PC->AcknowledgedPawn = Pawn;
+		PC->ServerAcknowledgePossession(Pawn);
+	}
+
+	AShooterCharacter* Character = Cast<AShooterCharacter>(Pawn);
+	if (Character && Character->IsAlive())
+	{
+		Input.Drive(Character, TimeDelta);
+
+		// nor does the controller turn without a local player, apply the turn input here
+		PC->UpdateRotation(TimeDelta);
+	}
+	else
+	{
+		Input.Reset();
+	}
+}
+
+void UShooterFakeClient::Disconnect()
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	if (NetDriver)
+	{
+		GEngine->DestroyNamedNetDriver(World, NetDriverName);
+		World->SetNetDriver(nullptr);
+		NetDriver = nullptr;
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World = nullptr;
+}
+
+bool UShooterFakeClient::IsInGame() const
+{
+	const UNetConnection* Connection = GetConnection();
+	return bJoined && Connection && Connection->PlayerController;
+}
+
+bool UShooterFakeClient::HasFailed() const
+{
+	const UNetConnection* Connection = GetConnection();
+	return bFailed || Connection == nullptr || Connection->State == USOCK_Closed;
+}
+
+UNetConnection* UShooterFakeClient::GetConnection() const
+{
+	return NetDriver ? NetDriver->ServerConnection : nullptr;
+}
+
+AShooterCharacter* UShooterFakeClient::GetCharacter() const
+{
+	const UNetConnection* Connection = GetConnection();
+	return Connection && Connection->PlayerController ? Cast<AShooterCharacter>(Connection->PlayerController->GetPawn()) : nullptr;
+}
+
+EAcceptConnection::Type UShooterFakeClient::NotifyAcceptingConnection()
+{
+	return EAcceptConnection::Reject;
+}
+
+void UShooterFakeClient::NotifyAcceptedConnection(UNetConnection* Connection)
+{
+}
+
+bool UShooterFakeClient::NotifyAcceptingChannel(UChannel* Channel)
+{
+	// as a client world does, the server opens actor and voice channels
+	return Channel->ChName == NAME_Actor || Channel->ChName == NAME_Voice;
+}
+
+void UShooterFakeClient::NotifyControlMessage(UNetConnection* Connection, uint8 MessageType, FInBunch& Bunch)
+{
+	// the handshake of a pending net game, with a fake player instead of a local player
+	switch (MessageType)
+	{
+		case NMT_Challenge:
+		{
+			if (FNetControlMessage<NMT_Challenge>::Receive(Bunch, Connection->Challenge))
+			{
+				FURL LoginURL;
+				LoginURL.Map = TEXT("");
+				LoginURL.AddOption(*FString::Printf(TEXT("Name=%s"), *PlayerName));
+
+				const IOnlineIdentityPtr Identity = Online::GetIdentityInterface(World);
+				if (Identity.IsValid())
+				{
+					Connection->PlayerId = FUniqueNetIdRepl(Identity->CreateUniquePlayerId(PlayerName));
+				}
+
+				Connection->ClientResponse = TEXT("0");
+				FString URLString = LoginURL.ToString();
+				FString OnlinePlatformName = World->GetGameInstance() ? World->GetGameInstance()->GetOnlinePlatformName().ToString() : FString();
+				FNetControlMessage<NMT_Login>::Send(Connection, Connection->ClientResponse, URLString, Connection->PlayerId, OnlinePlatformName);
+				Connection->FlushNet();
+			}
+			break;
+		}
+		case NMT_Welcome:
+		{
+			FString MapName;
+			FString GameName;
+			FString RedirectURL;
+			if (FNetControlMessage<NMT_Welcome>::Receive(Bunch, MapName, GameName, RedirectURL))
+			{
+				// there is no map to load, join right away
+				FNetControlMessage<NMT_Netspeed>::Send(Connection, Connection->CurrentNetSpeed);
+				FNetControlMessage<NMT_Join>::Send(Connection);
+				Connection->FlushNet(true);
+				bJoined = true;
+
+				UE_LOG(LogShooter, Log, TEXT("Fake client %s: joined %s."), *PlayerName, *MapName);
+			}
+			break;
+		}
+		case NMT_Upgrade:
+		{
+			uint32 RemoteNetworkVersion = 0;
+			if (FNetControlMessage<NMT_Upgrade>::Receive(Bunch, RemoteNetworkVersion))
+			{
+				UE_LOG(LogShooter, Warning, TEXT("Fake client %s: the server runs network version %u, this build %u."), *PlayerName, RemoteNetworkVersion, FNetworkVersion::GetLocalNetworkVersion());
+			}
+			bFailed = true;
+			break;
+		}
+		case NMT_Failure:
+		{
+			FString ErrorMsg;
+			if (FNetControlMessage<NMT_Failure>::Receive(Bunch, ErrorMsg))
+			{
+				UE_LOG(LogShooter, Warning, TEXT("Fake client %s: refused by the server: %s"), *PlayerName, *ErrorMsg);
+			}
+			bFailed = true;
+			break;
+		}
+		default:
+			break;
+	}
+}
@@ -0,0 +1,251 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "Tests/ShooterTestControllerLoadGen.h"
+#include "ShooterGame.h"
+
+void UShooterTestControllerLoadGen::OnInit()
+{
+	Seed = 1;
+	Index = 0;
+	DurationSeconds = 0.0f;
+	ReportInterval = 30.0f;
+	MaxFPS = 30.0f;
+	NumFakeClients = 0;
+	NumProcesses = 0;
+
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenSeed="), Seed);
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenIndex="), Index);
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenDuration="), DurationSeconds);
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenReportInterval="), ReportInterval);
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenFPS="), MaxFPS);
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenFakeClients="), NumFakeClients);
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenServer="), ServerAddress);
+	FParse::Value(FCommandLine::Get(), TEXT("LoadGenProcesses="), NumProcesses);
+
+	if (NumFakeClients > 0 && ServerAddress.IsEmpty())
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Load gen %d: -LoadGenFakeClients needs the server to connect to, -LoadGenServer=host:port."), Index);
+		NumFakeClients = 0;
+	}
+
+	const int32 PlayersPerProcess = FMath::Max(NumFakeClients, 1);
+	if (NumProcesses <= 0)
+	{
+		NumProcesses = FMath::DivideAndRoundUp(64, PlayersPerProcess);
+	}
+
+	// every fake player plays differently, and the same way on every run
+	Input.Init(Seed * 7919 + Index);
+
+	NumPlayersInGame = 0;
+	TimeWaiting = 0.0f;
+	TimeInGame = 0.0f;
+	TimeSinceReport = 0.0f;
+	LagSumMS = 0.0;
+	MaxLagMS = 0.0f;
+	NumLagSamples = 0;
+	NumCorrections = 0;
+	NumCorrectionsThisReport = 0;
+	PeakUsedPhysical = 0;
+
+	// a player without a screen has no use for more frames than the server ticks
+	if (IConsoleVariable* MaxFPSCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("t.MaxFPS")))
+	{
+		MaxFPSCVar->Set(MaxFPS, ECVF_SetByCode);
+	}
+
+	UE_LOG(LogGauntlet, Display, TEXT("Load gen %d: seed %d, %d players, %.0f fps, %.0f s."), Index, Seed, PlayersPerProcess, MaxFPS, DurationSeconds);
+}
+
+void UShooterTestControllerLoadGen::OnTick(float TimeDelta)
+{
+	if (NumFakeClients > 0)
+	{
+		TickFakeClients(TimeDelta);
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+	AShooterCharacter* Character = PC ? Cast<AShooterCharacter>(PC->GetPawn()) : nullptr;
+
+	if (PC == nullptr || PC->GetNetConnection() == nullptr)
+	{
+		TimeWaiting += TimeDelta;
+		if (TimeWaiting > 120.0f)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Load gen %d: not connected to a server after 120 secs!"), Index);
+			EndTest(-1);
+		}
+		return;
+	}
+	TimeWaiting = 0.0f;
+
+	// nothing is presented with -nullrhi, skip building the scene for it
+	if (UGameViewportClient* Viewport = World->GetGameViewport())
+	{
+		Viewport->bDisableWorldRendering = true;
+	}
+
+	TimeInGame += TimeDelta;
+
+	if (Character && Character->IsAlive())
+	{
+		Input.Drive(Character, TimeDelta);
+	}
+	else
+	{
+		// the controller respawns by itself, start the next life with a fresh action
+		Input.Reset();
+	}
+
+	NumPlayersInGame = 1;
+	SamplePlayer(PC->GetNetConnection(), Character, Input);
+	UpdateReport(TimeDelta);
+
+	if (DurationSeconds > 0.0f && TimeInGame >= DurationSeconds)
+	{
+		Report(TEXT("final"));
+		CheckMemoryFit();
+		EndTest(0);
+	}
+}
+
+void UShooterTestControllerLoadGen::TickFakeClients(float TimeDelta)
+{
+	if (FakeClients.Num() == 0)
+	{
+		// the fake clients share the game instance of the process, which doesn't join the server itself
+		UWorld* World = GetWorld();
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (GameInstance == nullptr)
+		{
+			return;
+		}
+
+		for (int32 FakeClientIndex = 0; FakeClientIndex < NumFakeClients; FakeClientIndex++)
+		{
+			const int32 PlayerNum = Index * NumFakeClients + FakeClientIndex;
+			UShooterFakeClient* FakeClient = NewObject<UShooterFakeClient>(this);
+			if (FakeClient->Connect(GameInstance, ServerAddress, FString::Printf(TEXT("LoadGen%d"), PlayerNum), Seed * 7919 + PlayerNum))
+			{
+				FakeClients.Add(FakeClient);
+			}
+		}
+
+		if (FakeClients.Num() == 0)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Load gen %d: none of the %d fake clients could connect to %s!"), Index, NumFakeClients, *ServerAddress);
+			EndTest(-1);
+		}
+		return;
+	}
+
+	NumPlayersInGame = 0;
+	int32 NumFailed = 0;
+	for (UShooterFakeClient* FakeClient : FakeClients)
+	{
+		if (FakeClient->HasFailed())
+		{
+			NumFailed++;
+			continue;
+		}
+
+		FakeClient->Tick(TimeDelta);
+
+		if (FakeClient->IsInGame())
+		{
+			NumPlayersInGame++;
+			SamplePlayer(FakeClient->GetConnection(), FakeClient->GetCharacter(), FakeClient->GetInput());
+		}
+	}
+
+	if (NumFailed == FakeClients.Num())
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Load gen %d: all fake clients lost their connection to %s!"), Index, *ServerAddress);
+		EndTest(-1);
+		return;
+	}
+
+	if (NumPlayersInGame == 0)
+	{
+		TimeWaiting += TimeDelta;
+		if (TimeWaiting > 120.0f)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Load gen %d: no fake client in the game after 120 secs!"), Index);
+			EndTest(-1);
+		}
+		return;
+	}
+	TimeWaiting = 0.0f;
+
+	TimeInGame += TimeDelta;
+	UpdateReport(TimeDelta);
+
+	if (DurationSeconds > 0.0f && TimeInGame >= DurationSeconds)
+	{
+		Report(TEXT("final"));
+		CheckMemoryFit();
+
+		for (UShooterFakeClient* FakeClient : FakeClients)
+		{
+			FakeClient->Disconnect();
+		}
+		FakeClients.Empty();
+
+		EndTest(0);
+	}
+}
+
+void UShooterTestControllerLoadGen::SamplePlayer(const UNetConnection* Connection, AShooterCharacter* Character, FShooterFakePlayerInput& PlayerInput)
+{
+	const float LagMS = Connection->AvgLag * 1000.0f;
+	LagSumMS += LagMS;
+	MaxLagMS = FMath::Max(MaxLagMS, LagMS);
+	NumLagSamples++;
+
+	const int32 NewCorrections = PlayerInput.TakeNewCorrections(Character);
+	NumCorrections += NewCorrections;
+	NumCorrectionsThisReport += NewCorrections;
+}
+
+void UShooterTestControllerLoadGen::UpdateReport(float TimeDelta)
+{
+	TimeSinceReport += TimeDelta;
+	if (ReportInterval > 0.0f && TimeSinceReport >= ReportInterval)
+	{
+		Report(TEXT("interval"));
+	}
+}
+
+void UShooterTestControllerLoadGen::Report(const TCHAR* Label)
+{
+	// sampled per report only, reading the process's memory isn't free on every platform
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, MemoryStats.UsedPhysical);
+
+	UE_LOG(LogGauntlet, Display, TEXT("Load gen %d (%s): %d players in the game, lag %.1f ms avg, %.1f ms max, %d corrections in %.0f s (%.2f/s), %d in total over %.0f s, %.0f MB used, %.0f MB peak."),
+		Index, Label, NumPlayersInGame, NumLagSamples > 0 ? LagSumMS / NumLagSamples : 0.0, MaxLagMS,
+		NumCorrectionsThisReport, TimeSinceReport, TimeSinceReport > 0.0f ? NumCorrectionsThisReport / TimeSinceReport : 0.0f,
+		NumCorrections, TimeInGame, MemoryStats.UsedPhysical / (1024.0 * 1024.0), PeakUsedPhysical / (1024.0 * 1024.0));
+
+	LagSumMS = 0.0;
+	MaxLagMS = 0.0f;
+	NumLagSamples = 0;
+	NumCorrectionsThisReport = 0;
+	TimeSinceReport = 0.0f;
+}
+
+void UShooterTestControllerLoadGen::CheckMemoryFit() const
+{
+	const int32 NumPlayers = NumProcesses * FMath::Max(NumFakeClients, 1);
+	const double NeededMB = double(PeakUsedPhysical) * NumProcesses / (1024.0 * 1024.0);
+	const double TotalMB = FPlatformMemory::GetConstants().TotalPhysical / (1024.0 * 1024.0);
+	if (NeededMB > TotalMB)
+	{
+		UE_LOG(LogGauntlet, Warning, TEXT("Load gen %d: %d processes for %d fake players need about %.0f MB, more than the %.0f MB of this machine, spread them over more machines."), Index, NumProcesses, NumPlayers, NeededMB, TotalMB);
+	}
+	else
+	{
+		UE_LOG(LogGauntlet, Display, TEXT("Load gen %d: %d processes for %d fake players need about %.0f MB of the %.0f MB of this machine."), Index, NumProcesses, NumPlayers, NeededMB, TotalMB);
+	}
+}
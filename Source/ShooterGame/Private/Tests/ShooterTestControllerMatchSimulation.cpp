@@ -0,0 +1,417 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "Tests/ShooterTestControllerMatchSimulation.h"
+#include "ShooterGame.h"
+#include "Bots/ShooterAIController.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	void SetSimulationCVar(const TCHAR* Name, float Value)
+	{
+		IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+		if (CVar)
+		{
+			CVar->Set(Value, ECVF_SetByCode);
+		}
+	}
+}
+
+void UShooterTestControllerMatchSimulation::OnInit()
+{
+	Seed = 1;
+	NumBots = 16;
+	NumClients = 8;
+	TickRate = 30.0f;
+	WarmupSeconds = 10.0f;
+	DurationSeconds = 120.0f;
+	Tolerance = 0.1f;
+	bUpdateBaseline = FParse::Param(FCommandLine::Get(), TEXT("SimUpdateBaseline"));
+
+	FParse::Value(FCommandLine::Get(), TEXT("SimSeed="), Seed);
+	FParse::Value(FCommandLine::Get(), TEXT("SimBots="), NumBots);
+	FParse::Value(FCommandLine::Get(), TEXT("SimClients="), NumClients);
+	FParse::Value(FCommandLine::Get(), TEXT("SimClientExe="), ClientExecutable);
+	FParse::Value(FCommandLine::Get(), TEXT("SimTickRate="), TickRate);
+	FParse::Value(FCommandLine::Get(), TEXT("SimWarmup="), WarmupSeconds);
+	FParse::Value(FCommandLine::Get(), TEXT("SimDuration="), DurationSeconds);
+	FParse::Value(FCommandLine::Get(), TEXT("SimTolerance="), Tolerance);
+	FParse::Value(FCommandLine::Get(), TEXT("SimBaseline="), BaselineFilename);
+
+	// baselines are checked in with the project
+	if (!BaselineFilename.IsEmpty() && FPaths::IsRelative(BaselineFilename))
+	{
+		BaselineFilename = FPaths::ProjectDir() / BaselineFilename;
+	}
+
+	if (ClientExecutable.IsEmpty())
+	{
+		ClientExecutable = FPlatformProcess::ExecutablePath();
+	}
+
+	bStarted = false;
+	bClientsJoined = false;
+	bMeasuring = false;
+	bFinished = false;
+	StartTime = 0.0f;
+	LastFrameTime = 0.0;
+	ClientWaitSeconds = 0.0f;
+	OutBytesPerSecondSum = 0.0;
+	NumBandwidthSamples = 0;
+	NumObjectsCreated = 0;
+	StartUsedPhysical = 0;
+	EndUsedPhysical = 0;
+	NumCollections = 0;
+	CollectSeconds = 0.0;
+	MaxCollectSeconds = 0.0;
+	CollectStartTime = 0.0;
+	bListeningForCreates = false;
+
+	if (NumClients > 0)
+	{
+		// clients play in real time, so does the server they play on
+		SetSimulationCVar(TEXT("t.MaxFPS"), TickRate);
+	}
+	else
+	{
+		// every frame advances the match by the same time and nothing waits for the wall clock, so a run only depends on the seed
+		FApp::SetBenchmarking(true);
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(1.0 / FMath::Max(TickRate, 1.0f));
+	}
+
+	// neither do the budgets that would otherwise defer work depending on how fast the machine runs it
+	SetSimulationCVar(TEXT("ShooterAI.Scheduler.BudgetMs"), 0.0f);
+	SetSimulationCVar(TEXT("ShooterAI.TacticalPoints.BuildBudgetMs"), 0.0f);
+	SetSimulationCVar(TEXT("ShooterGC.Enabled"), 0.0f);
+
+	PreGarbageCollectDelegateHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UShooterTestControllerMatchSimulation::OnPreGarbageCollect);
+	PostGarbageCollectDelegateHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UShooterTestControllerMatchSimulation::OnPostGarbageCollect);
+
+	UE_LOG(LogGauntlet, Display, TEXT("Match simulation: seed %d, %d bots, %d clients, %.0f Hz, %.0f s warmup, %.0f s measured."), Seed, NumBots, NumClients, TickRate, WarmupSeconds, DurationSeconds);
+}
+
+void UShooterTestControllerMatchSimulation::BeginDestroy()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectDelegateHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectDelegateHandle);
+
+	if (bListeningForCreates)
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+		bListeningForCreates = false;
+	}
+
+	StopClients();
+
+	Super::BeginDestroy();
+}
+
+void UShooterTestControllerMatchSimulation::OnPostMapChange(UWorld* World)
+{
+	AShooterGameMode* GameMode = World ? World->GetAuthGameMode<AShooterGameMode>() : nullptr;
+	if (GameMode == nullptr)
+	{
+		// the entry map, the match map is loaded next
+		return;
+	}
+
+	if (bStarted)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Match simulation: map changed before the simulation finished."));
+		EndTest(-1);
+		return;
+	}
+
+	StartSimulation(GameMode);
+}
+
+void UShooterTestControllerMatchSimulation::StartSimulation(AShooterGameMode* GameMode)
+{
+	UWorld* World = GameMode->GetWorld();
+
+	// loading consumes random numbers depending on timing, seed once the map is in
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+
+	// beyond the bots the game mode made for the menu's bot count
+	int32 ExistingBots = 0;
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		if (Cast<AShooterAIController>(*It))
+		{
+			ExistingBots++;
+		}
+	}
+
+	for (int32 BotNum = ExistingBots; BotNum < NumBots; BotNum++)
+	{
+		GameMode->CreateBot(BotNum);
+	}
+
+	// skip the warmup countdown, StartMatch spawns the bots
+	if (GameMode->GetMatchState() == MatchState::WaitingToStart)
+	{
+		GameMode->StartMatch();
+	}
+
+	bStarted = true;
+	StartTime = World->GetTimeSeconds();
+
+	UE_LOG(LogGauntlet, Display, TEXT("Match simulation: started %s with %d bots."), *World->GetMapName(), NumBots);
+
+	bClientsJoined = NumClients <= 0;
+	if (!bClientsJoined && !StartClients(World))
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Match simulation: failed to start %s for the clients."), *ClientExecutable);
+		EndTest(-1);
+	}
+}
+
+bool UShooterTestControllerMatchSimulation::StartClients(UWorld* World)
+{
+	// the fake clients don't load the map, which this process has loaded: they play from a process of their own
+	FString Params = FString::Printf(TEXT("-nullrhi -nosound -unattended -gauntlet=ShooterTestControllerLoadGen -LoadGenServer=127.0.0.1:%d -LoadGenFakeClients=%d -LoadGenSeed=%d -LoadGenFPS=%.0f -LoadGenProcesses=1"),
+		World->URL.Port, NumClients, Seed, TickRate);
+#if !IS_MONOLITHIC
+	// modular executables run any project, tell them which
+	Params = FString::Printf(TEXT("\"%s\" -game %s"), *FPaths::GetProjectFilePath(), *Params);
+#endif
+
+	ClientProcess = FPlatformProcess::CreateProc(*ClientExecutable, *Params, true, true, true, nullptr, 0, nullptr, nullptr);
+	UE_LOG(LogGauntlet, Display, TEXT("Match simulation: %s %s %s"), ClientProcess.IsValid() ? TEXT("started") : TEXT("failed to start"), *ClientExecutable, *Params);
+	return ClientProcess.IsValid();
+}
+
+void UShooterTestControllerMatchSimulation::StopClients()
+{
+	if (ClientProcess.IsValid())
+	{
+		FPlatformProcess::TerminateProc(ClientProcess, true);
+		FPlatformProcess::CloseProc(ClientProcess);
+	}
+}
+
+int32 UShooterTestControllerMatchSimulation::CountClientsInGame(UWorld* World)
+{
+	int32 NumInGame = 0;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (It->Get() && It->Get()->GetNetConnection())
+		{
+			NumInGame++;
+		}
+	}
+	return NumInGame;
+}
+
+void UShooterTestControllerMatchSimulation::OnTick(float TimeDelta)
+{
+	UWorld* World = GetWorld();
+	if (!bStarted || bFinished || World == nullptr)
+	{
+		if (!bStarted && GetTimeInCurrentState() > 300)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Match simulation: no match map loaded after 300 secs!"));
+			EndTest(-1);
+		}
+		return;
+	}
+
+	if (!bClientsJoined)
+	{
+		if (CountClientsInGame(World) < NumClients)
+		{
+			ClientWaitSeconds += TimeDelta;
+			if (ClientWaitSeconds > 120.0f || !FPlatformProcess::IsProcRunning(ClientProcess))
+			{
+				UE_LOG(LogGauntlet, Error, TEXT("Match simulation: %d of %d clients in the match after %.0f secs!"), CountClientsInGame(World), NumClients, ClientWaitSeconds);
+				StopClients();
+				EndTest(-1);
+			}
+			return;
+		}
+
+		// the warmup starts once everyone is in
+		bClientsJoined = true;
+		StartTime = World->GetTimeSeconds();
+		UE_LOG(LogGauntlet, Display, TEXT("Match simulation: %d clients joined after %.0f secs."), NumClients, ClientWaitSeconds);
+	}
+
+	const float MatchTime = World->GetTimeSeconds() - StartTime;
+
+	if (!bMeasuring && MatchTime >= WarmupSeconds)
+	{
+		bMeasuring = true;
+		LastFrameTime = FPlatformTime::Seconds();
+		StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+
+		GUObjectArray.AddUObjectCreateListener(this);
+		bListeningForCreates = true;
+		return;
+	}
+
+	if (bMeasuring)
+	{
+		SampleFrame();
+
+		if (MatchTime >= WarmupSeconds + DurationSeconds)
+		{
+			FinishSimulation();
+		}
+	}
+}
+
+void UShooterTestControllerMatchSimulation::SampleFrame()
+{
+	// ticks once per frame, less the time the engine waited for the next tick in real time
+	const double Now = FPlatformTime::Seconds();
+	FrameTimesMS.Add(FMath::Max(Now - LastFrameTime - FApp::GetIdleTime(), 0.0) * 1000.0);
+	LastFrameTime = Now;
+
+	// the driver counts per second on its own, average what it reports
+	if (const UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+	{
+		OutBytesPerSecondSum += NetDriver->OutBytesPerSecond;
+		NumBandwidthSamples++;
+	}
+}
+
+void UShooterTestControllerMatchSimulation::FinishSimulation()
+{
+	bFinished = true;
+	EndUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	StopClients();
+
+	if (bListeningForCreates)
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+		bListeningForCreates = false;
+	}
+
+	const TArray<FSimulationMetric> Metrics = BuildMetrics();
+	for (const FSimulationMetric& Metric : Metrics)
+	{
+		UE_LOG(LogGauntlet, Display, TEXT("Match simulation: %s = %.3f"), *Metric.Name, Metric.Value);
+	}
+
+	const FString MapName = GetWorld()->GetMapName();
+	SaveMetrics(Metrics, FPaths::ProjectSavedDir() / TEXT("Simulation") / FString::Printf(TEXT("%s_Seed%d_Bots%d_Clients%d.json"), *MapName, Seed, NumBots, NumClients));
+
+	if (BaselineFilename.IsEmpty())
+	{
+		EndTest(0);
+	}
+	else if (bUpdateBaseline)
+	{
+		const bool bSaved = SaveMetrics(Metrics, BaselineFilename);
+		UE_LOG(LogGauntlet, Display, TEXT("Match simulation: %s baseline %s."), bSaved ? TEXT("updated") : TEXT("failed to update"), *BaselineFilename);
+		EndTest(bSaved ? 0 : -1);
+	}
+	else
+	{
+		EndTest(CompareToBaseline(Metrics, BaselineFilename) ? 0 : -1);
+	}
+}
+
+TArray<UShooterTestControllerMatchSimulation::FSimulationMetric> UShooterTestControllerMatchSimulation::BuildMetrics() const
+{
+	TArray<float> SortedFrameTimes = FrameTimesMS;
+	SortedFrameTimes.Sort();
+
+	auto Percentile = [&SortedFrameTimes](float Fraction)
+	{
+		return SortedFrameTimes.Num() > 0 ? SortedFrameTimes[FMath::Clamp(FMath::CeilToInt(SortedFrameTimes.Num() * Fraction) - 1, 0, SortedFrameTimes.Num() - 1)] : 0.0f;
+	};
+
+	const double MeasuredSeconds = FMath::Max(DurationSeconds, 1.0f);
+
+	TArray<FSimulationMetric> Metrics;
+	Metrics.Add({ TEXT("FrameTimeP50Ms"), Percentile(0.5f), 0.25 });
+	Metrics.Add({ TEXT("FrameTimeP90Ms"), Percentile(0.9f), 0.25 });
+	Metrics.Add({ TEXT("FrameTimeP99Ms"), Percentile(0.99f), 0.5 });
+	Metrics.Add({ TEXT("FrameTimeMaxMs"), SortedFrameTimes.Num() > 0 ? SortedFrameTimes.Last() : 0.0f, 5.0 });
+	Metrics.Add({ TEXT("ObjectsCreatedPerSecond"), NumObjectsCreated / MeasuredSeconds, 5.0 });
+	Metrics.Add({ TEXT("MemoryGrowthMB"), (double(EndUsedPhysical) - double(StartUsedPhysical)) / (1024.0 * 1024.0), 8.0 });
+	Metrics.Add({ TEXT("GarbageCollections"), double(NumCollections), 1.0 });
+	Metrics.Add({ TEXT("GarbageCollectTotalMs"), CollectSeconds * 1000.0, 5.0 });
+	Metrics.Add({ TEXT("GarbageCollectMaxMs"), MaxCollectSeconds * 1000.0, 2.0 });
+	Metrics.Add({ TEXT("OutBytesPerSecond"), NumBandwidthSamples > 0 ? OutBytesPerSecondSum / NumBandwidthSamples : 0.0, 256.0 });
+	return Metrics;
+}
+
+bool UShooterTestControllerMatchSimulation::CompareToBaseline(const TArray<FSimulationMetric>& Metrics, const FString& InBaselineFilename) const
+{
+	FString BaselineText;
+	TSharedPtr<FJsonObject> Baseline;
+	if (!FFileHelper::LoadFileToString(BaselineText, *InBaselineFilename) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineText), Baseline) || !Baseline.IsValid())
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Match simulation: failed to read baseline %s, run with -SimUpdateBaseline to create it."), *InBaselineFilename);
+		return false;
+	}
+
+	bool bPassed = true;
+	for (const FSimulationMetric& Metric : Metrics)
+	{
+		double BaselineValue = 0.0;
+		if (!Baseline->TryGetNumberField(Metric.Name, BaselineValue))
+		{
+			UE_LOG(LogGauntlet, Warning, TEXT("Match simulation: baseline has no %s, skipped."), *Metric.Name);
+			continue;
+		}
+
+		// every metric is better lower
+		const double Limit = BaselineValue + FMath::Max(FMath::Abs(BaselineValue) * Tolerance, Metric.MinRegression);
+		if (Metric.Value > Limit)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Match simulation: %s regressed to %.3f, baseline %.3f, limit %.3f."), *Metric.Name, Metric.Value, BaselineValue, Limit);
+			bPassed = false;
+		}
+	}
+
+	return bPassed;
+}
+
+bool UShooterTestControllerMatchSimulation::SaveMetrics(const TArray<FSimulationMetric>& Metrics, const FString& Filename)
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	for (const FSimulationMetric& Metric : Metrics)
+	{
+		Json->SetNumberField(Metric.Name, Metric.Value);
+	}
+
+	FString Text;
+	return FJsonSerializer::Serialize(Json, TJsonWriterFactory<>::Create(&Text)) && FFileHelper::SaveStringToFile(Text, *Filename);
+}
+
+void UShooterTestControllerMatchSimulation::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	// async loading creates objects on other threads, match play all happens on the game thread
+	if (IsInGameThread())
+	{
+		NumObjectsCreated++;
+	}
+}
+
+void UShooterTestControllerMatchSimulation::OnUObjectArrayShutdown()
+{
+	GUObjectArray.RemoveUObjectCreateListener(this);
+	bListeningForCreates = false;
+}
+
+void UShooterTestControllerMatchSimulation::OnPreGarbageCollect()
+{
+	CollectStartTime = FPlatformTime::Seconds();
+}
+
+void UShooterTestControllerMatchSimulation::OnPostGarbageCollect()
+{
+	if (bMeasuring && !bFinished && CollectStartTime > 0.0)
+	{
+		const double Seconds = FPlatformTime::Seconds() - CollectStartTime;
+		NumCollections++;
+		CollectSeconds += Seconds;
+		MaxCollectSeconds = FMath::Max(MaxCollectSeconds, Seconds);
+	}
+	CollectStartTime = 0.0;
+}
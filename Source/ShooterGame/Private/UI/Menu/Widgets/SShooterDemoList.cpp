@@ -9,15 +9,13 @@
 #include "ShooterGameInstance.h"
 #include "NetworkReplayStreaming.h"
 #include "ShooterGameViewportClient.h"
+#include "Online/ShooterReplayIndex.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
 struct FDemoEntry
 {
-	FNetworkReplayStreamInfo StreamInfo;
-	FString		Date;
-	FString		Size;
-	int32		ResultsIndex;
+	FShooterReplayInfo Info;
 };
 
 void SShooterDemoList::Construct(const FArguments& InArgs)
@@ -25,13 +23,15 @@ void SShooterDemoList::Construct(const FArguments& InArgs)
 	PlayerOwner			= InArgs._PlayerOwner;
 	OwnerWidget			= InArgs._OwnerWidget;
 	bUpdatingDemoList	= false;
+	bReconcilingDemoList = false;
 	StatusText			= FText::GetEmpty();
 	
 	EnumerateStreamsVersion = FNetworkVersion::GetReplayVersion();
 
-	const int32 NameWidth		= 280;
-	const int32 ViewersWidth	= 64;
-	const int32 DateWidth		= 210;
+	const int32 NameWidth		= 200;
+	const int32 MapWidth		= 110;
+	const int32 ViewersWidth	= 54;
+	const int32 DateWidth		= 180;
 	const int32 LengthWidth		= 64;
 
 	ChildSlot
@@ -70,6 +70,7 @@ void SShooterDemoList::Construct(const FArguments& InArgs)
 				.HeaderRow(
 					SNew(SHeaderRow)
 					+ SHeaderRow::Column("DemoName").FixedWidth(NameWidth).DefaultLabel(NSLOCTEXT("DemoList", "DemoNameColumn", "Demo Name"))
+					+ SHeaderRow::Column("Map").FixedWidth(MapWidth).DefaultLabel(NSLOCTEXT("DemoList", "MapColumn", "Map"))
 					+ SHeaderRow::Column("Viewers").FixedWidth(ViewersWidth).DefaultLabel(NSLOCTEXT("Viewers", "ViewersColumn", "Viewers"))
 					+ SHeaderRow::Column("Date").FixedWidth(DateWidth).DefaultLabel(NSLOCTEXT("DemoList", "DateColumn", "Date"))
 					+ SHeaderRow::Column("Length").FixedWidth(LengthWidth).DefaultLabel(NSLOCTEXT("Length", "LengthColumn", "Length"))
@@ -96,42 +97,18 @@ void SShooterDemoList::Construct(const FArguments& InArgs)
 	BuildDemoList();
 }
 
-void SShooterDemoList::OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result )
+void SShooterDemoList::OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result, FNetworkReplayVersion EnumeratedVersion)
 {
-	check(bUpdatingDemoList); // should not be called otherwise
+	bReconcilingDemoList = false;
 
-	bool bFinished = true;
-
-	for ( const auto& StreamInfo : Result.FoundStreams )
-	{
-		float SizeInKilobytes = StreamInfo.SizeInBytes / 1024.0f;
-
-		TSharedPtr<FDemoEntry> NewDemoEntry = MakeShareable( new FDemoEntry() );
-
-		NewDemoEntry->StreamInfo	= StreamInfo;
-		NewDemoEntry->Date			= StreamInfo.Timestamp.ToString( TEXT( "%m/%d/%Y %h:%M %A" ) );	// UTC time
-		NewDemoEntry->Size			= SizeInKilobytes >= 1024.0f ? FString::Printf( TEXT("%2.2f MB" ), SizeInKilobytes / 1024.0f ) : FString::Printf( TEXT("%i KB" ), (int)SizeInKilobytes );
-
-		DemoList.Add( NewDemoEntry );
-	}
-
-	// Sort demo names by date
-	struct FCompareDateTime
+	FShooterReplayIndex* ReplayIndex = GetReplayIndex();
+	if (ReplayIndex && Result.WasSuccessful())
 	{
-		FORCEINLINE bool operator()( const TSharedPtr<FDemoEntry> & A, const TSharedPtr<FDemoEntry> & B ) const
+		// the list already shows what the index knew, only touch it if the streamer disagrees
+		if (ReplayIndex->Reconcile(EnumeratedVersion, Result.FoundStreams))
 		{
-			return A->StreamInfo.Timestamp.GetTicks() > B->StreamInfo.Timestamp.GetTicks();
+			RefreshDemoList();
 		}
-	};
-
-	Sort( DemoList.GetData(), DemoList.Num(), FCompareDateTime() );
-
-	//StatusText = "";
-	StatusText = LOCTEXT("DemoSelectionInfo","Press ENTER to Play. Press DEL to delete.");
-
-	if ( bFinished )
-	{		
-		OnBuildDemoListFinished();
 	}
 }
 
@@ -177,24 +154,55 @@ void SShooterDemoList::OnShowAllReplaysChecked(ECheckBoxState NewCheckedState)
 	BuildDemoList();
 }
 
+FShooterReplayIndex* SShooterDemoList::GetReplayIndex() const
+{
+	UShooterGameInstance* const GI = PlayerOwner.IsValid() ? Cast<UShooterGameInstance>(PlayerOwner->GetGameInstance()) : nullptr;
+	return GI ? GI->GetReplayIndex() : nullptr;
+}
+
 /** Populates the demo list */
 void SShooterDemoList::BuildDemoList()
 {
-	bUpdatingDemoList = true;
-	DemoList.Empty();
+	// show what the index knows right away
+	RefreshDemoList();
 
-	if ( ReplayStreamer.IsValid() )
+	// and check it against the streamer in the background, in case replays were added or removed outside of the game
+	if ( ReplayStreamer.IsValid() && !bReconcilingDemoList )
 	{
-		ReplayStreamer->EnumerateStreams(EnumerateStreamsVersion, INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &SShooterDemoList::OnEnumerateStreamsComplete));
+		bReconcilingDemoList = true;
+		ReplayStreamer->EnumerateStreams(EnumerateStreamsVersion, INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &SShooterDemoList::OnEnumerateStreamsComplete, EnumerateStreamsVersion));
 	}
 }
 
-/** Called when demo list building is finished */
-void SShooterDemoList::OnBuildDemoListFinished()
+void SShooterDemoList::RefreshDemoList()
 {
-	bUpdatingDemoList = false;
+	const FString SelectedName = SelectedItem.IsValid() ? SelectedItem->Info.Name : FString();
+	int32 SelectedItemIndex = INDEX_NONE;
+
+	DemoList.Reset();
+
+	FShooterReplayIndex* ReplayIndex = GetReplayIndex();
+	if (ReplayIndex)
+	{
+		// already sorted newest first, rows are only generated for the visible entries
+		const bool bAllVersions = EnumerateStreamsVersion.NetworkVersion == 0;
+		for (const FShooterReplayInfo& Info : ReplayIndex->GetReplays())
+		{
+			if (bAllVersions || Info.NetworkVersion == EnumerateStreamsVersion.NetworkVersion)
+			{
+				if (Info.Name == SelectedName)
+				{
+					SelectedItemIndex = DemoList.Num();
+				}
+
+				TSharedPtr<FDemoEntry> NewDemoEntry = MakeShareable( new FDemoEntry() );
+				NewDemoEntry->Info = Info;
+				DemoList.Add( NewDemoEntry );
+			}
+		}
+	}
 
-	int32 SelectedItemIndex = DemoList.IndexOfByKey(SelectedItem);
+	StatusText = LOCTEXT("DemoSelectionInfo","Press ENTER to Play. Press DEL to delete.");
 
 	DemoListWidget->RequestListRefresh();
 	if (DemoList.Num() > 0)
@@ -202,6 +210,10 @@ void SShooterDemoList::OnBuildDemoListFinished()
 		DemoListWidget->UpdateSelectionSet();
 		DemoListWidget->SetSelection(DemoList[SelectedItemIndex > -1 ? SelectedItemIndex : 0],ESelectInfo::OnNavigation);
 	}
+	else
+	{
+		SelectedItem.Reset();
+	}
 }
 
 void SShooterDemoList::PlayDemo()
@@ -218,7 +230,7 @@ void SShooterDemoList::PlayDemo()
 
 		if ( GI != NULL )
 		{
-			FString DemoName = SelectedItem->StreamInfo.Name;
+			FString DemoName = SelectedItem->Info.Name;
 
 			// Play the demo
 			GI->PlayDemo( PlayerOwner.Get(), DemoName );
@@ -247,7 +259,7 @@ void SShooterDemoList::DeleteDemo()
 				ShooterViewport->ShowDialog( 
 					PlayerOwner,
 					EShooterDialogType::Generic,
-					FText::Format(LOCTEXT("DeleteDemoFmt", "Delete {0}?"), FText::FromString(SelectedItem->StreamInfo.FriendlyName)),
+					FText::Format(LOCTEXT("DeleteDemoFmt", "Delete {0}?"), FText::FromString(SelectedItem->Info.FriendlyName)),
 					LOCTEXT("EnterYes", "ENTER - YES"),
 					LOCTEXT("EscapeNo", "ESC - NO"),
 					FOnClicked::CreateRaw(this, &SShooterDemoList::OnDemoDeleteConfirm),
@@ -263,9 +275,8 @@ FReply SShooterDemoList::OnDemoDeleteConfirm()
 	if (SelectedItem.IsValid() && ReplayStreamer.IsValid())
 	{
 		bUpdatingDemoList = true;
-		DemoList.Empty();
 
-		ReplayStreamer->DeleteFinishedStream(SelectedItem->StreamInfo.Name, FDeleteFinishedStreamCallback::CreateSP(this, &SShooterDemoList::OnDeleteFinishedStreamComplete));
+		ReplayStreamer->DeleteFinishedStream(SelectedItem->Info.Name, FDeleteFinishedStreamCallback::CreateSP(this, &SShooterDemoList::OnDeleteFinishedStreamComplete, SelectedItem->Info.Name));
 	}
 
 	UShooterGameInstance* const GI = Cast<UShooterGameInstance>(PlayerOwner->GetGameInstance());
@@ -300,9 +311,20 @@ FReply SShooterDemoList::OnDemoDeleteCancel()
 	return FReply::Handled();
 }
 
-void SShooterDemoList::OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result)
+void SShooterDemoList::OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result, FString DeletedName)
 {
-	BuildDemoList();
+	bUpdatingDemoList = false;
+
+	FShooterReplayIndex* ReplayIndex = GetReplayIndex();
+	if (Result.WasSuccessful() && ReplayIndex)
+	{
+		ReplayIndex->RemoveReplay(DeletedName);
+		RefreshDemoList();
+	}
+	else
+	{
+		BuildDemoList();
+	}
 }
 
 void SShooterDemoList::OnFocusLost(const FFocusEvent& InFocusEvent)
@@ -400,7 +422,7 @@ TSharedRef<ITableRow> SShooterDemoList::MakeListViewWidget(TSharedPtr<FDemoEntry
 
 			if (ColumnName == "DemoName")
 			{
-				FString NameString = Item->StreamInfo.FriendlyName.IsEmpty() ? Item->StreamInfo.Name : Item->StreamInfo.FriendlyName;
+				FString NameString = Item->Info.FriendlyName.IsEmpty() ? Item->Info.Name : Item->Info.FriendlyName;
 
 				const int MAX_DEMO_NAME_DISPLAY_LEN = 18;
 				if ( NameString.Len() > MAX_DEMO_NAME_DISPLAY_LEN )
@@ -408,31 +430,36 @@ TSharedRef<ITableRow> SShooterDemoList::MakeListViewWidget(TSharedPtr<FDemoEntry
 					NameString = NameString.Left( MAX_DEMO_NAME_DISPLAY_LEN ) + TEXT( "..." );
 				}
 
-				if (Item->StreamInfo.bIsLive)
+				if (Item->Info.bIsLive)
 				{
 					NameString += " (Live)";
 				}
 
 				ItemText = FText::FromString(NameString);
 			}
+			else if (ColumnName == "Map")
+			{
+				ItemText = FText::FromString(Item->Info.MapName);
+			}
 			else if (ColumnName == "Viewers")
 			{
-				ItemText = FText::FromString( FString::Printf( TEXT( "%i" ), Item->StreamInfo.NumViewers ) );
+				ItemText = FText::FromString( FString::Printf( TEXT( "%i" ), Item->Info.NumViewers ) );
 			}
 			else if (ColumnName == "Date")
 			{
-				ItemText = FText::FromString(Item->Date);
+				ItemText = FText::FromString( Item->Info.Timestamp.ToString( TEXT( "%m/%d/%Y %h:%M %A" ) ) );	// UTC time
 			}
 			else if (ColumnName == "Length")
 			{
-				const int32 Minutes = Item->StreamInfo.LengthInMS / ( 1000 * 60 );
-				const int32 Seconds = ( Item->StreamInfo.LengthInMS / 1000 ) % 60;
+				const int32 Minutes = Item->Info.LengthInMS / ( 1000 * 60 );
+				const int32 Seconds = ( Item->Info.LengthInMS / 1000 ) % 60;
 
 				ItemText = FText::FromString( FString::Printf( TEXT( "%02i:%02i" ), Minutes, Seconds ) );
 			}
 			else if (ColumnName == "Size")
 			{
-				ItemText = FText::FromString(Item->Size);
+				const float SizeInKilobytes = Item->Info.SizeInBytes / 1024.0f;
+				ItemText = FText::FromString( SizeInKilobytes >= 1024.0f ? FString::Printf( TEXT("%2.2f MB" ), SizeInKilobytes / 1024.0f ) : FString::Printf( TEXT("%i KB" ), (int)SizeInKilobytes ) );
 			}
 
 			return SNew(STextBlock)
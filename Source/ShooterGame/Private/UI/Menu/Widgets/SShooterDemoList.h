@@ -10,6 +10,7 @@
 #include "Misc/NetworkVersion.h"
 
 struct FDemoEntry;
+class FShooterReplayIndex;
 
 //class declare
 class SShooterDemoList : public SShooterMenuWidget
@@ -50,14 +51,14 @@ public:
 	/** Updates the list until it's completely populated */
 	void UpdateBuildDemoListStatus();
 
-	/** Populates the demo list */
+	/** Populates the demo list from the replay index and reconciles the index with the replay streamer in the background */
 	void BuildDemoList();
 
-	/** Called when demo list building finished */
-	void OnBuildDemoListFinished();
+	/** Fills the list from the replay index, keeping the selection */
+	void RefreshDemoList();
 
 	/** Called when we get results from the replay streaming interface */
-	void OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result);
+	void OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result, FNetworkReplayVersion EnumeratedVersion);
 
 	/** Play chosen demo */
 	void PlayDemo();
@@ -72,7 +73,7 @@ public:
 	FReply OnDemoDeleteCancel();
 
 	/** Called by delegate when the replay streaming interface has finished deleting */
-	void OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result);
+	void OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result, FString DeletedName);
 
 	/** selects item at current + MoveBy index */
 	void MoveSelection(int32 MoveBy);
@@ -96,11 +97,17 @@ private:
 	/** Version used for enumerating replays. This is manipulated depending on whether we want to show all versions or not. */
 	FNetworkReplayVersion EnumerateStreamsVersion;
 
+	/** index of local replays the list is filled from */
+	FShooterReplayIndex* GetReplayIndex() const;
+
 protected:
 
-	/** Whether we're building the demo list or not */
+	/** Whether we're waiting for a demo to be deleted, input is locked meanwhile */
 	bool bUpdatingDemoList;
 
+	/** Whether the replay index is being reconciled with the replay streamer */
+	bool bReconcilingDemoList;
+
 	/** action bindings array */
 	TArray< TSharedPtr<FDemoEntry> > DemoList;
 
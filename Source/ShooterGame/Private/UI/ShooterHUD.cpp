@@ -9,6 +9,9 @@
 #include "Weapons/ShooterDamageType.h"
 #include "Weapons/ShooterWeapon_Instant.h"
 #include "Online/ShooterPlayerState.h"
+#include "Online/ShooterMatchResults.h"
+#include "Player/ShooterDemoSpectator.h"
+#include "ShooterGameInstance.h"
 #include "Misc/NetworkVersion.h"
 #include "OnlineSubsystemUtils.h"
 #include "ShooterGameUserSettings.h"
@@ -16,8 +19,30 @@
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
+DECLARE_STATS_GROUP(TEXT("ShooterHUD"), STATGROUP_ShooterHUD, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Draw HUD"), STAT_ShooterHUD_DrawHUD, STATGROUP_ShooterHUD);
+DECLARE_CYCLE_STAT(TEXT("Weapon"), STAT_ShooterHUD_Weapon, STATGROUP_ShooterHUD);
+DECLARE_CYCLE_STAT(TEXT("Match Timer And Position"), STAT_ShooterHUD_MatchTimer, STATGROUP_ShooterHUD);
+DECLARE_CYCLE_STAT(TEXT("Death Messages"), STAT_ShooterHUD_DeathMessages, STATGROUP_ShooterHUD);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Text Rebuilds"), STAT_ShooterHUD_TextRebuilds, STATGROUP_ShooterHUD);
+
 const float AShooterHUD::MinHudScale = 0.5f;
 
+void FShooterHUDText::Update(UCanvas* Canvas, UFont* Font, int64 NewKey, TFunctionRef<FString()> MakeString)
+{
+	if (NewKey != Key || Font != MeasuredFont)
+	{
+		const FString String = MakeString();
+		Canvas->StrLen(Font, String, Size.X, Size.Y);
+		Text = FText::FromString(String);
+		Key = NewKey;
+		MeasuredFont = Font;
+
+		INC_DWORD_STAT(STAT_ShooterHUD_TextRebuilds);
+	}
+}
+
 AShooterHUD::AShooterHUD(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	NoAmmoFadeOutTime =  1.0f;
@@ -105,6 +130,12 @@ void AShooterHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	ConditionalCloseScoreboard(true);
 
+	UShooterGameInstance* SGI = GetWorld() ? Cast<UShooterGameInstance>(GetWorld()->GetGameInstance()) : nullptr;
+	if (SGI && SGI->GetMatchResults())
+	{
+		SGI->GetMatchResults()->OnResultsPosted.Remove(MatchResultsPostedHandle);
+	}
+
 	AShooterPlayerController* ShooterPC = Cast<AShooterPlayerController>(PlayerOwner);
 	if (ShooterPC != NULL )
 	{
@@ -138,6 +169,8 @@ FString AShooterHUD::GetTimeString(float TimeSeconds)
 
 void AShooterHUD::DrawWeaponHUD()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterHUD_Weapon);
+
 	AShooterCharacter* MyPawn = CastChecked<AShooterCharacter>(GetOwningPawn());
 	AShooterWeapon* MyWeapon = MyPawn->GetWeapon();
 	if (MyWeapon)
@@ -183,25 +216,28 @@ void AShooterHUD::DrawWeaponHUD()
 			const float TextOffset = 12;
 			float SizeX, SizeY;
 			float TopTextHeight;
-			FString Text = FString::FromInt(MyWeapon->GetCurrentAmmoInClip());
-
-			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+			const int32 AmmoInClip = MyWeapon->GetCurrentAmmoInClip();
+			PrimaryClipText.Update(Canvas, BigFont, AmmoInClip, [AmmoInClip]() { return FString::FromInt(AmmoInClip); });
+			SizeX = PrimaryClipText.Size.X;
+			SizeY = PrimaryClipText.Size.Y;
 
 			const float TopTextScale = 0.73f; // of 51pt font
 			const float TopTextPosX = Canvas->ClipX - Canvas->OrgX - (PriWeaponBoxWidth + Offset * 2 + (BoxWidth + SizeX * TopTextScale) / 2.0f)  * ScaleUI;
 			const float TopTextPosY = Canvas->ClipY - Canvas->OrgY - (PriWeapOffsetY + PrimaryWeapBg.VL + Offset - TextOffset / 2.0f) * ScaleUI; 
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = PrimaryClipText.Text;
 			TextItem.Scale = FVector2D( TopTextScale * ScaleUI, TopTextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			Canvas->DrawItem( TextItem, TopTextPosX, TopTextPosY );
 			TopTextHeight = SizeY * TopTextScale;
-			Text = FString::FromInt(MyWeapon->GetCurrentAmmo() - MyWeapon->GetCurrentAmmoInClip());
-			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+			const int32 SpareAmmo = MyWeapon->GetCurrentAmmo() - AmmoInClip;
+			PrimaryAmmoText.Update(Canvas, BigFont, SpareAmmo, [SpareAmmo]() { return FString::FromInt(SpareAmmo); });
+			SizeX = PrimaryAmmoText.Size.X;
+			SizeY = PrimaryAmmoText.Size.Y;
 
 			const float BottomTextScale = 0.49f; // of 51pt font
 			const float BottomTextPosX = Canvas->ClipX - Canvas->OrgX - (PriWeaponBoxWidth + Offset * 2 + (BoxWidth + SizeX * BottomTextScale) / 2.0f) * ScaleUI; 
 			const float BottomTextPosY = TopTextPosY + (TopTextHeight - 0.8f * TextOffset) * ScaleUI;
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = PrimaryAmmoText.Text;
 			TextItem.Scale = FVector2D( BottomTextScale*ScaleUI, BottomTextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			Canvas->DrawItem( TextItem, BottomTextPosX, BottomTextPosY );
@@ -303,16 +339,17 @@ void AShooterHUD::DrawWeaponHUD()
 			const float TextOffset = 10;
 			float SizeX, SizeY;
 			float TopTextHeight;
-			FString Text = FString::FromInt(SecondaryWeapon->GetCurrentAmmo());
-
-			Canvas->StrLen(BigFont,Text, SizeX, SizeY);
+			const int32 SecondaryAmmo = SecondaryWeapon->GetCurrentAmmo();
+			SecondaryAmmoText.Update(Canvas, BigFont, SecondaryAmmo, [SecondaryAmmo]() { return FString::FromInt(SecondaryAmmo); });
+			SizeX = SecondaryAmmoText.Size.X;
+			SizeY = SecondaryAmmoText.Size.Y;
 			const float TopTextScale = 0.53f; // of 51pt font
 			TopTextHeight = SizeY * TopTextScale;
 
 			const float TopTextPosX = Canvas->ClipX - Canvas->OrgX - (SecWeaponBoxWidth + Offset * 2 + (SecClipBoxWidth + SizeX * TopTextScale) / 2.0f)  * ScaleUI;
 			const float TopTextPosY = SecWeapBgPosY + (SecondaryWeapBg.VL - TopTextHeight) / 2.0f * ScaleUI; 
 
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = SecondaryAmmoText.Text;
 			TextItem.Scale = FVector2D( TopTextScale * ScaleUI, TopTextScale * ScaleUI );
 			Canvas->DrawItem( TextItem, TopTextPosX, TopTextPosY );
 		}
@@ -359,6 +396,13 @@ void AShooterHUD::DrawNVIDIAReflexTimers()
 				LatencyRender = LatencyMarkerModule->GetRenderLatencyInMs();
 				Framerate = deltasec > Epsilon ? 1.0f / deltasec : 0.0f;
 
+				FNumberFormattingOptions FmtOptions;
+				FmtOptions.SetMaximumFractionalDigits(2);
+				FramerateString = FText::AsNumber(Framerate, &FmtOptions).ToString();
+				LatencyTotalString = FText::AsNumber(LatencyTotal, &FmtOptions).ToString();
+				LatencyGameString = FText::AsNumber(LatencyGame, &FmtOptions).ToString();
+				LatencyRenderString = FText::AsNumber(LatencyRender, &FmtOptions).ToString();
+
 				TimePassed = 0.0f;
 			}
 			bLatencyModuleEnabled = true;
@@ -374,33 +418,32 @@ void AShooterHUD::DrawNVIDIAReflexTimers()
 		float height = 35.0f * ScaleUI;
 		float currentY = Canvas->OrgY + offsetY;
 
-		FNumberFormattingOptions FmtOptions;
-		FmtOptions.SetMaximumFractionalDigits(2);
-
 		if (UserSettings->GetFramerateVisibility())
 		{
-			DrawPerfTimer(TEXT("Client FPS"), FText::AsNumber(Framerate, &FmtOptions).ToString(), Canvas->OrgX + offsetX, currentY);
+			DrawPerfTimer(TEXT("Client FPS"), FramerateString, Canvas->OrgX + offsetX, currentY);
 			currentY += height;
 		}
 		if (UserSettings->GetGameToRenderVisibility())
 		{
-			DrawPerfTimer(TEXT("Game to Render Latency"), FText::AsNumber(LatencyTotal, &FmtOptions).ToString(), Canvas->OrgX + offsetX, currentY);
+			DrawPerfTimer(TEXT("Game to Render Latency"), LatencyTotalString, Canvas->OrgX + offsetX, currentY);
 			currentY += height;
 		}
 		if (UserSettings->GetGameLatencyVisibility())
 		{
-			DrawPerfTimer(TEXT("Game Latency"), FText::AsNumber(LatencyGame, &FmtOptions).ToString(), Canvas->OrgX + offsetX, currentY);
+			DrawPerfTimer(TEXT("Game Latency"), LatencyGameString, Canvas->OrgX + offsetX, currentY);
 			currentY += height;
 		}
 		if (UserSettings->GetRenderLatencyVisibility())
 		{
-			DrawPerfTimer(TEXT("Render Latency"), FText::AsNumber(LatencyRender, &FmtOptions).ToString(), Canvas->OrgX + offsetX, currentY);
+			DrawPerfTimer(TEXT("Render Latency"), LatencyRenderString, Canvas->OrgX + offsetX, currentY);
 		}
 	}
 }
 
 void AShooterHUD::DrawMatchTimerAndPosition()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterHUD_MatchTimer);
+
 	AShooterGameState* const MyGameState = GetWorld()->GetGameState<AShooterGameState>();
 	Canvas->SetDrawColor(FColor::White);
 	const float TimerPosX = Canvas->ClipX - Canvas->OrgX - (TimePlaceBg.UL + Offset) * ScaleUI;
@@ -417,41 +460,44 @@ void AShooterHUD::DrawMatchTimerAndPosition()
 		TextItem.EnableShadow( FLinearColor::Black );
 		float SizeX, SizeY;
 		float TextScale = 0.57f;
-		FString Text;
 		TextItem.FontRenderInfo = ShadowedFont;
 		TextItem.Scale = FVector2D( TextScale*ScaleUI, TextScale*ScaleUI );
 		if (MyGameState->GetMatchState() == MatchState::WaitingToStart)
 		{
 			TextItem.Scale = FVector2D( ScaleUI, ScaleUI );
-			Text = LOCTEXT("WarmupString","MATCH STARTS IN: ").ToString() + FString::FromInt(MyGameState->RemainingTime);
+			const int32 RemainingTime = MyGameState->RemainingTime;
+			WarmupText.Update(Canvas, BigFont, RemainingTime, [RemainingTime]() { return LOCTEXT("WarmupString","MATCH STARTS IN: ").ToString() + FString::FromInt(RemainingTime); });
 			TextItem.SetColor( HUDLight );
-			TextItem.Text = FText::FromString( Text );			
+			TextItem.Text = WarmupText.Text;
 			AddMatchInfoString(TextItem);
 		}
 		else if (MyGameState->GetMatchState() == MatchState::InProgress)
 		{
-			Text = GetTimeString(MyGameState->RemainingTime);
-			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+			const int32 RemainingTime = MyGameState->RemainingTime;
+			MatchTimerText.Update(Canvas, BigFont, RemainingTime, [this, RemainingTime]() { return GetTimeString(RemainingTime); });
+			SizeX = MatchTimerText.Size.X;
+			SizeY = MatchTimerText.Size.Y;
 
 			TextItem.SetColor( HUDDark );
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = MatchTimerText.Text;
 			TextItem.Position = FVector2D( TimerPosX + Offset * 1.5f * ScaleUI + TimerIcon.UL * ScaleUI,
 				TimerPosY + (TimePlaceBg.VL * ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
 			Canvas->DrawItem(TextItem);
 		}
 
 		float BoxWidth = 45.0f * ScaleUI;
-		Text = FString();
 		AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(PlayerOwner);
 		if (MyPC && MyGameState && MatchState == EShooterMatchState::Playing)
 		{
 			AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(MyPC->PlayerState);
 			if (MyPlayerState)
 			{
+				int32 MyPos = 0;
+				int32 NumRanked = 0;
 				if (MyGameState->NumTeams > 1) // team based game
 				{
 					int32 MyTeam = MyPlayerState->GetTeamNum();
-					int32 MyPos = FMath::Max(1, MyGameState->TeamScores.Num());
+					MyPos = FMath::Max(1, MyGameState->TeamScores.Num());
 					for (int32 i=0; i < MyGameState->TeamScores.Num(); i++)
 					{
 						if (MyGameState->TeamScores.Num() > MyTeam &&
@@ -460,32 +506,28 @@ void AShooterHUD::DrawMatchTimerAndPosition()
 							MyPos--;
 						}
 					}
-					int32 NumTeams = 0;
 					for (int32 i=0; i < MyGameState->NumTeams; i++)
 					{
-						RankedPlayerMap PlayerStateMap;
-						MyGameState->GetRankedMap(i,PlayerStateMap);
-						if(PlayerStateMap.Num() > 0)
+						if (MyGameState->GetRankedPlayers(i).Num() > 0)
 						{
-							NumTeams++;
+							NumRanked++;
 						}
 					}
-					Text = FString::Printf(TEXT("%d/%d"), MyPos, NumTeams);
 				}
 				else // free for all
 				{
-					RankedPlayerMap PlayerStateMap;
-					MyGameState->GetRankedMap(0,PlayerStateMap);
-					const int32* MyRank = PlayerStateMap.FindKey(MyPlayerState);
-					int32 MyPos = MyRank ? *MyRank + 1 : 0;
-					Text = FString::Printf(TEXT("%d/%d"), MyPos, PlayerStateMap.Num());
+					const int32 MyRank = MyGameState->GetPlayerRank(MyPlayerState);
+					MyPos = MyRank != INDEX_NONE ? MyRank + 1 : 0;
+					NumRanked = MyGameState->GetRankedPlayers(0).Num();
 				}
-				Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+				PositionText.Update(Canvas, BigFont, ((int64)MyPos << 32) | (uint32)NumRanked, [MyPos, NumRanked]() { return FString::Printf(TEXT("%d/%d"), MyPos, NumRanked); });
+				SizeX = PositionText.Size.X;
+				SizeY = PositionText.Size.Y;
 				Canvas->DrawIcon(PlaceIcon,
 					Canvas->ClipX - Canvas->OrgX - BoxWidth  - (SizeX * TextScale + PlaceIcon.UL + Offset/4) * ScaleUI,
 					TimerPosY + (TimePlaceBg.VL - PlaceIcon.VL) / 2.0f * ScaleUI, ScaleUI);
 
-				TextItem.Text = FText::FromString( Text);
+				TextItem.Text = PositionText.Text;
 				TextItem.Scale = FVector2D(TextScale*ScaleUI, TextScale*ScaleUI);
 				TextItem.FontRenderInfo = ShadowedFont;
 				Canvas->DrawItem( TextItem, Canvas->ClipX - Canvas->OrgX - (BoxWidth  + SizeX * TextScale * ScaleUI),
@@ -514,28 +556,24 @@ void AShooterHUD::DrawKills()
 	TextItem.EnableShadow( FLinearColor::Black );
 
 	float SizeX, SizeY;
-	FString Text = LOCTEXT("Kills", "KILLS:").ToString();
-	Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+	KillsLabelText.Update(Canvas, BigFont, 0, []() { return LOCTEXT("Kills", "KILLS:").ToString(); });
+	SizeX = KillsLabelText.Size.X;
+	SizeY = KillsLabelText.Size.Y;
 
-	TextItem.Text = FText::FromString( Text );
+	TextItem.Text = KillsLabelText.Text;
 	TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 	TextItem.FontRenderInfo = ShadowedFont;
 	TextItem.SetColor(HUDDark);
 	Canvas->DrawItem( TextItem, KillsPosX + Offset * ScaleUI + KillsIcon.UL * 1.5f * ScaleUI,
 		KillsPosY + (KillsBg.VL * ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
 
-	if (MyPlayerState)
-	{
-		Text = FString::FromInt(MyPlayerState->GetKills());
-	}
-	else 
-	{
-		Text = FString("0");
-	}
+	const int32 NumKills = MyPlayerState->GetKills();
+	KillsText.Update(Canvas, BigFont, NumKills, [NumKills]() { return FString::FromInt(NumKills); });
 	TextScale = 0.88f;
 	float BoxWidth = 135.0f * ScaleUI;
-	Canvas->StrLen(BigFont, Text, SizeX, SizeY);
-	TextItem.Text = FText::FromString( Text );
+	SizeX = KillsText.Size.X;
+	SizeY = KillsText.Size.Y;
+	TextItem.Text = KillsText.Text;
 	TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 	Canvas->DrawItem( TextItem, KillsPosX + KillsBg.UL * ScaleUI - (BoxWidth + SizeX * TextScale * ScaleUI) /2,
 		KillsPosY + (KillsBg.VL* ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
@@ -554,8 +592,10 @@ void AShooterHUD::NotifyEnemyHit()
 
 void AShooterHUD::DrawHUD()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterHUD_DrawHUD);
+
 	Super::DrawHUD();
-	if (Canvas == nullptr)
+	if (Canvas == nullptr || AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
 	{
 		return;
 	}
@@ -605,30 +645,14 @@ void AShooterHUD::DrawHUD()
 		Canvas->ApplySafeZoneTransform();
 	}
 
-	// net mode
+#if !UE_BUILD_SHIPPING
+	// net mode, session info is looked up again once per second
 	if (GetNetMode() != NM_Standalone)
 	{
-		FString NetModeDesc = (GetNetMode() == NM_Client) ? TEXT("Client") : TEXT("Server");
-		IOnlineSubsystem * OnlineSubsystem = Online::GetSubsystem(GetWorld());
-		if(OnlineSubsystem)
-		{
-			IOnlineSessionPtr SessionSubsystem = OnlineSubsystem->GetSessionInterface();
-			if(SessionSubsystem.IsValid())
-			{
-				FNamedOnlineSession * Session = SessionSubsystem->GetNamedSession(NAME_GameSession);
-				if(Session && Session->SessionInfo.IsValid())
-				{
-					NetModeDesc += TEXT("\nSession: ");
-					NetModeDesc += Session->GetSessionIdStr();
-				}
-			}
-
-		}
-
-		NetModeDesc += FString::Printf( TEXT( "\nVersion: %i, %s, %s" ), FNetworkVersion::GetNetworkCompatibleChangelist(), UTF8_TO_TCHAR(__DATE__), UTF8_TO_TCHAR(__TIME__) );
-
-		DrawDebugInfoString(NetModeDesc, Canvas->OrgX + Offset*ScaleUI, Canvas->OrgY + 5*Offset*ScaleUI, true, true, HUDLight);
+		NetModeText.Update(Canvas, NormalFont, FMath::FloorToInt(GetWorld()->GetRealTimeSeconds()), [this]() { return GetNetModeDesc(); });
+		DrawDebugInfoString(NetModeText, Canvas->OrgX + Offset*ScaleUI, Canvas->OrgY + 5*Offset*ScaleUI, true, true, HUDLight);
 	}
+#endif
 
 	DrawNVIDIAReflexTimers();
 	DrawMatchTimerAndPosition();
@@ -684,17 +708,44 @@ void AShooterHUD::DrawHUD()
 			AddMatchInfoString(TextItem);			
 		}
 	}
+	else if (IsMatchOver())
+	{
+		DrawMatchResultsStatus();
+	}
 
 	// Render the info messages such as wating to respawn - these will be drawn below any 'killed player' message.
 	ShowInfoItems(MessageOffset, 1.0f);
 	
 }
 
-void AShooterHUD::DrawDebugInfoString(const FString& Text, float PosX, float PosY, bool bAlignLeft, bool bAlignTop, const FColor& TextColor)
+FString AShooterHUD::GetNetModeDesc() const
+{
+	FString NetModeDesc = (GetNetMode() == NM_Client) ? TEXT("Client") : TEXT("Server");
+
+	IOnlineSubsystem * OnlineSubsystem = Online::GetSubsystem(GetWorld());
+	if(OnlineSubsystem)
+	{
+		IOnlineSessionPtr SessionSubsystem = OnlineSubsystem->GetSessionInterface();
+		if(SessionSubsystem.IsValid())
+		{
+			FNamedOnlineSession * Session = SessionSubsystem->GetNamedSession(NAME_GameSession);
+			if(Session && Session->SessionInfo.IsValid())
+			{
+				NetModeDesc += TEXT("\nSession: ");
+				NetModeDesc += Session->GetSessionIdStr();
+			}
+		}
+	}
+
+	NetModeDesc += FString::Printf( TEXT( "\nVersion: %i, %s, %s" ), FNetworkVersion::GetNetworkCompatibleChangelist(), UTF8_TO_TCHAR(__DATE__), UTF8_TO_TCHAR(__TIME__) );
+	return NetModeDesc;
+}
+
+void AShooterHUD::DrawDebugInfoString(const FShooterHUDText& Text, float PosX, float PosY, bool bAlignLeft, bool bAlignTop, const FColor& TextColor)
 {
 #if !UE_BUILD_SHIPPING
-	float SizeX, SizeY;
-	Canvas->StrLen(NormalFont, Text, SizeX, SizeY);
+	const float SizeX = Text.Size.X;
+	const float SizeY = Text.Size.Y;
 
 	const float UsePosX = bAlignLeft ? PosX : PosX - SizeX;
 	const float UsePosY = bAlignTop ? PosY : PosY - SizeY;
@@ -711,7 +762,7 @@ void AShooterHUD::DrawDebugInfoString(const FString& Text, float PosX, float Pos
 	TileItem.BlendMode = SE_BLEND_Translucent;
 	Canvas->DrawItem( TileItem );
 
-	FCanvasTextItem TextItem( FVector2D( UsePosX, UsePosY), FText::FromString( Text ), NormalFont, TextColor );
+	FCanvasTextItem TextItem( FVector2D( UsePosX, UsePosY), Text.Text, NormalFont, TextColor );
 	TextItem.EnableShadow( FLinearColor::Black );
 	TextItem.FontRenderInfo = ShadowedFont;
 	TextItem.Scale = FVector2D( ScaleUI, ScaleUI );
@@ -809,6 +860,8 @@ void AShooterHUD::DrawCrosshair()
 
 void AShooterHUD::DrawDeathMessages()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterHUD_DeathMessages);
+
 	if (PlayerOwner == NULL)
 	{
 		return;
@@ -829,8 +882,8 @@ void AShooterHUD::DrawDeathMessages()
 	const FColor RedTeamColor = FColor(152, 70, 70, 255);
 	const FColor OwnerColor = HUDLight;
 
-	const FString KilledText = LOCTEXT("killed"," killed ").ToString();
-	FVector2D KilledTextSize(0.0f, 0.0f);
+	KilledLabelText.Update(Canvas, NormalFont, 0, []() { return LOCTEXT("killed"," killed ").ToString(); });
+	const FVector2D KilledTextSize = KilledLabelText.Size;
 
 	const float GameTime = GetWorld()->GetTimeSeconds();
 	const float LinePadding = 6.0f;
@@ -842,23 +895,22 @@ void AShooterHUD::DrawDeathMessages()
 	// draw messages
 	float CurrentY = InitialY;
 
-	Canvas->StrLen(NormalFont, KilledText, KilledTextSize.X, KilledTextSize.Y);
-
 	FCanvasTextItem TextItem( FVector2D::ZeroVector, FText::GetEmpty(), NormalFont, HUDDark );
 	TextItem.EnableShadow( FLinearColor::Black );
 	for (int32 i = DeathMessages.Num() - 1; i >= 0; i--)
 	{
-		const FDeathMessage& Message = DeathMessages[i];
+		FDeathMessage& Message = DeathMessages[i];
 		float CurrentX = InitialX;
-		FVector2D KillerSize(0.0f, 0.0f);
-		FVector2D VictimNameSize(0.0f, 0.0f);
 		float TextScale = 1.00f;
-		Canvas->StrLen(NormalFont, Message.KillerDesc, KillerSize.X, KillerSize.Y);
+		// names don't change once the message is added, so they are only measured the first time the message is drawn
+		Message.KillerText.Update(Canvas, NormalFont, 0, [&Message]() { return Message.KillerDesc; });
+		Message.VictimText.Update(Canvas, NormalFont, 0, [&Message]() { return Message.VictimDesc; });
+		const FVector2D KillerSize = Message.KillerText.Size;
 		TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 		TextItem.FontRenderInfo = ShadowedFont;
 		TextItem.SetColor(Message.bKillerIsOwner == true ? HUDLight : ( Message.KillerTeamNum == 0 ? RedTeamColor : BlueTeamColor));
 
-		TextItem.Text = FText::FromString( Message.KillerDesc );
+		TextItem.Text = Message.KillerText.Text;
 		Canvas->DrawItem(TextItem, CurrentX, CurrentY);
 		CurrentX += KillerSize.X * TextScale * ScaleUI;
 		
@@ -873,7 +925,7 @@ void AShooterHUD::DrawDeathMessages()
 		}
 		else
 		{
-			TextItem.Text = FText::FromString( KilledText );
+			TextItem.Text = KilledLabelText.Text;
 			TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			TextItem.SetColor(HUDDark);
@@ -884,8 +936,7 @@ void AShooterHUD::DrawDeathMessages()
 			
 		TextItem.SetColor(Message.bVictimIsOwner == true ? HUDLight : (Message.VictimTeamNum == 0 ? RedTeamColor : BlueTeamColor));		
 
-		Canvas->StrLen(NormalFont, Message.VictimDesc, VictimNameSize.X, VictimNameSize.Y);
-		TextItem.Text = FText::FromString( Message.VictimDesc );
+		TextItem.Text = Message.VictimText.Text;
 		Canvas->DrawItem( TextItem, CurrentX, CurrentY );
 		CurrentY -= (KilledTextSize.Y + LinePadding) * TextScale * ScaleUI;
 	}
@@ -1069,6 +1120,46 @@ void AShooterHUD::PostInitializeComponents()
 			Voice->AddOnPlayerTalkingStateChangedDelegate_Handle(OnPlayerTalkingStateChangedDelegate);
 		}
 	}
+
+	UShooterGameInstance* SGI = Cast<UShooterGameInstance>(GetGameInstance());
+	if (SGI && SGI->GetMatchResults())
+	{
+		MatchResultsPostedHandle = SGI->GetMatchResults()->OnResultsPosted.AddUObject(this, &AShooterHUD::OnMatchResultsPosted);
+	}
+}
+
+void AShooterHUD::OnMatchResultsPosted(int32 ControllerId, bool bWasSuccessful)
+{
+	const ULocalPlayer* LocalPlayer = PlayerOwner ? PlayerOwner->GetLocalPlayer() : nullptr;
+	if (LocalPlayer && LocalPlayer->GetControllerId() == ControllerId)
+	{
+		MatchResultsStatus = bWasSuccessful ? LOCTEXT("MatchResultsPosted", "MATCH RESULTS SAVED") : LOCTEXT("MatchResultsFailed", "MATCH RESULTS COULD NOT BE SAVED");
+	}
+}
+
+void AShooterHUD::DrawMatchResultsStatus()
+{
+	const UShooterGameInstance* SGI = Cast<UShooterGameInstance>(GetGameInstance());
+	const ULocalPlayer* LocalPlayer = PlayerOwner ? PlayerOwner->GetLocalPlayer() : nullptr;
+	if (SGI == nullptr || SGI->GetMatchResults() == nullptr || LocalPlayer == nullptr)
+	{
+		return;
+	}
+
+	const FText& Text = SGI->GetMatchResults()->IsPosting(LocalPlayer->GetControllerId()) ? LOCTEXT("MatchResultsPosting", "SAVING MATCH RESULTS...") : MatchResultsStatus;
+	if (Text.IsEmpty())
+	{
+		return;
+	}
+
+	float SizeX, SizeY;
+	Canvas->StrLen(NormalFont, Text.ToString(), SizeX, SizeY);
+
+	FCanvasTextItem TextItem(FVector2D::ZeroVector, Text, NormalFont, HUDLight);
+	TextItem.EnableShadow(FLinearColor::Black);
+	TextItem.FontRenderInfo = ShadowedFont;
+	TextItem.Scale = FVector2D(ScaleUI, ScaleUI);
+	Canvas->DrawItem(TextItem, Canvas->OrgX + (Canvas->ClipX - SizeX * ScaleUI) / 2.0f, Canvas->ClipY - (Offset + SizeY) * ScaleUI);
 }
 
 void AShooterHUD::ConditionalCloseScoreboard(bool bFocus)
@@ -1111,16 +1202,26 @@ bool AShooterHUD::ShowScoreboard(bool bEnable, bool bFocus)
 	bIsScoreBoardVisible = bEnable;
 	if (bIsScoreBoardVisible)
 	{
-		SAssignNew(ScoreboardWidgetOverlay,SOverlay)
-		+SOverlay::Slot()
-		.HAlign(EHorizontalAlignment::HAlign_Center)
-		.VAlign(EVerticalAlignment::VAlign_Center)
-		.Padding(FMargin(50))
-		[
-			SAssignNew(ScoreboardWidget, SShooterScoreboardWidget)
-				.PCOwner(MakeWeakObjectPtr(PlayerOwner))
-				.MatchState(GetMatchState())
-		];
+		QUICK_SCOPE_CYCLE_COUNTER(AShooterHUD_ShowScoreboard);
+
+		// the scoreboard is kept between opens, so its rows don't have to be created again
+		if (ScoreboardWidget.IsValid())
+		{
+			ScoreboardWidget->Reopen(GetMatchState());
+		}
+		else
+		{
+			SAssignNew(ScoreboardWidgetOverlay,SOverlay)
+			+SOverlay::Slot()
+			.HAlign(EHorizontalAlignment::HAlign_Center)
+			.VAlign(EVerticalAlignment::VAlign_Center)
+			.Padding(FMargin(50))
+			[
+				SAssignNew(ScoreboardWidget, SShooterScoreboardWidget)
+					.PCOwner(MakeWeakObjectPtr(PlayerOwner))
+					.MatchState(GetMatchState())
+			];
+		}
 
 		GEngine->GameViewport->AddViewportWidgetContent(
 			SAssignNew(ScoreboardWidgetContainer,SWeakWidget)
@@ -1189,6 +1290,20 @@ void AShooterHUD::AddChatLine(const FText& ChatString, bool bWantFocus)
 	}
 }
 
+void AShooterHUD::AddChatLines(TArrayView<const FText> ChatStrings, bool bWantFocus)
+{
+	if (ChatStrings.Num() == 0)
+	{
+		return;
+	}
+
+	TryCreateChatWidget();
+	if( ChatWidget.IsValid() == true )
+	{
+		ChatWidget->AddChatLines(ChatStrings, bWantFocus);
+	}
+}
+
 void AShooterHUD::MakeUV(FCanvasIcon& Icon, FVector2D& UV0, FVector2D& UV1, uint16 U, uint16 V, uint16 UL, uint16 VL)
 {
 	if (Icon.Texture)
@@ -1263,16 +1378,17 @@ float AShooterHUD::DrawRecentlyKilledPlayer()
 			TextItem.EnableShadow(FLinearColor::Black);
 			float SizeX, SizeY;
 			float TextScale = 0.71f;
-			FString Text = CenteredKillMessage.ToString();
+			CenteredKillText.Update(Canvas, BigFont, (int64)(LastKillTime * 1000.0f), [this]() { return CenteredKillMessage.ToString(); });
+			SizeX = CenteredKillText.Size.X;
+			SizeY = CenteredKillText.Size.Y;
 
 			const float Alpha = FMath::Min(1.0f, 1 - (CurrentTime - LastKillTime) / KillFadeOutTime);
 			TextItem.Font = BigFont;
-			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
 			Canvas->SetDrawColor(255, 255, 255, 255 * Alpha);
 			Canvas->DrawIcon(KilledIcon, Canvas->OrgX + Canvas->ClipX / 2 - (KilledIcon.UL * ScaleUI + SizeX * TextScale * ScaleUI) / 2.0f,
 				DrawPos - (Offset * 4 - SizeY / 2 * TextScale + KilledIcon.VL / 2) * ScaleUI, ScaleUI);
 			TextItem.SetColor(FColor(HUDLight.R, HUDLight.G, HUDLight.B, HUDLight.A*Alpha));
-			TextItem.Text = FText::FromString(Text);
+			TextItem.Text = CenteredKillText.Text;
 			TextItem.Scale = FVector2D(TextScale*ScaleUI, TextScale*ScaleUI);
 			LastYPos = (DrawPos - (Offset * 4 * ScaleUI)) + SizeY;
 			Canvas->DrawItem(TextItem, Canvas->OrgX + Canvas->ClipX / 2 - (KilledIcon.UL * ScaleUI + SizeX * TextScale * ScaleUI) / 2.0f + KilledIcon.UL * ScaleUI,
@@ -8,6 +8,7 @@
 #define CHAT_BOX_WIDTH 576.0f
 #define CHAT_BOX_HEIGHT 192.0f
 #define CHAT_BOX_PADDING 20.0f
+#define CHAT_MAX_HISTORY 100
 
 void SChatWidget::Construct(const FArguments& InArgs, const FLocalPlayerContext& InContext)
 {
@@ -111,13 +112,30 @@ FSlateColor SChatWidget::GetStyleColor( const FLinearColor& InColor ) const
 
 void SChatWidget::AddChatLine(const FText& ChatString, bool SetFocus)
 {
-	ChatHistory.Add(MakeShareable(new FChatLine(ChatString)));
+	AddChatLines(MakeArrayView(&ChatString, 1), SetFocus);
+}
+
+void SChatWidget::AddChatLines(TArrayView<const FText> ChatStrings, bool SetFocus)
+{
+	if (ChatStrings.Num() == 0)
+	{
+		return;
+	}
+
+	for (const FText& ChatString : ChatStrings)
+	{
+		ChatHistory.Add(MakeShareable(new FChatLine(ChatString)));
+	}
+
+	if (ChatHistory.Num() > CHAT_MAX_HISTORY)
+	{
+		ChatHistory.RemoveAt(0, ChatHistory.Num() - CHAT_MAX_HISTORY);
+	}
 
 	if(ChatHistoryListView.IsValid())
 	{
-		FChatLine* LastLine  = ChatHistory[ChatHistory.Num() - 1].Get();
-		UE_LOG(LogOnline, Warning, TEXT("request scroll last=%s"), *LastLine->ChatString.ToString());
-		ChatHistoryListView->RequestScrollIntoView(ChatHistory[ChatHistory.Num() - 1]);
+		ChatHistoryListView->RequestListRefresh();
+		ChatHistoryListView->RequestScrollIntoView(ChatHistory.Last());
 	}
 	
 	FSlateApplication::Get().PlaySound(ChatStyle->RxMessgeSound);
@@ -149,13 +167,23 @@ void SChatWidget::OnChatTextCommitted(const FText& InText, ETextCommit::Type InC
 	{
 		if (GetPlayerController().IsValid() && !InText.IsEmpty())
 		{
-			// broadcast chat to other players
-			GetPlayerController()->Say(InText.ToString());
+			// broadcast chat to other players, or to our team only when prefixed with /team
+			const FString TeamPrefix = TEXT("/team ");
+			const FString ChatString = InText.ToString();
+			const bool bTeamOnly = ChatString.StartsWith(TeamPrefix);
+			if (bTeamOnly)
+			{
+				GetPlayerController()->TeamSay(ChatString.Mid(TeamPrefix.Len()));
+			}
+			else
+			{
+				GetPlayerController()->Say(ChatString);
+			}
 
 			if(ChatEditBox.IsValid())
 			{
 				// Add the string so we see it too (we will ignore our own strings in the receive function)
-				AddChatLine( InText, true );
+				AddChatLine( bTeamOnly ? FText::Format(NSLOCTEXT("ShooterGame.HUD", "TeamChatLine", "(Team) {0}"), FText::FromString(ChatString.Mid(TeamPrefix.Len()))) : InText, true );
 
 				// Clear the text
 				ChatEditBox->SetText(FText());
@@ -47,6 +47,14 @@ public:
 	 */
 	void AddChatLine(const FText &ChatString, bool SetFocus);
 
+	/** 
+	 * Add chat lines received together, the oldest lines are dropped past the history limit.
+	 *
+	 * @param	ChatStrings		Strings to add.
+	 * @param	SetFocus		Should the window be given focus
+	 */
+	void AddChatLines(TArrayView<const FText> ChatStrings, bool SetFocus);
+
 	TSharedRef<class SWidget> AsWidget();
 
 protected:
@@ -112,7 +120,7 @@ protected:
 	/** The chat history list view. */
 	TSharedPtr< SListView< TSharedPtr< FChatLine> > > ChatHistoryListView;
 
-	/** The array of chat history. */
+	/** The array of chat history, rows are only generated for the visible lines. */
 	TArray< TSharedPtr< FChatLine> > ChatHistory;
 
 	/** Should this chatbox be kept visible. */
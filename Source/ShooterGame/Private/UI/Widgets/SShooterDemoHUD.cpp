@@ -3,6 +3,7 @@
 #include "ShooterGame.h"
 #include "SShooterDemoHUD.h"
 #include "Engine/DemoNetDriver.h"
+#include "Player/ShooterDemoSpectator.h"
 #include "ShooterStyle.h"
 #include "CoreStyle.h"
 
@@ -16,6 +17,7 @@ public:
 		, _IndicatorBrush( FCoreStyle::Get().GetDefaultBrush() )
 		{}
 	SLATE_ARGUMENT(TWeakObjectPtr<UDemoNetDriver>, DemoDriver)
+	SLATE_ARGUMENT(TWeakObjectPtr<AShooterDemoSpectator>, DemoSpectator)
 	SLATE_ATTRIBUTE( FMargin, BackgroundPadding )
 	SLATE_ATTRIBUTE( const FSlateBrush*, BackgroundBrush )
 	SLATE_ATTRIBUTE( const FSlateBrush*, IndicatorBrush )
@@ -33,6 +35,9 @@ private:
 	/** The demo net driver underlying the current replay */
 	TWeakObjectPtr<UDemoNetDriver> DemoDriver;
 
+	/** Spectator doing the seeks, if any */
+	TWeakObjectPtr<AShooterDemoSpectator> DemoSpectator;
+
 	/** The FName of the image resource to show */
 	TAttribute< const FSlateBrush* > BackgroundBrush;
 
@@ -43,6 +48,7 @@ private:
 void SShooterReplayTimeline::Construct(const FArguments& InArgs)
 {
 	DemoDriver = InArgs._DemoDriver;
+	DemoSpectator = InArgs._DemoSpectator;
 	BackgroundBrush = InArgs._BackgroundBrush;
 	IndicatorBrush = InArgs._IndicatorBrush;
 
@@ -114,7 +120,15 @@ FReply SShooterReplayTimeline::OnTimelineClicked(const FGeometry& Geometry, cons
 
 		const float TimelinePercentage = LocalPos.X / Geometry.GetLocalSize().X;
 
-		DemoDriver->GotoTimeInSeconds( TimelinePercentage * DemoDriver->GetDemoTotalTime() );
+		const float SeekTime = TimelinePercentage * DemoDriver->GetDemoTotalTime();
+		if (DemoSpectator.IsValid())
+		{
+			DemoSpectator->SeekTo( SeekTime );
+		}
+		else
+		{
+			DemoDriver->GotoTimeInSeconds( SeekTime );
+		}
 
 		return FReply::Handled();
 	}
@@ -155,6 +169,7 @@ void SShooterDemoHUD::Construct(const FArguments& InArgs)
 				[
 					SNew(SShooterReplayTimeline)
 					.DemoDriver(PlayerOwner->GetWorld()->GetDemoNetDriver())
+					.DemoSpectator(Cast<AShooterDemoSpectator>(PlayerOwner.Get()))
 					.BackgroundBrush(FShooterStyle::Get().GetBrush("ShooterGame.ReplayTimelineBorder"))
 					.BackgroundPadding(FMargin(0.0f, 3.0))
 					.IndicatorBrush(FShooterStyle::Get().GetBrush("ShooterGame.ReplayTimelineIndicator"))
@@ -203,6 +218,13 @@ void SShooterDemoHUD::Construct(const FArguments& InArgs)
 			]
 
 			+SVerticalBox::Slot()
+			.AutoHeight()
+			.HAlign(HAlign_Center)
+			[
+				SNew(STextBlock)
+				.Margin(3.0f)
+				.Text(this, &SShooterDemoHUD::GetLastSeekTime)
+			]
 		]
 	];
 }
@@ -248,6 +270,12 @@ FText SShooterDemoHUD::GetPlaybackSpeed() const
 		return FText::GetEmpty();
 	}
 
+	const AShooterDemoSpectator* DemoSpectator = Cast<AShooterDemoSpectator>(PlayerOwner.Get());
+	if (DemoSpectator && DemoSpectator->IsSeeking())
+	{
+		return NSLOCTEXT("ShooterGame.HUD.Menu", "Seeking", "SEEKING...");
+	}
+
 	if (PlayerOwner->GetWorldSettings()->GetPauserPlayerState() == nullptr)
 	{
 		FNumberFormattingOptions FormatOptions = FNumberFormattingOptions()
@@ -260,6 +288,20 @@ FText SShooterDemoHUD::GetPlaybackSpeed() const
 	return NSLOCTEXT("ShooterGame.HUD.Menu", "Paused", "PAUSED");
 }
 
+FText SShooterDemoHUD::GetLastSeekTime() const
+{
+	const AShooterDemoSpectator* DemoSpectator = Cast<AShooterDemoSpectator>(PlayerOwner.Get());
+	if (DemoSpectator == nullptr || DemoSpectator->GetLastSeekDuration() <= 0.0f)
+	{
+		return FText::GetEmpty();
+	}
+
+	FNumberFormattingOptions FormatOptions = FNumberFormattingOptions()
+		.SetMaximumFractionalDigits(0);
+
+	return FText::Format(NSLOCTEXT("ShooterGame.HUD.Menu", "LastSeekTime", "Last seek: {0} ms"), FText::AsNumber(DemoSpectator->GetLastSeekDuration() * 1000.0f, &FormatOptions));
+}
+
 ECheckBoxState SShooterDemoHUD::IsPauseChecked() const
 {
 	if (PlayerOwner.IsValid() && PlayerOwner->GetWorldSettings() != nullptr && PlayerOwner->GetWorldSettings()->GetPauserPlayerState() != nullptr)
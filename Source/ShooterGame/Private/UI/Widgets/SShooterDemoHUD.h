@@ -30,6 +30,7 @@ private:
 	FText GetCurrentReplayTime() const;
 	FText GetTotalReplayTime() const;
 	FText GetPlaybackSpeed() const;
+	FText GetLastSeekTime() const;
 
 	ECheckBoxState IsPauseChecked() const;
 	void OnPauseCheckStateChanged(ECheckBoxState CheckState) const;
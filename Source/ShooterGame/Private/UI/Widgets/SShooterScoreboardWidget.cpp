@@ -28,8 +28,6 @@ void SShooterScoreboardWidget::Construct(const FArguments& InArgs)
 	ScoreboardStartTime = FPlatformTime::Seconds();
 	MatchState = InArgs._MatchState.Get();
 
-	UpdatePlayerStateMaps();
-	
 	Columns.Add(FColumnData(LOCTEXT("KillsColumn", "Kills"),
 		ScoreboardStyle->KillStatColor,
 		FOnGetPlayerStateAttribute::CreateSP(this, &SShooterScoreboardWidget::GetAttributeValue_Kills)));
@@ -108,6 +106,7 @@ void SShooterScoreboardWidget::Construct(const FArguments& InArgs)
 		SAssignNew(ScoreboardData, SVerticalBox)
 	];
 	UpdateScoreboardGrid();
+	UpdatePlayerStateMaps();
 
 	SBorder::Construct(
 		SBorder::FArguments()
@@ -119,6 +118,27 @@ void SShooterScoreboardWidget::Construct(const FArguments& InArgs)
 	);
 }
 
+SShooterScoreboardWidget::~SShooterScoreboardWidget()
+{
+	BindToGameState(nullptr);
+}
+
+void SShooterScoreboardWidget::Reopen(EShooterMatchState::Type InMatchState)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(SShooterScoreboardWidget_Reopen);
+
+	ScoreboardStartTime = FPlatformTime::Seconds();
+	ResetSelectedPlayer();
+
+	if (MatchState != InMatchState)
+	{
+		MatchState = InMatchState;
+		UpdateScoreboardGrid();
+	}
+
+	UpdatePlayerStateMaps();
+}
+
 void SShooterScoreboardWidget::StoreTalkingPlayerData(const FUniqueNetId& PlayerId, bool bIsTalking)
 {
 	static TMap<FString, double> LastTimeSpoken;
@@ -202,15 +222,26 @@ FText SShooterScoreboardWidget::GetMatchOutcomeText() const
 void SShooterScoreboardWidget::UpdateScoreboardGrid()
 {
 	ScoreboardData->ClearChildren();
+
+	// team row containers are kept, UpdateTeam fills them with pooled rows
+	TeamRowBoxes.SetNum(PlayerStateMaps.Num());
+	TeamRowPool.SetNum(PlayerStateMaps.Num());
+	TeamRowCount.SetNum(PlayerStateMaps.Num());
+
 	for (uint8 TeamNum = 0; TeamNum < PlayerStateMaps.Num(); TeamNum++)
 	{
+		if (!TeamRowBoxes[TeamNum].IsValid())
+		{
+			SAssignNew(TeamRowBoxes[TeamNum], SVerticalBox);
+		}
+
 		//Player rows from each team
 		ScoreboardData->AddSlot() .AutoHeight()
 			[
-				MakePlayerRows(TeamNum)
+				TeamRowBoxes[TeamNum].ToSharedRef()
 			];
 		//If we have more than one team, we are playing team based game mode, add totals
-		if (PlayerStateMaps.Num() > 1 && PlayerStateMaps[TeamNum].Num() > 0)
+		if (PlayerStateMaps.Num() > 1)
 		{
 			// Horizontal Ruler
 			ScoreboardData->AddSlot() .AutoHeight() .Padding(NORM_PADDING)
@@ -218,10 +249,15 @@ void SShooterScoreboardWidget::UpdateScoreboardGrid()
 					SNew(SBorder)
 					.Padding(1)
 					.BorderImage(&ScoreboardStyle->ItemBorderBrush)
+					.Visibility(this, &SShooterScoreboardWidget::GetTotalsRowVisibility, TeamNum)
 				];
 			ScoreboardData->AddSlot() .AutoHeight()
 				[
-					MakeTotalsRow(TeamNum)
+					SNew(SBox)
+					.Visibility(this, &SShooterScoreboardWidget::GetTotalsRowVisibility, TeamNum)
+					[
+						MakeTotalsRow(TeamNum)
+					]
 				];
 		}
 	}
@@ -278,42 +314,94 @@ void SShooterScoreboardWidget::UpdateScoreboardGrid()
 
 void SShooterScoreboardWidget::UpdatePlayerStateMaps()
 {
-	if (PCOwner.IsValid())
+	AShooterGameState* const GameState = PCOwner.IsValid() ? PCOwner->GetWorld()->GetGameState<AShooterGameState>() : nullptr;
+	if (GameState != BoundGameState.Get())
 	{
-		AShooterGameState* const GameState = PCOwner->GetWorld()->GetGameState<AShooterGameState>();
-		if (GameState)
+		BindToGameState(GameState);
+	}
+
+	if (GameState)
+	{
+		const int32 NumTeams = FMath::Max(GameState->NumTeams, 1);
+		if (PlayerStateMaps.Num() != NumTeams)
 		{
-			bool bRequiresWidgetUpdate = false;
-			const int32 NumTeams = FMath::Max(GameState->NumTeams, 1);
-			LastTeamPlayerCount.Reset();
-			LastTeamPlayerCount.AddZeroed(PlayerStateMaps.Num());
-			for (int32 i = 0; i < PlayerStateMaps.Num(); i++)
-			{
-				LastTeamPlayerCount[i] = PlayerStateMaps[i].Num();
-			}
+			PlayerStateMaps.SetNum(NumTeams);
+			UpdateScoreboardGrid();
 
-			PlayerStateMaps.Reset();
-			PlayerStateMaps.AddZeroed(NumTeams);
-		
 			for (int32 i = 0; i < NumTeams; i++)
 			{
-				GameState->GetRankedMap(i, PlayerStateMaps[i]);
-
-				if (LastTeamPlayerCount.Num() > 0 && PlayerStateMaps[i].Num() != LastTeamPlayerCount[i])
-				{
-					bRequiresWidgetUpdate = true;
-				}
+				DirtyTeams.Add(i);
 			}
-			if (bRequiresWidgetUpdate)
+		}
+
+		// only teams we got a ranking change for since last tick
+		for (int32 TeamNum : DirtyTeams)
+		{
+			if (PlayerStateMaps.IsValidIndex(TeamNum))
 			{
-				UpdateScoreboardGrid();
+				UpdateTeam(TeamNum);
 			}
 		}
+		DirtyTeams.Reset();
 	}
 
 	UpdateSelectedPlayer();
 }
 
+void SShooterScoreboardWidget::UpdateTeam(uint8 TeamNum)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(SShooterScoreboardWidget_UpdateTeam);
+
+	BoundGameState->GetRankedMap(TeamNum, PlayerStateMaps[TeamNum]);
+
+	// rows only look up their player by rank when drawn, so reordering needs no widget changes, only the row count is patched
+	const int32 NumRows = PlayerStateMaps[TeamNum].Num();
+	TArray<TSharedRef<SWidget>>& Pool = TeamRowPool[TeamNum];
+	while (Pool.Num() < NumRows)
+	{
+		Pool.Add(MakePlayerRow(FTeamPlayer(TeamNum, Pool.Num())));
+	}
+
+	int32& NumShownRows = TeamRowCount[TeamNum];
+	for (; NumShownRows < NumRows; NumShownRows++)
+	{
+		TeamRowBoxes[TeamNum]->AddSlot().AutoHeight()
+			[
+				Pool[NumShownRows]
+			];
+	}
+	for (; NumShownRows > NumRows; NumShownRows--)
+	{
+		TeamRowBoxes[TeamNum]->RemoveSlot(Pool[NumShownRows - 1]);
+	}
+}
+
+void SShooterScoreboardWidget::BindToGameState(AShooterGameState* GameState)
+{
+	if (BoundGameState.IsValid())
+	{
+		BoundGameState->OnRankingChanged.Remove(RankingChangedHandle);
+	}
+	RankingChangedHandle.Reset();
+
+	BoundGameState = GameState;
+	if (GameState)
+	{
+		RankingChangedHandle = GameState->OnRankingChanged.AddSP(this, &SShooterScoreboardWidget::OnRankingChanged);
+	}
+
+	// rows of the previous GameState point at players that are gone
+	for (int32 TeamNum = 0; TeamNum < PlayerStateMaps.Num(); TeamNum++)
+	{
+		DirtyTeams.Add(TeamNum);
+	}
+}
+
+void SShooterScoreboardWidget::OnRankingChanged(int32 TeamNum)
+{
+	DirtyTeams.Add(TeamNum);
+}
+
 void SShooterScoreboardWidget::Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime )
 {
 	UpdatePlayerStateMaps();
@@ -588,6 +676,16 @@ EVisibility SShooterScoreboardWidget::PlayerPresenceToItemVisibility(const FTeam
 	return GetSortedPlayerState(TeamPlayer) ? EVisibility::Visible : EVisibility::Collapsed;
 }
 
+EVisibility SShooterScoreboardWidget::GetPlayerRowVisibility(const FTeamPlayer TeamPlayer) const
+{
+	return ShouldPlayerBeDisplayed(TeamPlayer) ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+EVisibility SShooterScoreboardWidget::GetTotalsRowVisibility(uint8 TeamNum) const
+{
+	return PlayerStateMaps.IsValidIndex(TeamNum) && PlayerStateMaps[TeamNum].Num() > 0 ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
 EVisibility SShooterScoreboardWidget::SpeakerIconVisibility(const FTeamPlayer TeamPlayer) const
 {
 	AShooterPlayerState* PlayerState = GetSortedPlayerState(TeamPlayer);
@@ -764,26 +862,6 @@ TSharedRef<SWidget> SShooterScoreboardWidget::MakeTotalsRow(uint8 TeamNum) const
 	return TotalsRow.ToSharedRef();
 }
 
-TSharedRef<SWidget> SShooterScoreboardWidget::MakePlayerRows(uint8 TeamNum) const
-{
-	TSharedRef<SVerticalBox> PlayerRows = SNew(SVerticalBox);
-
-	for (int32 PlayerIndex=0; PlayerIndex < PlayerStateMaps[TeamNum].Num(); PlayerIndex++ )
-	{
-		FTeamPlayer TeamPlayer(TeamNum, PlayerIndex);
-
-		if (ShouldPlayerBeDisplayed(TeamPlayer))
-		{
-			PlayerRows->AddSlot().AutoHeight()
-				[
-					MakePlayerRow(TeamPlayer)
-				];
-		}
-	}
-
-	return PlayerRows;
-}
-
 TSharedRef<SWidget> SShooterScoreboardWidget::MakePlayerRow(const FTeamPlayer& TeamPlayer) const
 {
 	// Make the padding here slightly smaller than NORM_PADDING, to fit in more players
@@ -792,6 +870,7 @@ TSharedRef<SWidget> SShooterScoreboardWidget::MakePlayerRow(const FTeamPlayer& T
 	TSharedPtr<SHorizontalBox> PlayerRow;
 	//Speaker Icon display
 	SAssignNew(PlayerRow, SHorizontalBox)
+	.Visibility(this, &SShooterScoreboardWidget::GetPlayerRowVisibility, TeamPlayer)
 	+ SHorizontalBox::Slot().Padding(Pad+FMargin(2,0,0,0)).AutoWidth()
 	[
 		SNew(SImage)
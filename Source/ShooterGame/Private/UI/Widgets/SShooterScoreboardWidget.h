@@ -88,7 +88,12 @@ class SShooterScoreboardWidget : public SBorder
 	/** needed for every widget */
 	void Construct(const FArguments& InArgs);
 
-	/** update PlayerState maps with every tick when scoreboard is shown */
+	virtual ~SShooterScoreboardWidget();
+
+	/** prepares the scoreboard to be shown again, keeping its row widgets */
+	void Reopen(EShooterMatchState::Type InMatchState);
+
+	/** applies ranking changes received since last tick when scoreboard is shown */
 	virtual void Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime ) override;
 
 	/** if we want to receive focus */
@@ -105,21 +110,27 @@ class SShooterScoreboardWidget : public SBorder
 
 protected:
 
-	/** updates widgets when players leave or join */
+	/** lays out team row containers, totals and match outcome, when the number of teams or the match state changes */
 	void UpdateScoreboardGrid();
 
 	/** makes total row widget */
 	TSharedRef<SWidget> MakeTotalsRow(uint8 TeamNum) const;
 
-	/** makes player rows */
-	TSharedRef<SWidget> MakePlayerRows(uint8 TeamNum) const;
-
 	/** makes player row */
 	TSharedRef<SWidget> MakePlayerRow(const FTeamPlayer& TeamPlayer) const;
 
-	/** updates PlayerState maps to display accurate scores */
+	/** updates PlayerState maps of teams whose ranking changed */
 	void UpdatePlayerStateMaps();
 
+	/** refreshes the PlayerState map of one team and adds or removes rows to match its player count */
+	void UpdateTeam(uint8 TeamNum);
+
+	/** listens to ranking changes of given GameState, everything is refreshed when it differs from the current one */
+	void BindToGameState(AShooterGameState* GameState);
+
+	/** ranking of a team changed, refreshed on next tick */
+	void OnRankingChanged(int32 TeamNum);
+
 	/** gets ranked map for specific team */
 	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;
 
@@ -129,6 +140,12 @@ protected:
 	/** get player visibility */
 	EVisibility PlayerPresenceToItemVisibility(const FTeamPlayer TeamPlayer) const;
 
+	/** get player row visibility, rows are collapsed for spectators */
+	EVisibility GetPlayerRowVisibility(const FTeamPlayer TeamPlayer) const;
+
+	/** get team totals visibility, only shown in team games for teams with players */
+	EVisibility GetTotalsRowVisibility(uint8 TeamNum) const;
+
 	/** get speaker icon visibility */
 	EVisibility SpeakerIconVisibility(const FTeamPlayer TeamPlayer) const;
 
@@ -219,11 +236,26 @@ protected:
 	/** the player currently selected in the scoreboard */
 	FTeamPlayer SelectedPlayer;
 
-	/** the Ranked PlayerState map...cleared every frame */
+	/** the Ranked PlayerState map...refreshed per team when the GameState ranking changes */
 	TArray<RankedPlayerMap> PlayerStateMaps;
 
-	/** player count in each team in the last tick */
-	TArray<int32> LastTeamPlayerCount;
+	/** GameState we receive ranking changes from */
+	TWeakObjectPtr<AShooterGameState> BoundGameState;
+
+	/** handle of our OnRankingChanged binding */
+	FDelegateHandle RankingChangedHandle;
+
+	/** teams whose ranking changed since last tick */
+	TSet<int32> DirtyTeams;
+
+	/** row container of each team */
+	TArray<TSharedPtr<SVerticalBox>> TeamRowBoxes;
+
+	/** row widgets of each team by rank, kept when players leave and between opens so they can be reused */
+	TArray<TArray<TSharedRef<SWidget>>> TeamRowPool;
+
+	/** number of pooled rows currently shown for each team */
+	TArray<int32> TeamRowCount;
 
 	/** holds talking player data */
 	TArray<TPair<TSharedRef<const FUniqueNetId>, bool>> PlayersTalkingThisFrame;
@@ -8,6 +8,8 @@
 #include "Online/ShooterPlayerState.h"
 #include "UI/ShooterHUD.h"
 #include "MatineeCameraShake.h"
+#include "Player/ShooterDemoSpectator.h"
+#include "Online/ShooterServerTelemetry.h"
 
 AShooterWeapon::AShooterWeapon(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -57,13 +59,17 @@ void AShooterWeapon::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
+	SetInitialAmmo();
+	DetachMeshFromPawn();
+}
+
+void AShooterWeapon::SetInitialAmmo()
+{
 	if (WeaponConfig.InitialClips > 0)
 	{
 		CurrentAmmoInClip = WeaponConfig.AmmoPerClip;
 		CurrentAmmo = WeaponConfig.AmmoPerClip * WeaponConfig.InitialClips;
 	}
-
-	DetachMeshFromPawn();
 }
 
 void AShooterWeapon::Destroyed()
@@ -180,6 +186,27 @@ void AShooterWeapon::OnLeaveInventory()
 	}
 }
 
+void AShooterWeapon::ResetForReuse()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	bWantsToFire = false;
+	bRefiring = false;
+	bPendingReload = false;
+	bPendingEquip = false;
+	bIsEquipped = false;
+	CurrentState = EWeaponState::Idle;
+	BurstCounter = 0;
+	LastFireTime = 0.0f;
+
+	CurrentAmmo = 0;
+	CurrentAmmoInClip = 0;
+	SetInitialAmmo();
+
+	StopSimulatingWeaponFire();
+	DetachMeshFromPawn();
+}
+
 void AShooterWeapon::AttachMeshToPawn()
 {
 	if (MyPawn)
@@ -751,6 +778,7 @@ FVector AShooterWeapon::GetMuzzleDirection() const
 
 FHitResult AShooterWeapon::WeaponTrace(const FVector& StartTrace, const FVector& EndTrace) const
 {
+	FShooterServerTimingScope TimingScope(EShooterServerTiming::WeaponTraces);
 
 	// Perform trace to retrieve hit info
 	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(WeaponTrace), true, GetInstigator());
@@ -819,7 +847,10 @@ void AShooterWeapon::SimulateWeaponFire()
 		return;
 	}
 
-	if (MuzzleFX)
+	// fast replay playback, only the animation is worth keeping
+	const bool bSkipCosmetics = AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld());
+
+	if (MuzzleFX && !bSkipCosmetics)
 	{
 		USkeletalMeshComponent* UseWeaponMesh = GetWeaponMesh();
 		if (!bLoopedMuzzleFX || MuzzlePSC == NULL)
@@ -856,12 +887,12 @@ void AShooterWeapon::SimulateWeaponFire()
 
 	if (bLoopedFireSound)
 	{
-		if (FireAC == NULL)
+		if (FireAC == NULL && !bSkipCosmetics)
 		{
 			FireAC = PlayWeaponSound(FireLoopSound);
 		}
 	}
-	else
+	else if (!bSkipCosmetics)
 	{
 		PlayWeaponSound(FireSound);
 	}
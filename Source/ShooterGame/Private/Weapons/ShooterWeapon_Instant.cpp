@@ -4,12 +4,22 @@
 #include "Weapons/ShooterWeapon_Instant.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterImpactEffect.h"
+#include "Effects/ShooterImpactEffectManager.h"
+#include "Player/ShooterDemoSpectator.h"
 
 AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	CurrentFiringSpread = 0.0f;
 }
 
+void AShooterWeapon_Instant::ResetForReuse()
+{
+	HitNotify = FInstantHitInfo();
+	CurrentFiringSpread = 0.0f;
+
+	Super::ResetForReuse();
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Weapon usage
 
@@ -267,6 +277,11 @@ void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32
 
 void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 {
+	if (AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
+	{
+		return;
+	}
+
 	if (ImpactTemplate && Impact.bBlockingHit)
 	{
 		FHitResult UseImpact = Impact;
@@ -281,6 +296,16 @@ void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 		}
 
 		FTransform const SpawnTransform(Impact.ImpactNormal.Rotation(), Impact.ImpactPoint);
+
+		// reuse pooled components instead of spawning an actor for every hit
+		AShooterGameState* const MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+		AShooterImpactEffectManager* const ImpactManager = (MyGameState && AShooterImpactEffectManager::IsPoolingEnabled()) ? MyGameState->GetImpactEffectManager() : nullptr;
+		if (ImpactManager)
+		{
+			ImpactManager->SpawnImpact(ImpactTemplate, UseImpact, SpawnTransform);
+			return;
+		}
+
 		AShooterImpactEffect* EffectActor = GetWorld()->SpawnActorDeferred<AShooterImpactEffect>(ImpactTemplate, SpawnTransform);
 		if (EffectActor)
 		{
@@ -292,7 +317,7 @@ void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 
 void AShooterWeapon_Instant::SpawnTrailEffect(const FVector& EndPoint)
 {
-	if (TrailFX)
+	if (TrailFX && !AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
 	{
 		const FVector Origin = GetMuzzleLocation();
 
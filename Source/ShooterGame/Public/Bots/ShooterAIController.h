@@ -6,6 +6,7 @@
 
 class UBehaviorTreeComponent;
 class UBlackboardComponent;
+class FShooterAIScheduler;
 
 UCLASS(config=Game)
 class AShooterAIController : public AAIController
@@ -67,9 +68,17 @@ protected:
 	/** Handle for efficient management of Respawn timer */
 	FTimerHandle TimerHandle_Respawn;
 
+	/** Scheduler deciding how often this bot updates, owned by the game mode */
+	TWeakPtr<FShooterAIScheduler> Scheduler;
+
+	/** time accumulated while control rotation updates were skipped */
+	float PendingRotationDeltaTime;
+
 public:
 	/** Returns BlackboardComp subobject **/
 	FORCEINLINE UBlackboardComponent* GetBlackboardComp() const { return BlackboardComp; }
 	/** Returns BehaviorComp subobject **/
 	FORCEINLINE UBehaviorTreeComponent* GetBehaviorComp() const { return BehaviorComp; }
+	/** Returns the update scheduler this bot is registered with, if any **/
+	FORCEINLINE TSharedPtr<FShooterAIScheduler> GetScheduler() const { return Scheduler.Pin(); }
 };
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Tickable.h"
+
+class AShooterAIController;
+
+/** how often a bot gets to think, based on how relevant it is to human players */
+namespace EShooterAIUpdateTier
+{
+	enum Type
+	{
+		Full,		// close to or in view of a human player: updated every frame
+		Reduced,	// mid range: behavior tree and aim updated at a lower rate
+		Minimal,	// far away and out of view: barely ticking
+		MAX,
+	};
+}
+
+/**
+ * Assigns every bot an update tier based on distance and visibility to human players and time-slices
+ * behavior tree ticks and aim updates across frames, so that bot thinking stays within a fixed per-frame budget.
+ * Owned by the game mode, only exists on the server.
+ */
+class SHOOTERGAME_API FShooterAIScheduler : public FTickableGameObject
+{
+public:
+	FShooterAIScheduler(UWorld* InWorld);
+
+	/** starts scheduling updates for this bot */
+	void RegisterBot(AShooterAIController* Bot);
+
+	/** stops scheduling updates for this bot */
+	void UnregisterBot(AShooterAIController* Bot);
+
+	/** returns true if the bot may run its behavior tree now, false to defer to a later frame */
+	bool RequestBehaviorTick(const AShooterAIController* Bot, float TimeSinceLastTick);
+
+	/** reports how long a granted behavior tree tick took, counted against this frame's budget */
+	void NotifyBehaviorTickCost(double Seconds);
+
+	/** returns true if the bot should update its control rotation now */
+	bool ShouldUpdateControlRotation(const AShooterAIController* Bot, float TimeSinceLastUpdate) const;
+
+	/** get the current update tier of a bot */
+	EShooterAIUpdateTier::Type GetUpdateTier(const AShooterAIController* Bot) const;
+
+	/** TickableObject Functions */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+protected:
+
+	struct FScheduledBot
+	{
+		TWeakObjectPtr<AShooterAIController> Controller;
+		EShooterAIUpdateTier::Type Tier = EShooterAIUpdateTier::Full;
+	};
+
+	/** recompute tiers of all bots from the current human view points */
+	void UpdateTiers();
+
+	/** pick a tier for a single bot */
+	EShooterAIUpdateTier::Type ComputeTier(const AShooterAIController* Bot, const TArray<FVector>& ViewLocations, const TArray<FVector>& ViewDirections) const;
+
+	/** minimum time between updates for given tier */
+	static float GetTierInterval(EShooterAIUpdateTier::Type Tier);
+
+	const FScheduledBot* FindBot(const AShooterAIController* Bot) const;
+
+	/** removes the bots matching given predicate and fixes up the indices of the others */
+	template<typename PredicateType>
+	void RemoveBots(const PredicateType& Predicate);
+
+	TWeakObjectPtr<UWorld> World;
+
+	TArray<FScheduledBot> Bots;
+
+	/** index in Bots of every registered controller, bots are looked up several times per bot per frame */
+	TMap<const AShooterAIController*, int32> BotIndices;
+
+	/** time spent in behavior tree ticks this frame */
+	double BudgetUsedSeconds;
+
+	/** time left until tiers are recomputed */
+	float TimeUntilTierUpdate;
+};
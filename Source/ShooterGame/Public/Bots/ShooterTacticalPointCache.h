@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Tickable.h"
+
+/** a reachable navmesh position with precomputed cover and sight information */
+struct FShooterTacticalPoint
+{
+	/** location on the navmesh */
+	FVector Location;
+
+	/** one bit per direction (see FShooterTacticalPointCache::NumDirections): low cover close by in that direction */
+	uint8 CoverMask;
+
+	/** one bit per direction: clear view from eye height in that direction */
+	uint8 SightMask;
+
+	FShooterTacticalPoint()
+		: Location(FVector::ZeroVector)
+		, CoverMask(0)
+		, SightMask(0)
+	{
+	}
+};
+
+/**
+ * Per map set of tactical points, sampled from the navmesh when the match loads and stored in a 2D spatial hash.
+ * Only points reachable from a player start are kept. Sampling and annotating run a few milliseconds per frame after
+ * the match loads, so they don't hold up the server getting ready.
+ * Lets bots pick a position near their enemy from memory instead of running a navmesh query every time they reposition.
+ * Owned by the game mode, only exists on the server.
+ */
+class SHOOTERGAME_API FShooterTacticalPointCache : public FTickableGameObject
+{
+public:
+	/** number of directions cover and sight are sampled in */
+	static const int32 NumDirections = 8;
+
+	FShooterTacticalPointCache();
+
+	/** starts sampling the navmesh of given world over the next frames, replacing any previous data */
+	void StartBuild(UWorld* InWorld);
+
+	/** true while the points are being sampled and annotated */
+	bool IsBuilding() const { return bBuilding; }
+
+	/** true once a build finished with at least one point, queries find nothing before */
+	bool IsBuilt() const { return !bBuilding && Points.Num() > 0; }
+
+	/** number of cached points */
+	int32 GetNumPoints() const { return Points.Num(); }
+
+	/**
+	 * Finds a cached point around SearchOrigin, preferring points with cover towards the enemy and a clear view of them.
+	 * Returns false if no point is cached in the search area.
+	 */
+	bool FindPointNearEnemy(const FVector& SearchOrigin, float SearchRadius, const FVector& EnemyLocation, FVector& OutLocation) const;
+
+	/** TickableObject Functions */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return bBuilding; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+protected:
+
+	/** samples one navmesh point, returns false once the navmesh has no more to give */
+	bool SamplePoint(class UNavigationSystemV1* NavSys);
+
+	/** can a player starting the match walk to given location? counts the path tests it runs */
+	bool IsReachable(class UNavigationSystemV1* NavSys, const FVector& Location);
+
+	void FinishBuild();
+
+	/** spatial hash cell containing given location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** is there an already cached point closer than MinDistance? */
+	bool HasPointWithin(const FVector& Location, float MinDistance) const;
+
+	/** direction index (0..NumDirections-1) of given vector in the XY plane */
+	static int32 GetDirectionIndex(const FVector& Direction);
+
+	/** traces around the point to fill in cover and sight masks */
+	void AnnotatePoint(UWorld* World, FShooterTacticalPoint& Point) const;
+
+	TArray<FShooterTacticalPoint> Points;
+
+	/** cell -> indices into Points */
+	TMap<FIntPoint, TArray<int32>> SpatialHash;
+
+	float CellSize;
+
+	TWeakObjectPtr<UWorld> World;
+
+	/** build progress */
+	bool bBuilding;
+	int32 NumSampleAttempts;
+	int32 NumAnnotated;
+	int32 NumUnreachable;
+	int32 NumBuildFrames;
+	double BuildStartTime;
+
+	/** path tests run by IsReachable this frame, capped while building over several frames */
+	int32 NumPathTestsThisFrame;
+
+	/** navmesh locations of the player starts, the points must be reachable from one of them */
+	TArray<FVector> StartLocations;
+};
@@ -97,9 +97,7 @@ class AShooterImpactEffect : public AActor
 	/** spawn effect */
 	virtual void PostInitializeComponents() override;
 
-protected:
-
-	/** get FX for material type */
+	/** get FX for material type, also used by AShooterImpactEffectManager on the class default object */
 	UParticleSystem* GetImpactFX(TEnumAsByte<EPhysicalSurface> SurfaceType) const;
 
 	/** get sound for material type */
@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterImpactEffectManager.generated.h"
+
+class AShooterImpactEffect;
+
+/** pooled components used for impacts on one surface type */
+USTRUCT()
+struct FShooterImpactSurfacePool
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> Emitters;
+
+	UPROPERTY(Transient)
+	TArray<UDecalComponent*> Decals;
+
+	/** world time each decal should disappear at, 0 if it stays until reused */
+	TArray<float> DecalExpireTimes;
+
+	/** next emitter to reuse once the budget is reached, always the one started the longest time ago */
+	int32 NextEmitter;
+
+	/** next decal to reuse once the budget is reached */
+	int32 NextDecal;
+
+	FShooterImpactSurfacePool()
+		: NextEmitter(0)
+		, NextDecal(0)
+	{
+	}
+};
+
+/**
+ * Plays weapon impact effects from a fixed budget of particle and decal components per surface type,
+ * instead of spawning an AShooterImpactEffect actor and new components for every hit.
+ * When a surface runs out of components the oldest effect is reused. Effects too far from local players
+ * or outside their view are skipped before anything is spawned.
+ * Client only, one per world, created by the GameState on first use.
+ */
+UCLASS(NotBlueprintable, Transient)
+class AShooterImpactEffectManager : public AActor
+{
+	GENERATED_UCLASS_BODY()
+
+	/** should impacts go through the manager? (ShooterImpact.Pooling) */
+	static bool IsPoolingEnabled();
+
+	/** plays the effects defined by ImpactTemplate for a hit */
+	void SpawnImpact(TSubclassOf<AShooterImpactEffect> ImpactTemplate, const FHitResult& SurfaceHit, const FTransform& SpawnTransform);
+
+	/** hides decals which reached their life span or whose actor is going away */
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+
+	/** is location close enough to a local player to bother, and in view if bRequireInView is set? */
+	bool IsRelevantToLocalPlayers(const FVector& Location, float CullDistance, bool bRequireInView) const;
+
+	/** next emitter of the pool, creating it while below budget */
+	UParticleSystemComponent* AcquireEmitter(FShooterImpactSurfacePool& Pool);
+
+	/** next decal of the pool, creating it while below budget, returns its index */
+	int32 AcquireDecal(FShooterImpactSurfacePool& Pool);
+
+	/** hides a decal and detaches it from what it was placed on, ready to be reused */
+	void ReleaseDecal(FShooterImpactSurfacePool& Pool, int32 DecalIndex);
+
+	/** pools indexed by EPhysicalSurface */
+	UPROPERTY(Transient)
+	TArray<FShooterImpactSurfacePool> SurfacePools;
+};
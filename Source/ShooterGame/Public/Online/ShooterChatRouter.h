@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Tickable.h"
+#include "ShooterTypes.h"
+
+/**
+ * Server side chat. Messages said by players are rate limited per sender with a token bucket, queued, and sent once
+ * per frame as a single batch RPC per recipient instead of one reliable RPC per message and recipient, so chat spam
+ * can't fill the reliable buffers. Team messages only go to players of the sender's team.
+ * Owned by the game mode, only exists on the server.
+ */
+class SHOOTERGAME_API FShooterChatRouter : public FTickableGameObject
+{
+public:
+	FShooterChatRouter(UWorld* InWorld);
+
+	/** queues a message said by a player, returns false if it was dropped by the rate limit */
+	bool SubmitMessage(APlayerController* Sender, const FString& Text, bool bTeamOnly);
+
+	/** forgets the rate limit state of a player leaving the game */
+	void RemovePlayer(APlayerController* Player);
+
+	/** TickableObject Functions */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+protected:
+
+	struct FSenderState
+	{
+		/** messages the player may still send right away */
+		float Tokens;
+
+		/** when tokens were last added */
+		double LastRefillTime;
+
+		/** messages dropped by the rate limit or ShooterChat.MaxQueued since the player was last told about it */
+		int32 NumRejected;
+	};
+
+	struct FQueuedMessage
+	{
+		FShooterChatMessage Message;
+		TWeakObjectPtr<APlayerController> Sender;
+
+		/** sender's team when the message was said, INDEX_NONE if team doesn't matter */
+		int32 TeamNum;
+	};
+
+	/** drops the oldest queued messages, their senders are told they weren't sent */
+	void DropQueuedMessages(int32 NumToDrop);
+
+	/** refills the sender's bucket and takes a token from it, returns false if it was empty */
+	bool ConsumeToken(APlayerController* Sender);
+
+	/** should this message be sent to given player? */
+	bool IsRecipient(const FQueuedMessage& Queued, const APlayerController* Recipient) const;
+
+	TWeakObjectPtr<UWorld> World;
+
+	TMap<TWeakObjectPtr<APlayerController>, FSenderState> Senders;
+
+	TArray<FQueuedMessage> QueuedMessages;
+
+	/** true if some sender has rejected messages to hear about */
+	bool bHasRejections;
+};
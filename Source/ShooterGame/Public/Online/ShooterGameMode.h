@@ -14,8 +14,15 @@
 #include "ShooterGameMode.generated.h"
 
 class AShooterAIController;
+class FShooterAIScheduler;
+class FShooterTacticalPointCache;
+class FShooterSpawnManager;
+class FShooterChatRouter;
+class FShooterGarbageCollectionPolicy;
+class AShooterTeamStart;
 class AShooterPlayerState;
 class AShooterPickup;
+class AShooterWeapon;
 class FUniqueNetId;
 
 UCLASS(config=Game)
@@ -92,6 +99,21 @@ class AShooterGameMode : public AGameMode
 	/** Create a bot */
 	AShooterAIController* CreateBot(int32 BotNum);	
 
+	/** Returns the scheduler that time-slices bot updates */
+	TSharedPtr<FShooterAIScheduler> GetBotScheduler() const { return BotScheduler; }
+
+	/** Returns the tactical points bots use to pick positions */
+	TSharedPtr<FShooterTacticalPointCache> GetTacticalPoints() const { return TacticalPoints; }
+
+	/** Returns the router batching and rate limiting chat */
+	TSharedPtr<FShooterChatRouter> GetChatRouter() const { return ChatRouter; }
+
+	/** [server] gets a weapon for a pawn's inventory, reusing one left by a dead pawn when possible */
+	AShooterWeapon* AcquireWeapon(TSubclassOf<AShooterWeapon> WeaponClass);
+
+	/** [server] takes back a weapon removed from a pawn's inventory, destroying it if the pool is full */
+	void ReleaseWeapon(AShooterWeapon* Weapon);
+
 	virtual void PostInitProperties() override;
 
 protected:
@@ -122,6 +144,25 @@ protected:
 	UPROPERTY()
 	TArray<AShooterAIController*> BotControllers;
 
+	/** weapons of dead pawns waiting to be handed to respawning ones, instead of spawning new weapon actors */
+	UPROPERTY(Transient)
+	TArray<AShooterWeapon*> PooledWeapons;
+
+	/** assigns bots an update tier based on proximity to human players and keeps their thinking within a frame budget */
+	TSharedPtr<FShooterAIScheduler> BotScheduler;
+
+	/** navmesh positions with cover and sight data, built when the match loads */
+	TSharedPtr<FShooterTacticalPointCache> TacticalPoints;
+
+	/** cached team starts and pawn index used to pick spawns */
+	TSharedPtr<FShooterSpawnManager> SpawnManager;
+
+	/** batches chat into one RPC per player and frame */
+	TSharedPtr<FShooterChatRouter> ChatRouter;
+
+	/** holds garbage collection back during fights, and requests it in quiet moments */
+	TSharedPtr<FShooterGarbageCollectionPolicy> GarbageCollectionPolicy;
+
 	UPROPERTY(config)
 	TSubclassOf<AShooterPlayerController> PlatformPlayerControllerClass;
 
@@ -153,6 +194,18 @@ protected:
 	/** check if player should use spawnpoint */
 	virtual bool IsSpawnpointPreferred(APlayerStart* SpawnPoint, AController* Player) const;
 
+	/** cached spawn points worth testing for player */
+	virtual const TArray<TWeakObjectPtr<AShooterTeamStart>>& GetSpawnCandidates(AController* Player) const;
+
+	/** team the player spawns for, or INDEX_NONE if everybody else is an enemy */
+	virtual int32 GetSpawnTeamNum(AController* Player) const;
+
+	/** default object of the pawn that will be spawned for player */
+	ACharacter* GetSpawnPawnDefaults(AController* Player) const;
+
+	/** pick best scoring spawn from the spawn manager and reserve it for this frame */
+	APlayerStart* ChooseSpawnFromIndex(AController* Player);
+
 	/** Returns game session class to use */
 	virtual TSubclassOf<AGameSession> GetGameSessionClass() const override;
 
@@ -217,6 +270,10 @@ public:
 	UFUNCTION(exec)
 	void FinishMatch();
 
+	/** times spawn selection for a mass respawn, comparing the spawn manager, including building it, with a full actor scan */
+	UFUNCTION(exec)
+	void BenchmarkSpawnSelection(int32 NumSpawns = 64);
+
 	/*Finishes the match and bumps everyone to main menu.*/
 	/*Only GameInstance should call this function */
 	void RequestFinishAndExitToMainMenu();
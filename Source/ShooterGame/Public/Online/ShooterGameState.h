@@ -8,6 +8,73 @@
 /** ranked PlayerState map, created from the GameState */
 typedef TMap<int32, TWeakObjectPtr<AShooterPlayerState> > RankedPlayerMap; 
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnShooterRankingChanged, int32 /* TeamNum */);
+
+/** entry of the per team ranking kept by the GameState */
+struct FShooterRankedPlayer
+{
+	TWeakObjectPtr<AShooterPlayerState> PlayerState;
+
+	/** team, score and id the player was ranked with */
+	int32 TeamNum;
+	int32 Score;
+	int32 PlayerId;
+
+	/** best score first, player id breaks ties so every entry has a unique position */
+	bool operator<(const FShooterRankedPlayer& Other) const
+	{
+		return Score != Other.Score ? Score > Other.Score : PlayerId < Other.PlayerId;
+	}
+};
+
+/** kill replicated to clients through the kill feed of the GameState */
+USTRUCT()
+struct FShooterKillFeedEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** increases with every kill, 0 for an empty slot */
+	UPROPERTY()
+	int32 Id;
+
+	/** null if the victim died on its own */
+	UPROPERTY()
+	AShooterPlayerState* Killer;
+
+	UPROPERTY()
+	AShooterPlayerState* Victim;
+
+	/** set when the kill had a killer, so clients know whether a null Killer is still on its way */
+	UPROPERTY()
+	uint8 bHasKiller : 1;
+
+	UPROPERTY()
+	TSubclassOf<UDamageType> DamageType;
+
+	/** server world time of the kill */
+	UPROPERTY()
+	float Time;
+
+	FShooterKillFeedEntry()
+		: Id(0)
+		, Killer(nullptr)
+		, Victim(nullptr)
+		, bHasKiller(false)
+		, Time(0.0f)
+	{
+	}
+};
+
+/** material instances of one base material, one per team */
+USTRUCT()
+struct FShooterTeamMaterials
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	TArray<UMaterialInstanceDynamic*> TeamMIDs;
+};
+
 UCLASS()
 class AShooterGameState : public AGameState
 {
@@ -34,6 +101,30 @@ public:
 	/** gets ranked PlayerState map for specific team */
 	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;	
 
+	/** players of specific team, best score first */
+	const TArray<FShooterRankedPlayer>& GetRankedPlayers(int32 TeamIndex) const;
+
+	/** rank of player within its team (0 is best), INDEX_NONE if not ranked */
+	int32 GetPlayerRank(const AShooterPlayerState* PlayerState) const;
+
+	/** broadcast when a player joined, left or changed score in a team */
+	FOnShooterRankingChanged OnRankingChanged;
+
+	/** moves player to its new position after its score or team changed */
+	void UpdatePlayerRanking(AShooterPlayerState* PlayerState);
+
+	/** [server] adds a kill to the kill feed, local players hear about it right away and remote ones once the feed replicates */
+	void AddKill(AShooterPlayerState* KillerPlayerState, AShooterPlayerState* VictimPlayerState, const UDamageType* DamageType);
+
+	/** gets the impact effect pool of this world, created on first use. Null on dedicated servers */
+	class AShooterImpactEffectManager* GetImpactEffectManager();
+
+	/** gets the instance of a pawn material colored for a team, shared by all pawns of that team and created on first use */
+	UMaterialInterface* GetTeamMaterial(UMaterialInterface* BaseMaterial, int32 TeamNum);
+
+	virtual void AddPlayerState(APlayerState* PlayerState) override;
+	virtual void RemovePlayerState(APlayerState* PlayerState) override;
+
 	void RequestFinishAndExitToMainMenu();
 
 	virtual void HandleMatchHasStarted() override;
@@ -47,4 +138,45 @@ protected:
 	bool bEnableGameFeedback;
 
 	FShooterOnlineGameMatches GameMatches;
+
+	/** removes player from the ranking, returns false if it wasn't ranked */
+	bool RemoveFromRanking(const AShooterPlayerState* PlayerState);
+
+	/** adds player to the ranking of its current team */
+	void AddToRanking(AShooterPlayerState* PlayerState);
+
+	/** per team players sorted by score, kept up to date as scores change instead of sorted on every query */
+	TArray<TArray<FShooterRankedPlayer>> RankedTeams;
+
+	/** ranked players, to find their entry without searching all teams */
+	TMap<const AShooterPlayerState*, FShooterRankedPlayer> RankedPlayers;
+
+	/**
+	 * Last kills, written as a ring buffer indexed by entry id. Replicated as a property instead of sending an RPC per
+	 * kill, so a burst of kills costs one update and lost packets only resend the latest state.
+	 */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_KillFeed)
+	TArray<FShooterKillFeedEntry> KillFeed;
+
+	/** [server] id of the next kill */
+	int32 NextKillId;
+
+	/** highest kill id local players were told about */
+	int32 LastProcessedKillId;
+
+	UFUNCTION()
+	void OnRep_KillFeed();
+
+	/** tells local players about kill feed entries they didn't hear about yet, oldest first */
+	void ProcessKillFeed();
+
+	/** processes the kill feed again once an entry waiting for its player states times out */
+	FTimerHandle TimerHandle_ProcessKillFeed;
+
+	UPROPERTY(Transient)
+	class AShooterImpactEffectManager* ImpactEffectManager;
+
+	/** team colored instances by base material, so respawns reuse them instead of creating new ones */
+	UPROPERTY(Transient)
+	TMap<UMaterialInterface*, FShooterTeamMaterials> TeamMaterials;
 };
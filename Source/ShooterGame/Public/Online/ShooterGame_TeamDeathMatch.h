@@ -41,6 +41,12 @@ protected:
 	/** check team constraints */
 	virtual bool IsSpawnpointAllowed(APlayerStart* SpawnPoint, AController* Player) const;
 
+	/** only the starts of the player's team */
+	virtual const TArray<TWeakObjectPtr<AShooterTeamStart>>& GetSpawnCandidates(AController* Player) const override;
+
+	/** players of other teams are enemies */
+	virtual int32 GetSpawnTeamNum(AController* Player) const override;
+
 	/** initialization for bot after spawning */
 	virtual void InitBot(AShooterAIController* AIC, int32 BotNum) override;	
 };
@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Tickable.h"
+#include "UObject/UObjectArray.h"
+
+/**
+ * Match aware garbage collection. While players fight, the engine's reachability analysis is held back, up to
+ * ShooterGC.MaxDeferSeconds since the last one, and it is requested instead in low activity windows: warmup, post
+ * match, and lulls without any damage dealt for ShooterGC.QuietSeconds, which covers most death cams.
+ * Also counts the UObjects created per class, so the classes churning the most objects show up in the log, and warns
+ * about collections over the ShooterGC.BudgetMs budget.
+ * Owned by the game mode.
+ */
+class SHOOTERGAME_API FShooterGarbageCollectionPolicy : public FTickableGameObject, public FUObjectArray::FUObjectCreateListener
+{
+public:
+	FShooterGarbageCollectionPolicy(UWorld* InWorld);
+	~FShooterGarbageCollectionPolicy();
+
+	/** damage was dealt, collections are held back for a while */
+	void NotifyCombat();
+
+	/** TickableObject Functions */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/** FUObjectCreateListener Functions */
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+
+protected:
+
+	/** true if collecting now wouldn't land in the middle of a fight */
+	bool IsQuiet(double Now) const;
+
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	/** logs the classes that created the most objects since the last report */
+	void ReportAllocations(double Now);
+
+	TWeakObjectPtr<UWorld> World;
+
+	double LastCombatTime;
+	double LastCollectTime;
+	double CollectStartTime;
+
+	/** a collection was requested and hasn't run yet */
+	bool bCollectRequested;
+
+	/** objects created on the game thread per class since the last report */
+	TMap<FName, int32> CreatedByClass;
+	int32 NumCreated;
+	double LastReportTime;
+
+	bool bListeningForCreates;
+
+	FDelegateHandle PreGarbageCollectDelegateHandle;
+	FDelegateHandle PostGarbageCollectDelegateHandle;
+};
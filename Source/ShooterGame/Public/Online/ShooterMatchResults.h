@@ -0,0 +1,165 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+
+class UShooterPersistentUser;
+struct FOnlineError;
+
+/** everything posted about one local player at the end of a match, captured once and never modified afterwards */
+struct FShooterMatchResult
+{
+	/** local player the result belongs to */
+	int32 ControllerId;
+	TSharedPtr<const FUniqueNetId> UserId;
+
+	FName SessionName;
+	FString MapName;
+
+	/** this match */
+	int32 Kills;
+	int32 Deaths;
+	int32 Score;
+	bool bIsWinner;
+
+	/** persistent user totals, this match included */
+	int32 TotalKills;
+	int32 TotalWins;
+	int32 TotalLosses;
+	int32 TotalBulletsFired;
+	int32 TotalRocketsFired;
+
+	/** values written to the all time leaderboard */
+	int32 LeaderboardKills;
+	int32 LeaderboardDeaths;
+	int32 LeaderboardMatchesPlayed;
+
+	FShooterMatchResult()
+		: ControllerId(INDEX_NONE)
+		, Kills(0)
+		, Deaths(0)
+		, Score(0)
+		, bIsWinner(false)
+		, TotalKills(0)
+		, TotalWins(0)
+		, TotalLosses(0)
+		, TotalBulletsFired(0)
+		, TotalRocketsFired(0)
+		, LeaderboardKills(0)
+		, LeaderboardDeaths(0)
+		, LeaderboardMatchesPlayed(0)
+	{
+	}
+};
+
+/** steps a match result goes through, in order */
+namespace EShooterMatchResultStage
+{
+	enum Type
+	{
+		Save,
+		Achievements,
+		Leaderboards,
+		Stats,
+		Events,
+		Done,
+	};
+}
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterMatchResultsPosted, int32 /* ControllerId */, bool /* bWasSuccessful */);
+
+/**
+ * Posts match results to the local save, achievements, leaderboards and stats after the match ended.
+ * Results are queued as immutable snapshots and handled one step per frame, waiting for each online request to
+ * complete before issuing the next one, so ending a match no longer does all of it in a single frame.
+ * Failed requests are retried with a growing delay. Owned by the game instance so posting survives map travel.
+ */
+class SHOOTERGAME_API FShooterMatchResultsPipeline : public TSharedFromThis<FShooterMatchResultsPipeline>
+{
+public:
+	FShooterMatchResultsPipeline(UGameInstance* InGameInstance);
+	~FShooterMatchResultsPipeline();
+
+	/** starts ticking, call once the pipeline is owned by a shared pointer */
+	void Initialize();
+
+	/** queues a result, PersistentUser is saved as the first step */
+	void Submit(const TSharedRef<const FShooterMatchResult>& Result, UShooterPersistentUser* PersistentUser);
+
+	/** true while results of given local player are still being posted */
+	bool IsPosting(int32 ControllerId) const;
+
+	/** broadcast once all steps of a result completed, bWasSuccessful is false if any of them gave up */
+	FOnShooterMatchResultsPosted OnResultsPosted;
+
+protected:
+
+	struct FPendingResult
+	{
+		TSharedRef<const FShooterMatchResult> Result;
+		TWeakObjectPtr<UShooterPersistentUser> PersistentUser;
+		EShooterMatchResultStage::Type Stage;
+		int32 Attempts;
+		bool bFailed;
+
+		/** leaderboards of several results are written together and share one flush */
+		bool bInLeaderboardBatch;
+		bool bLeaderboardsWritten;
+
+		FPendingResult(const TSharedRef<const FShooterMatchResult>& InResult, UShooterPersistentUser* InPersistentUser)
+			: Result(InResult)
+			, PersistentUser(InPersistentUser)
+			, Stage(EShooterMatchResultStage::Save)
+			, Attempts(0)
+			, bFailed(false)
+			, bInLeaderboardBatch(false)
+			, bLeaderboardsWritten(false)
+		{
+		}
+	};
+
+	bool Tick(float DeltaSeconds);
+
+	/** world used to find the online subsystem */
+	UWorld* GetWorld() const;
+
+	/** issues the current step of the front result, returns true if we now wait for an online request */
+	bool RunStage(FPendingResult& Pending);
+
+	bool WriteAchievements(const FShooterMatchResult& Result);
+	bool WriteLeaderboards();
+	bool WriteStats(const FShooterMatchResult& Result);
+	void SendProgressEvent(const FShooterMatchResult& Result) const;
+
+	/** completion of an online request, ignored unless InRequestId is the request in flight */
+	void OnAchievementsWritten(const FUniqueNetId& PlayerId, bool bWasSuccessful, int32 InRequestId);
+	void OnLeaderboardFlushComplete(FName SessionName, bool bWasSuccessful, int32 InRequestId);
+	void OnStatsUpdated(const FOnlineError& ResultState, int32 InRequestId);
+	void OnRequestComplete(bool bWasSuccessful);
+
+	/** stops listening for a leaderboard flush, a flush that completes later no longer affects the results */
+	void ClearLeaderboardFlushDelegate();
+
+	/** moves the front result to its next step */
+	void AdvanceStage(FPendingResult& Pending);
+
+	TWeakObjectPtr<UGameInstance> GameInstance;
+
+	TArray<FPendingResult> PendingResults;
+
+	/** true while waiting for an online request */
+	bool bRequestInFlight;
+
+	/** id of the latest request, changes with every attempt so callbacks of timed out attempts can be told apart */
+	int32 RequestId;
+
+	/** when the request in flight is considered lost */
+	double RequestTimeout;
+
+	/** earliest time the next step may run, used for retry delays */
+	double NextStageTime;
+
+	FDelegateHandle TickDelegateHandle;
+	FDelegateHandle LeaderboardFlushDelegateHandle;
+};
@@ -24,6 +24,9 @@ class AShooterPlayerState : public APlayerState
 	virtual void RegisterPlayerWithSession(bool bWasFromInvite) override;
 	virtual void UnregisterPlayerWithSession() override;
 
+	/** keep scoreboard ranking in sync on clients */
+	virtual void OnRep_Score() override;
+
 	// End APlayerState interface
 
 	/**
@@ -63,14 +66,6 @@ class AShooterPlayerState : public APlayerState
 	/** gets truncated player name to fit in death log and scoreboards */
 	FString GetShortPlayerName() const;
 
-	/** Sends kill (excluding self) to clients */
-	UFUNCTION(Reliable, Client)
-	void InformAboutKill(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState);
-
-	/** broadcast death to local clients */
-	UFUNCTION(Reliable, NetMulticast)
-	void BroadcastDeath(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState);
-
 	/** replicate team colors. Updated the players mesh colors appropriately */
 	UFUNCTION()
 	void OnRep_TeamColor();
@@ -121,4 +116,7 @@ protected:
 
 	/** helper for scoring points */
 	void ScorePoints(int32 Points);
+
+	/** tell the GameState our score or team changed */
+	void UpdateRanking();
 };
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+
+struct FNetworkReplayStreamInfo;
+struct FNetworkReplayVersion;
+
+/** what we remember about a local replay */
+struct FShooterReplayInfo
+{
+	/** name the replay streamer knows the replay by */
+	FString Name;
+	FString FriendlyName;
+
+	/** when recording started, UTC */
+	FDateTime Timestamp;
+
+	int64 SizeInBytes;
+	int32 LengthInMS;
+
+	/** map the match was played on, only known for replays we recorded ourselves */
+	FString MapName;
+
+	/** replay network version, 0 if it doesn't match the current version or isn't known yet */
+	uint32 NetworkVersion;
+
+	int32 NumViewers;
+	bool bIsLive;
+
+	FShooterReplayInfo()
+		: SizeInBytes(0)
+		, LengthInMS(0)
+		, NetworkVersion(0)
+		, NumViewers(0)
+		, bIsLive(false)
+	{
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FShooterReplayInfo& Info);
+};
+
+/**
+ * Index of local replays, kept in a small file next to them so the demo list can show them without enumerating
+ * the replay streamer first. Updated when replays are recorded or deleted, and reconciled with the streamer
+ * every time the demo list enumerates in the background. Owned by the game instance.
+ */
+class SHOOTERGAME_API FShooterReplayIndex
+{
+public:
+	FShooterReplayIndex();
+	~FShooterReplayIndex();
+
+	/** starts reading the index file in the background */
+	void Load();
+
+	/** all indexed replays, newest first. Waits for the index file if it is still being read. */
+	const TArray<FShooterReplayInfo>& GetReplays();
+
+	/** changes every time the indexed replays change */
+	uint32 GetRevision() const { return Revision; }
+
+	/** adds or updates a replay we just recorded */
+	void AddReplay(const FShooterReplayInfo& Info);
+
+	/** forgets a deleted replay */
+	void RemoveReplay(const FString& Name);
+
+	/**
+	 * Brings the index in line with the result of a replay streamer enumeration made with given version filter.
+	 * Returns true if anything changed.
+	 */
+	bool Reconcile(const FNetworkReplayVersion& EnumerateVersion, const TArray<FNetworkReplayStreamInfo>& FoundStreams);
+
+protected:
+
+	/** location of the index file */
+	static FString GetIndexFilename();
+
+	/** makes sure Replays holds the content of the index file */
+	void WaitForLoad();
+
+	/** sorts, bumps the revision and writes the index file in the background */
+	void OnReplaysChanged();
+
+	TArray<FShooterReplayInfo> Replays;
+
+	/** index file being read */
+	TFuture<TArray<FShooterReplayInfo>> PendingLoad;
+
+	/** index file being written */
+	TFuture<bool> PendingSave;
+
+	uint32 Revision;
+};
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+
+class INetworkReplayStreamer;
+struct FEnumerateStreamsResult;
+struct FDeleteFinishedStreamResult;
+
+/**
+ * Records every match played on a dedicated server, for review after the fact. Off unless ShooterServerReplay.Enabled
+ * is set, since recording costs game thread time and disk on every server.
+ * The replay is split into segments of ShooterServerReplay.SegmentLength seconds, each one a replay of its own that the
+ * local file streamer writes to disk while recording. Finished segments are added to the replay index, and the oldest
+ * ones are deleted once there are too many of them or they use too much disk space.
+ * Also reports the game thread time per frame with and without recording and the bytes written per segment, so the
+ * cost of recording can be compared against a server that doesn't record.
+ * Owned by the game instance of dedicated servers so recording survives map travel.
+ */
+class SHOOTERGAME_API FShooterServerReplayRecorder : public TSharedFromThis<FShooterServerReplayRecorder>
+{
+public:
+	FShooterServerReplayRecorder(UGameInstance* InGameInstance);
+	~FShooterServerReplayRecorder();
+
+	/** starts ticking, call once the recorder is owned by a shared pointer */
+	void Initialize();
+
+	/** starts recording the match of the current world, if ShooterServerReplay.Enabled is set */
+	void OnMatchStarted();
+
+	/** stops recording */
+	void OnMatchEnded();
+
+	/** true while a segment is being recorded */
+	bool IsRecording() const { return !CurrentSegmentName.IsEmpty(); }
+
+protected:
+
+	/** segment recorded but not yet seen by the streamer with its final size */
+	struct FFinishedSegment
+	{
+		FString Name;
+		float Duration;
+	};
+
+	bool Tick(float DeltaSeconds);
+
+	void StartSegment();
+	void StopSegment();
+
+	/** logs the game thread time since the last report, as sampled by the server telemetry */
+	void ReportFrameTime();
+
+	/** asks the streamer about our replays, to learn segment sizes and apply retention */
+	void UpdateSegments();
+	void OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result);
+	void OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result, FString DeletedName);
+
+	/** deletes the oldest segments past ShooterServerReplay.MaxSegments and ShooterServerReplay.MaxDiskMB */
+	void ApplyRetention();
+
+	TWeakObjectPtr<UGameInstance> GameInstance;
+
+	/** streamer used to enumerate and delete segments, recording itself goes through the demo net driver */
+	TSharedPtr<INetworkReplayStreamer> ReplayStreamer;
+
+	/** name of the segment being recorded, empty if none */
+	FString CurrentSegmentName;
+
+	/** when the match, and the segment being recorded, started */
+	FDateTime MatchStartTime;
+	double SegmentStartTime;
+	int32 SegmentNum;
+
+	TArray<FFinishedSegment> FinishedSegments;
+
+	/** segments we asked the streamer to delete */
+	TSet<FString> PendingDeletes;
+
+	bool bEnumeratingStreams;
+
+	/** telemetry frame totals at the last report */
+	uint64 ReportedFrameCount;
+	double ReportedFrameTimeSumMS;
+	double LastReportTime;
+
+	FDelegateHandle TickDelegateHandle;
+};
@@ -0,0 +1,179 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+
+/** server work timed separately by the telemetry */
+enum class EShooterServerTiming : uint8
+{
+	Replication,
+	AI,
+	WeaponTraces,
+	PayloadHttp,
+	/** reported by the game mode's garbage collection policy, which times every collection during a match */
+	GarbageCollection,
+	Num
+};
+
+/**
+ * Always on server frame time telemetry, for watching fleets of dedicated servers without a profiler attached.
+ * Keeps a histogram of the game thread time per frame, the time spent in the subsystems of EShooterServerTiming, the
+ * number of connections, their lag, the corrections of client moves, the bandwidth of the net driver and how long the
+ * server took to boot. Every ShooterTelemetry.ExportInterval seconds they are written in the Prometheus text format to
+ * Saved/Telemetry, for a node exporter textfile collector to pick up, and the last interval is summarized for the
+ * session status sent to the session manager.
+ * Recording a frame or a timing is a few additions, so it stays on in shipping builds unlike stats.
+ * Owned by the game instance of dedicated servers.
+ */
+class SHOOTERGAME_API FShooterServerTelemetry : public TSharedFromThis<FShooterServerTelemetry>
+{
+public:
+	FShooterServerTelemetry(UGameInstance* InGameInstance);
+	~FShooterServerTelemetry();
+
+	/** starts recording, call once the telemetry is owned by a shared pointer */
+	void Initialize();
+
+	/** true if some telemetry records timings, they are skipped otherwise */
+	static bool IsEnabled() { return bEnabled; }
+
+	/** adds time spent in a subsystem this frame, game thread only */
+	static void AddTime(EShooterServerTiming Timing, double Seconds);
+
+	/** a client's move was corrected, game thread only */
+	static void AddClientCorrection();
+
+	/** marks a subsystem as being timed, returns false if it already was so nested timings aren't counted twice */
+	static bool StartTiming(EShooterServerTiming Timing);
+	static void StopTiming(EShooterServerTiming Timing, double Seconds);
+
+	/** the server preloaded its gameplay assets, in seconds since it was started */
+	void SetPreloadTime(double SecondsSinceStart);
+
+	/** the first match is waiting to start, records how long the server took to get ready for players */
+	void NotifyReady();
+
+	/** seconds from the server starting to being ready for players, 0 until it is */
+	float GetReadySeconds() const { return ReadySeconds; }
+
+	/** adds the last interval to the session status */
+	void AddSessionStatus(TMap<FString, FString>& Body) const;
+
+	/** frames of our world sampled since the start and their summed game thread time, diff two calls for an interval */
+	void GetFrameTimeTotals(uint64& OutFrameCount, double& OutFrameTimeSumMS) const
+	{
+		OutFrameCount = TotalFrameTimes.Count;
+		OutFrameTimeSumMS = TotalFrameTimes.SumMS;
+	}
+
+protected:
+
+	/** upper bounds of the frame time histogram buckets, in milliseconds, the last bucket takes everything above */
+	static const float FrameTimeBucketsMS[];
+	static const int32 NumFrameTimeBuckets;
+
+	struct FFrameTimeHistogram
+	{
+		TArray<uint64> BucketCounts;
+		double SumMS;
+		float MaxMS;
+		uint64 Count;
+
+		FFrameTimeHistogram();
+		void Add(float FrameTimeMS);
+		void Reset();
+
+		/** upper bound of the bucket holding given percentile, 0..1 */
+		float GetPercentileMS(float Percentile) const;
+	};
+
+	bool Tick(float DeltaSeconds);
+
+	/** game thread time of the frames of our world, from the start of the world tick to the end of the frame */
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnEndFrame();
+
+	/** samples the net driver and writes the metrics file */
+	void Export();
+
+	/** metrics in the Prometheus text format */
+	FString BuildMetrics() const;
+
+	static FString GetMetricsFilename();
+
+	TWeakObjectPtr<UGameInstance> GameInstance;
+
+	/** since the server started, exported as Prometheus counters */
+	FFrameTimeHistogram TotalFrameTimes;
+	double TotalTimingSeconds[(int32)EShooterServerTiming::Num];
+
+	/** since the last export, summarized in the session status */
+	FFrameTimeHistogram IntervalFrameTimes;
+	double IntervalTimingSeconds[(int32)EShooterServerTiming::Num];
+	double IntervalStartTime;
+	float LastIntervalSeconds;
+
+	/** summary of the last finished interval */
+	FFrameTimeHistogram LastIntervalFrameTimes;
+	double LastIntervalTimingSeconds[(int32)EShooterServerTiming::Num];
+
+	/** net driver, sampled on export */
+	int32 NumConnections;
+	int32 InBytesPerSecond;
+	int32 OutBytesPerSecond;
+	float AverageLagMS;
+	float MaxLagMS;
+
+	/** corrections of client moves since the server started, and during the last interval */
+	uint64 TotalClientCorrections;
+	int32 LastIntervalClientCorrections;
+
+	double FrameStartTime;
+
+	/** boot, in seconds since the server started, 0 until done */
+	float PreloadSeconds;
+	float ReadySeconds;
+
+	/** metrics file being written in the background */
+	TFuture<bool> PendingWrite;
+
+	FDelegateHandle TickDelegateHandle;
+	FDelegateHandle WorldTickStartDelegateHandle;
+	FDelegateHandle EndFrameDelegateHandle;
+
+	/** set while a telemetry exists, timings added without one are skipped */
+	static bool bEnabled;
+
+	/** timings added this frame, moved to the totals at the end of the frame */
+	static double FrameTimingSeconds[(int32)EShooterServerTiming::Num];
+
+	/** corrections sent since the last export */
+	static int32 IntervalClientCorrections;
+
+	/** subsystems inside a timing scope */
+	static bool ActiveTimings[(int32)EShooterServerTiming::Num];
+};
+
+/** adds the time spent in its scope to a subsystem of the server telemetry */
+struct FShooterServerTimingScope
+{
+	FShooterServerTimingScope(EShooterServerTiming InTiming)
+		: Timing(InTiming)
+		, StartTime(FShooterServerTelemetry::StartTiming(InTiming) ? FPlatformTime::Seconds() : 0.0)
+	{
+	}
+
+	~FShooterServerTimingScope()
+	{
+		if (StartTime > 0.0)
+		{
+			FShooterServerTelemetry::StopTiming(Timing, FPlatformTime::Seconds() - StartTime);
+		}
+	}
+
+private:
+	EShooterServerTiming Timing;
+	double StartTime;
+};
@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AShooterTeamStart;
+
+/**
+ * Spawn point selection helper for the game mode.
+ * Team starts are collected once when the map loads, split by team and by bot/player eligibility. Plain player starts
+ * are kept as well, for maps without team starts. Starts are held weakly, streamed levels can take theirs away.
+ * Characters are indexed in a coarse 2D grid once per frame, so scoring a spawn only looks at pawns close to it
+ * instead of every character in the world.
+ */
+class SHOOTERGAME_API FShooterSpawnManager
+{
+public:
+	FShooterSpawnManager();
+
+	/** collects all team starts of the world, replacing any previous data */
+	void Initialize(UWorld* World);
+
+	/** true once Initialize ran */
+	bool IsInitialized() const { return bInitialized; }
+
+	/** "Play from Here" start found while in PIE mode, always preferred */
+	APlayerStart* GetPIEStart() const { return PIEStart.Get(); }
+
+	/** all starts usable by bots or by players */
+	const TArray<TWeakObjectPtr<AShooterTeamStart>>& GetStarts(bool bForBots) const;
+
+	/** starts of a single team usable by bots or by players */
+	const TArray<TWeakObjectPtr<AShooterTeamStart>>& GetTeamStarts(bool bForBots, int32 TeamNum) const;
+
+	/** true if the map has any team start */
+	bool HasTeamStarts() const { return bHasTeamStarts; }
+
+	/** player starts that aren't team starts */
+	const TArray<TWeakObjectPtr<APlayerStart>>& GetPlainStarts() const { return PlainStarts; }
+
+	/** makes sure the pawn index reflects the current frame */
+	void UpdatePawnIndex(UWorld* World);
+
+	/** forces the pawn index to be rebuilt on next use, dropping reservations */
+	void InvalidatePawnIndex() { PawnIndexFrame = 0; }
+
+	/** marks a spawn as occupied until the index is rebuilt next frame, so several spawns in one frame don't pick the same start */
+	void ReserveSpawn(const FVector& Location, float CapsuleRadius, float CapsuleHalfHeight);
+
+	/** true if a pawn of given size at this location would overlap an indexed pawn */
+	bool IsOccupied(const FVector& Location, float CapsuleRadius, float CapsuleHalfHeight) const;
+
+	/**
+	 * Rates a spawn for given player, 0 (enemy right there and looking at it) to 1 (no enemy around).
+	 * TeamNum is the player's team, or INDEX_NONE if everybody else is an enemy.
+	 */
+	float ScoreSpawn(UWorld* World, const FVector& Location, const AController* Player, int32 TeamNum) const;
+
+protected:
+
+	struct FIndexedPawn
+	{
+		FVector Location;
+		float CapsuleRadius;
+		float CapsuleHalfHeight;
+		int32 TeamNum;
+		bool bAlive;
+
+		/** only used to recognize the player's own pawn and to ignore the pawn in sight traces, valid for the frame the index was built */
+		const AController* Controller;
+		const AActor* Actor;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	void AddPawn(const FIndexedPawn& Pawn);
+
+	TArray<TWeakObjectPtr<AShooterTeamStart>> BotStarts;
+	TArray<TWeakObjectPtr<AShooterTeamStart>> PlayerStarts;
+	TMap<int32, TArray<TWeakObjectPtr<AShooterTeamStart>>> BotTeamStarts;
+	TMap<int32, TArray<TWeakObjectPtr<AShooterTeamStart>>> PlayerTeamStarts;
+	TArray<TWeakObjectPtr<APlayerStart>> PlainStarts;
+	bool bHasTeamStarts;
+
+	TWeakObjectPtr<APlayerStart> PIEStart;
+
+	/** cell -> pawns located in it */
+	TMap<FIntPoint, TArray<FIndexedPawn>> PawnGrid;
+
+	/** frame the pawn index was built on */
+	uint64 PawnIndexFrame;
+
+	float CellSize;
+
+	bool bInitialized;
+};
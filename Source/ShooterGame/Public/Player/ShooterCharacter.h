@@ -18,8 +18,14 @@ class AShooterCharacter : public ACharacter
 	/** spawn inventory, setup initial variables */
 	virtual void PostInitializeComponents() override;
 
-	/** Update the character. (Running, health etc). */
-	virtual void Tick(float DeltaSeconds) override;
+	/** turn off the actor tick unless a blueprint needs it, per frame work goes through FShooterCharacterUpdater */
+	virtual void BeginPlay() override;
+
+	/** asks FShooterCharacterUpdater for per frame updates, while running, regenerating health etc. */
+	void RequestFrameUpdates();
+
+	/** per frame update of the states that need one (running, health regen), returns false once none of them is active */
+	bool UpdateFrameState(float DeltaSeconds);
 
 	/** cleanup inventory */
 	virtual void Destroyed() override;
@@ -250,6 +256,13 @@ class AShooterCharacter : public ACharacter
 	UFUNCTION(BlueprintCallable, Category = Pawn)
 	bool IsRunning() const;
 
+	/** get raw running input, the way it is sent with moves */
+	bool WantsToRun() const { return bWantsToRun; }
+	bool IsRunToggled() const { return bWantsToRunToggled; }
+
+	/** [local] puts back the running and targeting input of a move being replayed, without the side effects of the setters */
+	void SetMoveInput(bool bInWantsToRun, bool bInRunToggled, bool bInIsTargeting);
+
 	/** get camera view type */
 	UFUNCTION(BlueprintCallable, Category = Mesh)
 	virtual bool IsFirstPerson() const;
@@ -271,7 +284,7 @@ class AShooterCharacter : public ACharacter
 	USkeletalMeshComponent* GetSpecifcPawnMesh(bool WantFirstPerson) const;
 
 	/** Update the team color of all player meshes. */
-	void UpdateTeamColorsAllMIDs();
+	void UpdateTeamColors();
 private:
 
 	/** pawn mesh: 1st person view */
@@ -315,7 +328,7 @@ protected:
 	float RunningSpeedModifier;
 
 	/** current running state */
-	UPROPERTY(Transient, Replicated)
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_WantsToRun)
 	uint8 bWantsToRun : 1;
 
 	/** from gamepad running is toggled */
@@ -333,9 +346,12 @@ protected:
 	/** Base lookup rate, in deg/sec. Other scaling may affect final lookup rate. */
 	float BaseLookUpRate;
 
-	/** material instances for setting team color in mesh (3rd person view) */
+	/** materials of the meshes before team colors were applied, to look up the shared team instances of the GameState */
 	UPROPERTY(Transient)
-	TArray<UMaterialInstanceDynamic*> MeshMIDs;
+	TArray<UMaterialInterface*> MeshBaseMaterials;
+
+	UPROPERTY(Transient)
+	UMaterialInterface* Mesh1PBaseMaterial;
 
 	/** animation played on death */
 	UPROPERTY(EditDefaultsOnly, Category = Animation)
@@ -380,12 +396,12 @@ protected:
 	/** handles sounds for running */
 	void UpdateRunSounds();
 
+	/** starts, stops and sets the volume of the low health warning after health changed */
+	void UpdateLowHealthSound();
+
 	/** handle mesh visibility and updates */
 	void UpdatePawnMeshes();
 
-	/** handle mesh colors on specified material instance */
-	void UpdateTeamColors(UMaterialInstanceDynamic* UseMID);
-
 	/** Responsible for cleaning up bodies on clients. */
 	virtual void TornOff();
 
@@ -404,7 +420,7 @@ public:
 	uint32 bIsDying : 1;
 
 	// Current health of the Pawn
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = Health)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_Health, Category = Health)
 	float Health;
 
 	/** Take damage, handle death */
@@ -451,6 +467,14 @@ protected:
 	UFUNCTION()
 	void OnRep_LastTakeHitInfo();
 
+	/** low health warning follows health */
+	UFUNCTION()
+	void OnRep_Health();
+
+	/** run sounds of simulated pawns follow running */
+	UFUNCTION()
+	void OnRep_WantsToRun();
+
 	//////////////////////////////////////////////////////////////////////////
 	// Inventory
 
@@ -471,14 +495,6 @@ protected:
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerEquipWeapon(class AShooterWeapon* NewWeapon);
 
-	/** update targeting state */
-	UFUNCTION(reliable, server, WithValidation)
-	void ServerSetTargeting(bool bNewTargeting);
-
-	/** update targeting state */
-	UFUNCTION(reliable, server, WithValidation)
-	void ServerSetRunning(bool bNewRunning, bool bToggle);
-
 	/** Builds list of points to check for pausing replication for a connection*/
 	void BuildPauseReplicationCheckPoints(TArray<FVector>& RelevancyCheckPoints);
 
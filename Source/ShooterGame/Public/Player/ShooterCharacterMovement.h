@@ -13,5 +13,70 @@ class UShooterCharacterMovement : public UCharacterMovementComponent
 	GENERATED_UCLASS_BODY()
 
 	virtual float GetMaxSpeed() const override;
+
+	/** [server] applies running and targeting state sent with the client's move */
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	/** [simulated] stretches smoothing over the interval between updates, which the server varies per pawn */
+	virtual void SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation) override;
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	/** [server] counts the corrections sent to the owning client */
+	virtual void SendClientAdjustment() override;
+
+	/** [local] corrections received since this component was created */
+	int32 GetNumCorrectionsReceived() const { return NumCorrectionsReceived; }
+
+protected:
+
+	/** [local] replayed moves change running and targeting to theirs, the current input is put back afterwards */
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+
+	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
+	/** [local] logs corrections and upstream bandwidth since the last report */
+	void ReportNetStats();
+
+	/** corrections received since the last report, and in total */
+	int32 NumCorrections;
+	int32 NumCorrectionsReceived;
+
+	/** when the last report was made */
+	float LastNetStatsReportTime;
+
+	/** when the last movement update of a simulated proxy arrived, and the smoothed interval between them */
+	float LastSimulatedUpdateTime;
+	float SimulatedUpdateInterval;
 };
 
+/** client move of a shooter character, running and targeting travel in the compressed flags */
+class FSavedMove_Shooter : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+
+	/** running and targeting change the max speed, so a replayed move needs them as they were when it was made */
+	virtual void PrepMoveFor(ACharacter* C) override;
+
+	uint8 bSavedWantsToRun : 1;
+	uint8 bSavedRunToggled : 1;
+	uint8 bSavedIsTargeting : 1;
+};
+
+class FNetworkPredictionData_Client_Shooter : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Shooter(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
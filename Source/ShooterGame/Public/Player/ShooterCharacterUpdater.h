@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Tickable.h"
+
+class AShooterCharacter;
+
+/**
+ * Does the per frame work of shooter characters, like run toggling, run sounds and health regeneration, for only the
+ * characters that currently need it. Characters ask for updates when such a state starts and are dropped once it ends,
+ * so their own actor tick can stay disabled and idle characters cost nothing per frame.
+ * Owned by the game instance, characters of every world go through it.
+ */
+class SHOOTERGAME_API FShooterCharacterUpdater : public FTickableGameObject
+{
+public:
+	/** updates the character every frame from now on, until it says it doesn't need it anymore */
+	void RequestUpdates(AShooterCharacter* Character);
+
+	/** TickableObject Functions */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return Characters.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	TArray<TWeakObjectPtr<AShooterCharacter>> Characters;
+};
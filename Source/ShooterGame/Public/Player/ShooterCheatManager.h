@@ -29,4 +29,8 @@ class UShooterCheatManager : public UCheatManager
 
 	UFUNCTION(exec)
 	void SpawnBot();
+
+	/** compares queueing locally controlled updates onto the audio thread with the shared actor table */
+	UFUNCTION(exec)
+	void BenchmarkLocallyControlledActors(int32 NumUpdates = 10000);
 };
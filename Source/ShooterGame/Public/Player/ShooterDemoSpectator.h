@@ -23,9 +23,45 @@ public:
 	void OnIncreasePlaybackSpeed();
 	void OnDecreasePlaybackSpeed();
 
+	/**
+	 * Jumps the replay to given time. The demo driver loads the closest checkpoint before it and fast-forwards from there,
+	 * with world rendering and cosmetic effects suppressed. Seeks requested while one is running are merged into one.
+	 */
+	void SeekTo(float TimeInSeconds);
+
+	/** true while a seek is running */
+	bool IsSeeking() const { return bSeeking; }
+
+	/** how long the last seek took, 0 if there was none yet */
+	float GetLastSeekDuration() const { return LastSeekDuration; }
+
+	/**
+	 * Should impact effects, sounds and the HUD be skipped in this world?
+	 * True while a replay fast-forwards, or plays faster than ShooterReplay.CosmeticSpeedLimit.
+	 */
+	static bool ShouldSkipCosmetics(const UWorld* World);
+
 	int32 PlaybackSpeed;
 
 private:
+	void OnSeekComplete(bool bWasSuccessful);
+
+	/** turns world rendering of our viewport on or off */
+	void SetWorldRenderingSuppressed(bool bSuppressed);
+
 	TSharedPtr<SShooterDemoHUD> DemoHUD;
+
+	/** time to go to once the running seek completed, negative if none */
+	float PendingSeekTime;
+
+	/** when the running seek was requested */
+	double SeekStartTime;
+
+	float LastSeekDuration;
+
+	bool bSeeking;
+
+	/** true if we turned world rendering off */
+	bool bWorldRenderingSuppressed;
 };
 
@@ -21,6 +21,16 @@ public:
 	/** Initializes the PersistentUser */
 	void LoadPersistentUser();
 
+	/** Starts reading the save of this player in the background, ahead of LoadPersistentUser */
+	void PrefetchPersistentUser();
+
+	/** Writes pending changes of the PersistentUser, waiting for the write to complete */
+	void FlushPersistentUser();
+
+protected:
+	/** Name and user index the PersistentUser of this player is saved under */
+	void GetPersistentUserSlot(FString& OutSlotName, int32& OutUserIndex) const;
+
 private:
 	/** Persistent user data stored between sessions (i.e. the user's savegame) */
 	UPROPERTY()
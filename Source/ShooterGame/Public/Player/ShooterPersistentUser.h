@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #pragma once
+#include "Async/Future.h"
 #include "ShooterPersistentUser.generated.h"
 
 UCLASS()
@@ -12,9 +13,18 @@ public:
 	/** Loads user persistence data if it exists, creates an empty record otherwise. */
 	static UShooterPersistentUser* LoadPersistentUser(FString SlotName, const int32 UserIndex);
 
-	/** Saves data if anything has changed. */
+	/** Starts reading the save data of given slot in the background, so a later LoadPersistentUser of it doesn't wait on the disk. */
+	static void PrefetchPersistentUser(const FString& SlotName, const int32 UserIndex);
+
+	/** Drops save data read ahead for slots that were never loaded. */
+	static void ClearPrefetchedSaves();
+
+	/** Saves data if anything has changed. The write happens in the background, shortly after the last change. */
 	void SaveIfDirty();
 
+	/** Writes a pending save right away and waits for writes in progress, used before this user goes away. */
+	void FlushPendingSave();
+
 	/** Records the result of a match. */
 	void AddMatchResult(int32 MatchKills, int32 MatchDeaths, int32 MatchBulletsFired, int32 MatchRocketsFired, bool bIsMatchWinner);
 
@@ -122,9 +132,15 @@ protected:
 	/** Checks if the Inverted Mouse user setting is different from current */
 	bool IsInvertedYAxisDirty() const;
 
-	/** Triggers a save of this data. */
+	/** Triggers a save of this data, saves requested in quick succession are merged into one write. */
 	void SavePersistentUser();
 
+	/** Serializes this user and hands the data to a background write. */
+	void WriteSave();
+
+	/** Writes the pending save once no further save was requested for a while. */
+	bool TickPendingSave(float DeltaSeconds);
+
 	/** Lifetime count of kills */
 	UPROPERTY()
 	int32 Kills;
@@ -180,6 +196,17 @@ private:
 	/** Internal.  True if data is changed but hasn't been saved. */
 	bool bIsDirty;
 
+	/** Internal.  True if a save was requested but the data hasn't been serialized yet. */
+	bool bSavePending;
+
+	/** Time of the last save request, used to merge saves */
+	double LastSaveRequestTime;
+
+	/** Background write in progress, the result tells if it succeeded */
+	TFuture<bool> PendingWrite;
+
+	FDelegateHandle SaveTickerHandle;
+
 	/** The string identifier used to save/load this persistent user. */
 	FString SlotName;
 	int32 UserIndex;
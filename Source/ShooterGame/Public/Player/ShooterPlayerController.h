@@ -55,9 +55,17 @@ public:
 	UFUNCTION(exec)
 	virtual void Say(const FString& Msg);
 
+	/** Local function say a string to own team only */
+	UFUNCTION(exec)
+	virtual void TeamSay(const FString& Msg);
+
 	/** RPC for clients to talk to server */
 	UFUNCTION(unreliable, server, WithValidation)
-	void ServerSay(const FString& Msg);	
+	void ServerSay(const FString& Msg, bool bTeamOnly);	
+
+	/** chat said by other players since last frame, NumRejected is how many of our own messages were dropped by the rate limit */
+	UFUNCTION(reliable, client)
+	void ClientReceiveChat(const TArray<FShooterChatMessage>& Messages, int32 NumRejected);
 
 	/** Local function run an emote */
 // 	UFUNCTION(exec)
@@ -235,8 +243,16 @@ protected:
 
 	virtual void BeginDestroy() override;
 
+	/** slot in FShooterLocallyControlledActors, INDEX_NONE if not a local player */
+	int32 LocallyControlledSlot;
+
+	/** updates our slot after possession changed */
+	void PublishLocallyControlledActors();
+
 	//Begin AActor interface
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** after all game elements are created */
 	virtual void PostInitializeComponents() override;
 
@@ -260,6 +276,8 @@ public:
 	//End AActor interface
 
 	//Begin AController interface
+
+	virtual void SetPawn(APawn* InPawn) override;
 	
 	/** transition to dead state, retries spawning later */
 	virtual void FailedToSpawnPawn() override;
@@ -296,17 +314,8 @@ public:
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerSuicide();
 
-	/** Updates achievements based on the PersistentUser stats at the end of a round */
-	void UpdateAchievementsOnGameEnd();
-
-	/** Updates leaderboard stats at the end of a round */
-	void UpdateLeaderboardsOnGameEnd();
-
-	/** Updates stats at the end of a round */
-	void UpdateStatsOnGameEnd(bool bIsWinner);
-
-	/** Updates the save file at the end of a round */
-	void UpdateSaveFileOnGameEnd(bool bIsWinner);
+	/** Records the round in the save file and hands a snapshot of it to the match results pipeline, which posts achievements, leaderboards and stats */
+	void SubmitMatchResults(bool bIsWinner);
 
 	// End APlayerController interface
 
@@ -18,6 +18,12 @@ class FShooterMainMenu;
 class FShooterWelcomeMenu;
 class FShooterMessageMenu;
 class AShooterGameSession;
+class FShooterMatchResultsPipeline;
+class FShooterReplayIndex;
+class FShooterServerReplayRecorder;
+class FShooterServerTelemetry;
+class FShooterCharacterUpdater;
+struct FStreamableHandle;
 
 namespace ShooterGameInstanceState
 {
@@ -95,9 +101,25 @@ public:
 
 	AShooterGameSession* GetGameSession() const;
 
+	/** posts match results of local players, null on dedicated servers */
+	FShooterMatchResultsPipeline* GetMatchResults() const { return MatchResults.Get(); }
+
+	/** index of local replays */
+	FShooterReplayIndex* GetReplayIndex() const { return ReplayIndex.Get(); }
+
+	/** records matches, only on dedicated servers */
+	FShooterServerReplayRecorder* GetServerReplayRecorder() const { return ServerReplayRecorder.Get(); }
+
+	/** frame time telemetry, only on dedicated servers */
+	FShooterServerTelemetry* GetServerTelemetry() const { return ServerTelemetry.Get(); }
+
+	/** per frame work of the characters that need it */
+	FShooterCharacterUpdater* GetCharacterUpdater() const { return CharacterUpdater.Get(); }
+
 	virtual void Init() override;
 	virtual void Shutdown() override;
 	virtual void StartGameInstance() override;
+	virtual void StartRecordingReplay(const FString& InName, const FString& FriendlyName, const TArray<FString>& AdditionalOptions = TArray<FString>(), TSharedPtr<IAnalyticsProvider> AnalyticsProvider = nullptr) override;
 #if WITH_EDITOR
 	virtual FGameInstancePIEResult StartPlayInEditorGameInstance(ULocalPlayer* LocalPlayer, const FGameInstancePIEParameters& Params) override;
 #endif	// WITH_EDITOR
@@ -227,6 +249,10 @@ private:
 	UPROPERTY(config)
 	FString PlayFabCustomId;
 
+	/** gameplay assets dedicated servers start loading in the background before the first map */
+	UPROPERTY(config)
+	TArray<FSoftObjectPath> ServerPreloadAssets;
+
 
 	/** Client API for PlayFab player authentication */
 	PlayFabClientPtr ClientAPI;
@@ -263,6 +289,24 @@ private:
 	/** Dialog widget to show non-interactive waiting messages for network timeouts and such. */
 	TSharedPtr<SShooterWaitDialog> WaitMessageWidget;
 
+	/** Match results still being posted, kept here so they survive map travel */
+	TSharedPtr<FShooterMatchResultsPipeline> MatchResults;
+
+	/** Index of local replays, read in the background on startup */
+	TSharedPtr<FShooterReplayIndex> ReplayIndex;
+
+	/** Records matches on dedicated servers */
+	TSharedPtr<FShooterServerReplayRecorder> ServerReplayRecorder;
+
+	/** Frame time telemetry of dedicated servers */
+	TSharedPtr<FShooterServerTelemetry> ServerTelemetry;
+
+	/** Updates characters with per frame work, instead of every character ticking */
+	TSharedPtr<FShooterCharacterUpdater> CharacterUpdater;
+
+	/** Keeps the preloaded gameplay assets of dedicated servers loaded */
+	TSharedPtr<FStreamableHandle> ServerPreloadHandle;
+
 	/** Controller to ignore for pairing changes. -1 to skip ignore. */
 	int32 IgnorePairingChangeForControllerId;
 
@@ -297,6 +341,10 @@ private:
 	
 	void OnPreLoadMap(const FString& MapName);
 	void OnPostLoadMap(UWorld*);
+
+	/** starts loading ServerPreloadAssets, all of them at once, so it overlaps the loading of the first map */
+	void PreloadServerAssets();
+	void OnServerAssetsPreloaded(double StartTime);
 	void OnPostDemoPlay();
 
 	virtual void HandleDemoPlaybackFailure( EDemoPlayFailure::Type FailureType, const FString& ErrorString ) override;
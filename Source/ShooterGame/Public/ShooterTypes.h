@@ -159,4 +159,23 @@ public:
 	FDamageEvent& GetDamageEvent();
 	void SetDamageEvent(const FDamageEvent& DamageEvent);
 	void EnsureReplication();
-};
\ No newline at end of file
+};
+
+/** chat message sent to clients in batches by FShooterChatRouter */
+USTRUCT()
+struct FShooterChatMessage
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FString Text;
+
+	/** only sent to the sender's team */
+	UPROPERTY()
+	bool bTeamOnly;
+
+	FShooterChatMessage()
+		: bTeamOnly(false)
+	{
+	}
+};
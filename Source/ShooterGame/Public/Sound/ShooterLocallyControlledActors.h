@@ -0,0 +1,41 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Templates/Atomic.h"
+
+/**
+ * Ids of the actors controlled by local players, read by USoundNodeLocalPlayer on the audio thread.
+ * Every local player controller owns a slot holding its own id and the id of its pawn. The game thread
+ * only writes a slot when possession changes, the audio thread scans the few slots without locking or hashing.
+ * Not used on dedicated servers, which have no local players.
+ */
+class SHOOTERGAME_API FShooterLocallyControlledActors
+{
+public:
+	/** max local player controllers alive at once, including the ones of a previous map during seamless travel */
+	static const int32 MaxSlots = 8;
+
+	/** game thread: reserves a slot for a local player controller, INDEX_NONE if none is available */
+	static int32 AcquireSlot();
+
+	/** game thread: frees a slot and forgets its actors */
+	static void ReleaseSlot(int32 Slot);
+
+	/** game thread: sets the actors of a slot, only touching the shared data if they changed */
+	static void Publish(int32 Slot, uint32 ControllerID, uint32 PawnID);
+
+	/** game thread: forgets an object that is being destroyed, so a new object reusing its id isn't mistaken for it */
+	static void Remove(uint32 UniqueID);
+
+	/** any thread: is given object a local player controller or its pawn? */
+	static bool IsLocallyControlled(uint32 UniqueID);
+
+private:
+
+	/** two ids per slot: controller and pawn, 0 when unused */
+	static TAtomic<uint32> ActorIDs[MaxSlots * 2];
+
+	/** game thread only */
+	static uint32 UsedSlotsMask;
+};
@@ -21,14 +21,4 @@ class USoundNodeLocalPlayer : public USoundNode
 	virtual FText GetInputPinName(int32 PinIndex) const override;
 #endif
 	// End USoundNode interface.
-
-	static TMap<uint32, bool>& GetLocallyControlledActorCache()
-	{
-		check(IsInAudioThread());
-		return LocallyControlledActorCache;
-	}
-
-private:
-
-	static TMap<uint32, bool> LocallyControlledActorCache;
 };
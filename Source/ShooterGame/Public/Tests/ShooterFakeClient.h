@@ -0,0 +1,125 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "IpNetDriver.h"
+#include "IpConnection.h"
+#include "ShooterFakeClient.generated.h"
+
+class AShooterCharacter;
+class UShooterCharacterMovement;
+
+/** scripted input of a fake player, moves, turns, runs, jumps and fires in random bursts */
+struct FShooterFakePlayerInput
+{
+	/** starts a new player, playing the same way for the same seed */
+	void Init(int32 Seed);
+
+	/** starts the next life with a fresh action */
+	void Reset();
+
+	/** applies the current action to the character this frame, through the regular input handlers */
+	void Drive(AShooterCharacter* Character, float TimeDelta);
+
+	/** corrections received by the player's characters since the last call, over respawns */
+	int32 TakeNewCorrections(AShooterCharacter* Character);
+
+private:
+
+	/** picks the next scripted action */
+	void ChooseAction();
+
+	FRandomStream Random;
+
+	float ActionTimeLeft;
+	float ForwardInput;
+	float RightInput;
+	float TurnInput;
+	bool bWantsRun;
+	bool bWantsFire;
+	bool bFiring;
+
+	/** every respawn brings a new movement component, counting from zero again */
+	TWeakObjectPtr<UShooterCharacterMovement> LastMovement;
+	int32 LastMovementCorrections;
+};
+
+/** connection of a fake client, takes the player controller the server sends without a local player behind it */
+UCLASS(transient, config=Engine)
+class UShooterFakeClientConnection : public UIpConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void HandleClientPlayer(APlayerController* PC, UNetConnection* NetConnection) override;
+};
+
+/** client net driver of a fake client, replicates the actors and RPCs of the fake client's world only */
+UCLASS(transient, config=Engine)
+class UShooterFakeClientNetDriver : public UIpNetDriver
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool InitConnectionClass() override;
+	virtual bool ShouldReplicateFunction(AActor* Actor, UFunction* Function) const override;
+	virtual bool ShouldReplicateActor(AActor* Actor) const override;
+};
+
+/**
+ * A player connected to a server at the connection level, many of them can share one process.
+ * Each fake client has its own empty world and net driver: it joins like a regular client but never loads the map,
+ * takes the player controller without a local player, and drives its character with FShooterFakePlayerInput. Moves
+ * reach the server through the character movement's ServerMove RPCs and firing through the weapons' RPCs, as for a real
+ * player. Without the map's geometry the characters fall where the server's walk, so the server corrects them at its
+ * correction rate: measure corrections with one-process clients, use fake clients for the count of players.
+ * The process must not have loaded the server's map itself, static actors of the map would resolve to its own world.
+ */
+UCLASS()
+class UShooterFakeClient : public UObject, public FNetworkNotify
+{
+	GENERATED_BODY()
+
+public:
+	/** creates the world and starts connecting to ServerAddress (host:port), false if the connection couldn't start */
+	bool Connect(UGameInstance* GameInstance, const FString& ServerAddress, const FString& InPlayerName, int32 Seed);
+
+	/** drives the character, the world and its net driver are ticked by the engine */
+	void Tick(float TimeDelta);
+
+	/** closes the connection and destroys the world */
+	void Disconnect();
+
+	/** joined the server, and has its player controller */
+	bool IsInGame() const;
+
+	/** refused by the server, or lost the connection */
+	bool HasFailed() const;
+
+	UNetConnection* GetConnection() const;
+	AShooterCharacter* GetCharacter() const;
+	FShooterFakePlayerInput& GetInput() { return Input; }
+
+	/** FNetworkNotify Functions */
+	virtual EAcceptConnection::Type NotifyAcceptingConnection() override;
+	virtual void NotifyAcceptedConnection(UNetConnection* Connection) override;
+	virtual bool NotifyAcceptingChannel(UChannel* Channel) override;
+	virtual void NotifyControlMessage(UNetConnection* Connection, uint8 MessageType, FInBunch& Bunch) override;
+
+protected:
+
+	/** first message of the handshake, once the packet handlers are ready */
+	void SendHello();
+
+	UPROPERTY()
+	UWorld* World;
+
+	UPROPERTY()
+	UNetDriver* NetDriver;
+
+	FName NetDriverName;
+	FString PlayerName;
+	FShooterFakePlayerInput Input;
+
+	bool bJoined;
+	bool bFailed;
+};
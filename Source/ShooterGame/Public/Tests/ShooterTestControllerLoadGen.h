@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "GauntletTestController.h"
+#include "Tests/ShooterFakeClient.h"
+#include "ShooterTestControllerLoadGen.generated.h"
+
+class AShooterCharacter;
+
+/**
+ * Fake players for loading a server with many clients from one machine.
+ * Run one headless client per fake player, connecting straight to the server, e.g.
+ *   ShooterClient 127.0.0.1:7777 -nullrhi -nosound -gauntlet=ShooterTestControllerLoadGen -LoadGenIndex=3 -LoadGenDuration=600
+ * or, for many players per process, -LoadGenFakeClients connections from a client that doesn't join itself, e.g.
+ *   ShooterClient -nullrhi -nosound -gauntlet=ShooterTestControllerLoadGen -LoadGenServer=127.0.0.1:7777 -LoadGenFakeClients=16 -LoadGenIndex=0
+ * Each client trims what a player without a screen doesn't need, then drives its character through the regular input
+ * handlers, so moves, running and firing reach the server through the same RPCs as a real player: it moves, turns,
+ * runs, jumps and fires in random bursts from a seed derived from -LoadGenSeed and the player's number, which is
+ * -LoadGenIndex times the players per process plus the player's place in the process. Fake clients (UShooterFakeClient)
+ * play the same way without loading the map, so the server corrects their moves all the time: count corrections with
+ * one player per process.
+ * Lag, the corrections received and the process's memory are logged every -LoadGenReportInterval seconds and at the
+ * end of the run, the server side sees lag and corrections in its telemetry. The final report checks that
+ * -LoadGenProcesses processes of the same peak memory fit in the machine's physical memory, and warns if they don't. It
+ * defaults to the processes needed for 64 players.
+ */
+UCLASS()
+class UShooterTestControllerLoadGen : public UGauntletTestController
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+
+protected:
+
+	virtual void OnTick(float TimeDelta) override;
+
+	/** connects the fake clients once the game instance is up, then drives them */
+	void TickFakeClients(float TimeDelta);
+
+	/** samples the lag and the corrections of a player in the game */
+	void SamplePlayer(const UNetConnection* Connection, AShooterCharacter* Character, FShooterFakePlayerInput& PlayerInput);
+
+	/** logs the stats every report interval */
+	void UpdateReport(float TimeDelta);
+
+	void Report(const TCHAR* Label);
+
+	/** warns if -LoadGenProcesses processes using as much memory as this one don't fit on the machine */
+	void CheckMemoryFit() const;
+
+	/** settings, from the command line */
+	int32 Seed;
+	int32 Index;
+	float DurationSeconds;
+	float ReportInterval;
+	float MaxFPS;
+
+	/** connection level fake clients run by this process, and the server they connect to */
+	int32 NumFakeClients;
+	FString ServerAddress;
+
+	/** processes run on this machine, for the memory check */
+	int32 NumProcesses;
+
+	/** scripted action of the process's own player */
+	FShooterFakePlayerInput Input;
+
+	UPROPERTY()
+	TArray<UShooterFakeClient*> FakeClients;
+
+	/** players of this process in the game, this frame */
+	int32 NumPlayersInGame;
+
+	/** time waiting for the server, and connected to it */
+	float TimeWaiting;
+	float TimeInGame;
+	float TimeSinceReport;
+
+	/** lag sampled once per frame, and corrections received */
+	double LagSumMS;
+	float MaxLagMS;
+	int32 NumLagSamples;
+	int32 NumCorrections;
+	int32 NumCorrectionsThisReport;
+
+	/** highest physical memory used by the process at a report */
+	uint64 PeakUsedPhysical;
+};
@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "GauntletTestController.h"
+#include "UObject/UObjectArray.h"
+#include "ShooterTestControllerMatchSimulation.generated.h"
+
+class AShooterGameMode;
+
+/**
+ * Plays a match with bots and fake clients on a headless server and checks its performance against a baseline.
+ * Run on a dedicated server (or -game -nullrhi) loading a match map, e.g.
+ *   Highrise?game=TDM -server -gauntlet=ShooterTestControllerMatchSimulation -SimBots=16 -SimClients=8 -SimSeed=1 -SimBaseline=Perf/Highrise.json
+ * The match is started right away with -SimBots bots from a fixed random seed. The budgets that look at the wall clock
+ * (bot behavior ticks, tactical point building, garbage collection deferral) are turned off.
+ * -SimClients players join from a load gen process on the same machine (ShooterTestControllerLoadGen with fake clients
+ * over the loopback address), started from -SimClientExe, by default this executable, which must be able to run as a
+ * client: pass the client's executable to a server build. With clients the match runs in real time at -SimTickRate,
+ * without them it's stepped at a fixed -SimTickRate as fast as it goes, so the same build plays the same match.
+ * Once the clients are in, frame times (without the time waiting for the next tick) are measured over -SimDuration
+ * seconds of match time, after -SimWarmup seconds, together with the UObjects created, the garbage collections and the
+ * bytes per second sent to the clients.
+ * Results are written to Saved/Simulation. With -SimBaseline, any metric worse than the baseline by more than
+ * -SimTolerance fails the test, -SimUpdateBaseline writes the results as the new baseline instead.
+ */
+UCLASS()
+class UShooterTestControllerMatchSimulation : public UGauntletTestController, public FUObjectArray::FUObjectCreateListener
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+	virtual void OnPostMapChange(UWorld* World) override;
+	virtual void BeginDestroy() override;
+
+	/** FUObjectCreateListener Functions */
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+
+protected:
+
+	struct FSimulationMetric
+	{
+		FString Name;
+		double Value;
+
+		/** differences smaller than this are noise, whatever the tolerance says */
+		double MinRegression;
+	};
+
+	virtual void OnTick(float TimeDelta) override;
+
+	/** adds the bots and starts the match */
+	void StartSimulation(AShooterGameMode* GameMode);
+
+	/** starts the load gen process of the fake clients, false if it couldn't be started */
+	bool StartClients(UWorld* World);
+
+	void StopClients();
+
+	/** players connected to the server with a player controller */
+	static int32 CountClientsInGame(UWorld* World);
+
+	/** records the frame that just ended */
+	void SampleFrame();
+
+	void FinishSimulation();
+
+	TArray<FSimulationMetric> BuildMetrics() const;
+
+	/** compares against the baseline file, returns false on regressions */
+	bool CompareToBaseline(const TArray<FSimulationMetric>& Metrics, const FString& BaselineFilename) const;
+
+	static bool SaveMetrics(const TArray<FSimulationMetric>& Metrics, const FString& Filename);
+
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	/** settings, from the command line */
+	int32 Seed;
+	int32 NumBots;
+	int32 NumClients;
+	FString ClientExecutable;
+	float TickRate;
+	float WarmupSeconds;
+	float DurationSeconds;
+	float Tolerance;
+	FString BaselineFilename;
+	bool bUpdateBaseline;
+
+	bool bStarted;
+	bool bClientsJoined;
+	bool bMeasuring;
+	bool bFinished;
+
+	/** match time when the simulation started */
+	float StartTime;
+
+	/** game thread time of each measured frame, in milliseconds */
+	TArray<float> FrameTimesMS;
+	double LastFrameTime;
+
+	/** load gen process running the fake clients, and the time waiting for them to join */
+	FProcHandle ClientProcess;
+	float ClientWaitSeconds;
+
+	/** the server's bytes per second sent, sampled every measured frame */
+	double OutBytesPerSecondSum;
+	int32 NumBandwidthSamples;
+
+	int64 NumObjectsCreated;
+	uint64 StartUsedPhysical;
+	uint64 EndUsedPhysical;
+
+	int32 NumCollections;
+	double CollectSeconds;
+	double MaxCollectSeconds;
+	double CollectStartTime;
+
+	bool bListeningForCreates;
+
+	FDelegateHandle PreGarbageCollectDelegateHandle;
+	FDelegateHandle PostGarbageCollectDelegateHandle;
+};
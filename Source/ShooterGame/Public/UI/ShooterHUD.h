@@ -21,6 +21,38 @@ struct FHitData
 	}
 };
 
+/** HUD text whose string and size are only rebuilt when the value it shows changes */
+struct FShooterHUDText
+{
+	/** text to draw */
+	FText Text;
+
+	/** unscaled size, as measured by UCanvas::StrLen */
+	FVector2D Size;
+
+	/** Initialise defaults. */
+	FShooterHUDText()
+		: Size(FVector2D::ZeroVector)
+		, Key(MIN_int64)
+		, MeasuredFont(nullptr)
+	{
+	}
+
+	/**
+	 * Rebuilds text and size if they were made for another key or font.
+	 *
+	 * @param	Canvas		Canvas used to measure the text.
+	 * @param	Font		Font the text is drawn with.
+	 * @param	NewKey		Value the text shows, the text is only rebuilt when it changes.
+	 * @param	MakeString	Builds the string for the new key.
+	 */
+	void Update(UCanvas* Canvas, UFont* Font, int64 NewKey, TFunctionRef<FString()> MakeString);
+
+private:
+	int64 Key;
+	UFont* MeasuredFont;
+};
+
 struct FDeathMessage
 {
 	/** Name of player scoring kill. */
@@ -47,6 +79,10 @@ struct FDeathMessage
 	/** What killed the player. */
 	TWeakObjectPtr<class UShooterDamageType> DamageType;
 
+	/** Killer and victim names, measured the first time the message is drawn. */
+	FShooterHUDText KillerText;
+	FShooterHUDText VictimText;
+
 	/** Initialise defaults. */
 	FDeathMessage()
 		: bKillerIsOwner(false)
@@ -141,6 +177,14 @@ public:
 	 */
 	void AddChatLine(const FText& ChatString, bool bWantFocus);
 
+	/*
+	 * Add strings received together to the chat window.
+	 *
+	 * @param	ChatStrings	The strings to add.
+	 * @param	bWantFocus	Should we set the chat window to focus
+	 */
+	void AddChatLines(TArrayView<const FText> ChatStrings, bool bWantFocus);
+
 	/* Is the match over (IE Is the state Won or Lost). */
 	bool IsMatchOver() const;
 		
@@ -154,6 +198,9 @@ protected:
 	/** Reflex Timers */
 	float LatencyTotal, LatencyGame, LatencyRender, Framerate;
 
+	/** Reflex Timers as displayed, formatted when the timers update */
+	FString LatencyTotalString, LatencyGameString, LatencyRenderString, FramerateString;
+
 	/** Lighter HUD color. */
 	FColor HUDLight;
 
@@ -313,6 +360,25 @@ protected:
 	/** Array of information strings to render (Waiting to respawn etc) */
 	TArray<FCanvasTextItem> InfoItems;
 
+	/** Cached texts, rebuilt only when what they show changes. */
+	FShooterHUDText PrimaryClipText;
+	FShooterHUDText PrimaryAmmoText;
+	FShooterHUDText SecondaryAmmoText;
+	FShooterHUDText WarmupText;
+	FShooterHUDText MatchTimerText;
+	FShooterHUDText PositionText;
+	FShooterHUDText KillsLabelText;
+	FShooterHUDText KillsText;
+	FShooterHUDText KilledLabelText;
+	FShooterHUDText CenteredKillText;
+	FShooterHUDText NetModeText;
+
+	/** Outcome of posting our match results, empty until the results pipeline reported back. */
+	FText MatchResultsStatus;
+
+	/** Handle of our binding to the match results pipeline. */
+	FDelegateHandle MatchResultsPostedHandle;
+
 	/** Called every time game is started. */
 	virtual void PostInitializeComponents() override;
 
@@ -354,6 +420,12 @@ protected:
 	FOnPlayerTalkingStateChangedDelegate OnPlayerTalkingStateChangedDelegate;
 	void OnPlayerTalkingStateChanged(TSharedRef<const FUniqueNetId> TalkingPlayerId, bool bIsTalking);
 
+	/** Called by the match results pipeline once results of a local player were posted. */
+	void OnMatchResultsPosted(int32 ControllerId, bool bWasSuccessful);
+
+	/** Draws whether our match results are still being posted, once the match is over. */
+	void DrawMatchResultsStatus();
+
 	/*
 	 * Draw the most recently killed player if needed
 	 *
@@ -361,8 +433,11 @@ protected:
 	 */
 	float DrawRecentlyKilledPlayer();
 
+	/** net mode, session and version description shown in non shipping builds */
+	FString GetNetModeDesc() const;
+
 	/** Temporary helper for drawing text-in-a-box. */
-	void DrawDebugInfoString(const FString& Text, float PosX, float PosY, bool bAlignLeft, bool bAlignTop, const FColor& TextColor);
+	void DrawDebugInfoString(const FShooterHUDText& Text, float PosX, float PosY, bool bAlignLeft, bool bAlignTop, const FColor& TextColor);
 
 	/** helper for getting uv coords in normalized top,left, bottom, right format */
 	void MakeUV(FCanvasIcon& Icon, FVector2D& UV0, FVector2D& UV1, uint16 U, uint16 V, uint16 UL, uint16 VL);
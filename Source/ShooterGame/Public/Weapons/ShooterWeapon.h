@@ -117,6 +117,9 @@ class AShooterWeapon : public AActor
 	/** consume a bullet */
 	void UseAmmo();
 
+	/** fills the weapon with the ammo it spawns with */
+	void SetInitialAmmo();
+
 	/** query ammo type */
 	virtual EAmmoType GetAmmoType() const
 	{
@@ -141,6 +144,9 @@ class AShooterWeapon : public AActor
 	/** [server] weapon was removed from pawn's inventory */
 	virtual void OnLeaveInventory();
 
+	/** [server] puts a weapon left by a dead pawn back in its spawned state, so the weapon pool can hand it to another pawn */
+	virtual void ResetForReuse();
+
 	/** check if it's currently equipped */
 	bool IsEquipped() const;
 
@@ -94,6 +94,9 @@ class AShooterWeapon_Instant : public AShooterWeapon
 	/** get current spread */
 	float GetCurrentSpread() const;
 
+	/** [server] also forgets the last hit and the spread built up by the previous owner */
+	virtual void ResetForReuse() override;
+
 protected:
 
 	virtual EAmmoType GetAmmoType() const override